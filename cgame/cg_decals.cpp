@@ -23,80 +23,179 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "cg_local.h"
 
-static TLinkedList<cgDecal_t*> decalList;
-
 /*
 =============================================================================
 
 	DECAL MANAGEMENT
 
+	Decals come out of a fixed pool and are kept on an intrusive list in the
+	order they were made, so the oldest one is always the head. Each is also
+	hashed by the grid cell its origin falls in, which lets a new decal find
+	the ones piled up right where it lands without walking the whole list.
+
 =============================================================================
 */
 
-static inline void CG_FreeDecal (cgDecal_t *d);
-static cgDecal_t *CG_ReplaceDecal (vec3_t origin)
-{
-	TList<cgDecal_t*> closestDecals;
+#define DECAL_HASH_SIZE		4096
+#define DECAL_CELL_SHIFT	4			// 16 unit cells
 
-	for (auto it = decalList.Head(); it != null; it = it->Next)
-	{
-		var node = it->Value;
+#define DECAL_PILE_RADIUS	10			// decals closer than this are on the same spot
+#define DECAL_PILE_MAX		5			// the oldest on a spot goes once there are this many
 
-		var dist = Vec3DistSquared(origin, node->origin);
+static cgDecal_t	cg_decalPool[MAX_REF_DECALS];
+static int			cg_numDecalsUsed;	// high water mark in cg_decalPool
+static cgDecal_t	*cg_freeDecals;
 
-		if (dist < 100)
-			closestDecals.Add(node);
+static cgDecal_t	*cg_decalHead;
+static cgDecal_t	*cg_decalTail;
+static int			cg_numDecals;
+static uint32		cg_decalSequence;
 
-		if (closestDecals.Count() == 5)
-			break;
-	}
+static cgDecal_t	*cg_decalHash[DECAL_HASH_SIZE];
 
-	if (closestDecals.Count() >= 5)
-		CG_FreeDecal (closestDecals[0]);
+/*
+===============
+CG_DecalHash
+===============
+*/
+static inline uint32 CG_DecalHash (const int x, const int y, const int z)
+{
+	return ((uint32)x * 73856093 ^ (uint32)y * 19349663 ^ (uint32)z * 83492791) & (DECAL_HASH_SIZE-1);
+}
 
-	return null;
+
+/*
+===============
+CG_FreeDecal
+===============
+*/
+static void CG_FreeDecal (cgDecal_t *d)
+{
+	// Unlink from the age list
+	if (d->prev)
+		d->prev->next = d->next;
+	else
+		cg_decalHead = d->next;
+	if (d->next)
+		d->next->prev = d->prev;
+	else
+		cg_decalTail = d->prev;
+	cg_numDecals--;
+
+	// Unlink from the hash
+	if (d->hashPrev)
+		d->hashPrev->hashNext = d->hashNext;
+	else
+		cg_decalHash[CG_DecalHash (d->hashCell[0], d->hashCell[1], d->hashCell[2])] = d->hashNext;
+	if (d->hashNext)
+		d->hashNext->hashPrev = d->hashPrev;
+
+	// Free in renderer
+	cgi.R_FreeDecal (&d->refDecal);
+
+	d->next = cg_freeDecals;
+	cg_freeDecals = d;
 }
 
+
 /*
 ===============
-CG_AllocDecal
+CG_ReplaceDecal
+
+Frees the oldest decal on this spot if too many are already stacked there.
 ===============
 */
-static cgDecal_t *CG_AllocDecal (vec3_t origin)
+static void CG_ReplaceDecal (vec3_t origin)
 {
-	cgDecal_t *decal = CG_ReplaceDecal(origin);
+	ivec3_t		mins, maxs;
+	cgDecal_t	*d, *oldest;
+	int			numClose;
+	int			x, y, z;
 
-	if (decal == null)
+	for (int i=0 ; i<3 ; i++)
 	{
-		// Can we allocate a new one?
-		if (decalList.Count() >= (uint32)cg_decalMax->intVal)
-			// remove head if not
-			cgi.R_FreeDecal(&decalList.PopFront()->refDecal);
+		mins[i] = (int)floor (origin[i] - DECAL_PILE_RADIUS) >> DECAL_CELL_SHIFT;
+		maxs[i] = (int)floor (origin[i] + DECAL_PILE_RADIUS) >> DECAL_CELL_SHIFT;
+	}
 
-		decal = new cgDecal_t;
+	oldest = NULL;
+	numClose = 0;
+	for (x=mins[0] ; x<=maxs[0] ; x++)
+	{
+		for (y=mins[1] ; y<=maxs[1] ; y++)
+		{
+			for (z=mins[2] ; z<=maxs[2] ; z++)
+			{
+				for (d=cg_decalHash[CG_DecalHash (x, y, z)] ; d ; d=d->hashNext)
+				{
+					// Skip other cells sharing the bucket, they get visited on their own
+					if (d->hashCell[0] != x || d->hashCell[1] != y || d->hashCell[2] != z)
+						continue;
+					if (Vec3DistSquared (origin, d->origin) >= DECAL_PILE_RADIUS*DECAL_PILE_RADIUS)
+						continue;
+
+					numClose++;
+					if (!oldest || d->sequence - oldest->sequence > 0x7FFFFFFF)
+						oldest = d;
+				}
+			}
+		}
 	}
-	
-	memset(decal, 0, sizeof(*decal));
-	
-	decal->node = decalList.AddToBack(decal);
 
-	return decal;
+	if (numClose >= DECAL_PILE_MAX)
+		CG_FreeDecal (oldest);
 }
 
 
 /*
 ===============
-CG_FreeDecal
+CG_AllocDecal
 ===============
 */
-static inline void CG_FreeDecal (cgDecal_t *d)
+static cgDecal_t *CG_AllocDecal (vec3_t origin)
 {
-	decalList.RemoveNode(d->node);
+	cgDecal_t	*d;
+	uint32		hash;
 
-	// Free in renderer
-	cgi.R_FreeDecal (&d->refDecal);
+	CG_ReplaceDecal (origin);
+
+	// Can we allocate a new one? Remove the oldest if not
+	while (cg_decalHead && cg_numDecals >= min(cg_decalMax->intVal, MAX_REF_DECALS))
+		CG_FreeDecal (cg_decalHead);
 
-	delete d;
+	if (cg_freeDecals)
+	{
+		d = cg_freeDecals;
+		cg_freeDecals = d->next;
+	}
+	else
+	{
+		d = &cg_decalPool[cg_numDecalsUsed++];
+	}
+
+	memset (d, 0, sizeof(*d));
+	Vec3Copy (origin, d->origin);
+	d->sequence = cg_decalSequence++;
+
+	// Link at the back of the age list
+	d->prev = cg_decalTail;
+	if (cg_decalTail)
+		cg_decalTail->next = d;
+	else
+		cg_decalHead = d;
+	cg_decalTail = d;
+	cg_numDecals++;
+
+	// Link into the hash
+	for (int i=0 ; i<3 ; i++)
+		d->hashCell[i] = (int)floor (origin[i]) >> DECAL_CELL_SHIFT;
+	hash = CG_DecalHash (d->hashCell[0], d->hashCell[1], d->hashCell[2]);
+	d->hashNext = cg_decalHash[hash];
+	if (d->hashNext)
+		d->hashNext->hashPrev = d;
+	cg_decalHash[hash] = d;
+
+	return d;
 }
 
 
@@ -144,7 +243,6 @@ cgDecal_t *CG_SpawnDecal(float org0,				float org1,					float org2,
 	}
 
 	// Store values
-	Vec3Copy (origin, d->origin);
 	d->time = (float)cg.refreshTime;
 	d->lifeTime = lifeTime;
 
@@ -168,115 +266,199 @@ CG_ClearDecals
 */
 void CG_ClearDecals ()
 {
-	for (var node = decalList.Head(); node != null; node = node->Next)
-		delete node->Value;
+	while (cg_decalHead)
+		CG_FreeDecal (cg_decalHead);
 
-	decalList.Clear();
+	cg_numDecalsUsed = 0;
+	cg_freeDecals = NULL;
 }
 
 
+/*
+=============================================================================
+
+	DECAL RENDERING
+
+	Fading is evaluated for chunks of decals on cg_jobs. The results are then
+	walked in list order on the main thread, which frees dead decals, runs the
+	think functions and hands the rest to the refresh.
+
+=============================================================================
+*/
+
+enum EDecalEvalState
+{
+	DES_DEAD,
+	DES_HIDDEN,
+	DES_VISIBLE
+};
+
+struct cgDecalEval_t
+{
+	cgDecal_t		*decal;
+	vec4_t			color;
+	EDecalEvalState	state;
+};
+
+#define DECAL_CHUNK_SIZE	256
+
+static cgDecalEval_t	cg_decalEval[MAX_REF_DECALS];
+
 /*
 ===============
-CG_AddDecals
+CG_EvalDecal
 ===============
 */
-void CG_AddDecals ()
+static void CG_EvalDecal (cgDecalEval_t *eval)
 {
+	cgDecal_t	*decal = eval->decal;
+	float		*color = eval->color;
 	float		lifeTime, finalTime;
 	float		fade;
-	int			i, type;
-	uint32		flags;
-	vec4_t		color;
 	vec3_t		temp;
-	colorb		outColor;
-	int			num;
 
-	if (!cg_decals->intVal)
-		return;
-
-	// Add to list
-	num = 0;
-	TLinkedList<cgDecal_t*>::Node *next = null;
-	for (var d = decalList.Head(); d != null; d = next)
-	{
-		next = d->Next;
-		num++;
+	if (decal->colorVel[3] > DECAL_INSTANT) {
+		// Determine how long this decal shall live for
+		if (decal->flags & DF_FIXED_LIFE)
+			lifeTime = decal->lifeTime;
+		else if (decal->flags & DF_USE_BURNLIFE)
+			lifeTime = decal->lifeTime + cg_decalBurnLife->floatVal;
+		else
+			lifeTime = decal->lifeTime + cg_decalLife->floatVal;
+
+		// Start fading
+		finalTime = decal->time + (lifeTime * 1000);
+		if ((float)cg.refreshTime > finalTime)  {
+			// Finished the life, fade for cg_decalFadeTime
+			if (cg_decalFadeTime->floatVal) {
+				lifeTime = cg_decalFadeTime->floatVal;
+
+				// final alpha * ((fade time - time since death) / fade time)
+				color[3] = decal->colorVel[3] * ((lifeTime - (((float)cg.refreshTime - finalTime) * 0.001f)) / lifeTime);
+			}
+			else
+				color[3] = 0.0f;
+		}
+		else {
+			// Not done living, fade between start/final alpha
+			fade = (lifeTime - (((float)cg.refreshTime - decal->time) * 0.001f)) / lifeTime;
+			color[3] = (fade * decal->color[3]) + ((1.0f - fade) * decal->colorVel[3]);
+		}
+	}
+	else {
+		color[3] = decal->color[3];
+	}
 
-		var decal = d->Value;
+	// Faded out
+	if (color[3] <= 0.0001f) {
+		eval->state = DES_DEAD;
+		return;
+	}
 
-		if (decal->colorVel[3] > DECAL_INSTANT) {
-			// Determine how long this decal shall live for
-			if (decal->flags & DF_FIXED_LIFE)
-				lifeTime = decal->lifeTime;
-			else if (decal->flags & DF_USE_BURNLIFE)
-				lifeTime = decal->lifeTime + cg_decalBurnLife->floatVal;
-			else
-				lifeTime = decal->lifeTime + cg_decalLife->floatVal;
+	if (color[3] > 1.0f)
+		color[3] = 1.0f;
 
-			// Start fading
-			finalTime = decal->time + (lifeTime * 1000);
-			if ((float)cg.refreshTime > finalTime)  {
-				// Finished the life, fade for cg_decalFadeTime
-				if (cg_decalFadeTime->floatVal) {
-					lifeTime = cg_decalFadeTime->floatVal;
+	// Small decal lod
+	if (cg_decalLOD->intVal && decal->size < 12) {
+		Vec3Subtract (cg.refDef.viewOrigin, decal->refDecal.poly.origin, temp);
+		if (DotProduct(temp, temp)/15000 > 100*decal->size) {
+			eval->state = DES_HIDDEN;
+			return;
+		}
+	}
 
-					// final alpha * ((fade time - time since death) / fade time)
-					color[3] = decal->colorVel[3] * ((lifeTime - (((float)cg.refreshTime - finalTime) * 0.001f)) / lifeTime);
-				}
+	// ColorVel calcs
+	if (decal->color[3] > DECAL_INSTANT) {
+		for (int i=0 ; i<3 ; i++) {
+			if (decal->color[i] != decal->colorVel[i]) {
+				if (decal->color[i] > decal->colorVel[i])
+					color[i] = decal->color[i] - ((decal->color[i] - decal->colorVel[i]) * (decal->color[3] - color[3]));
 				else
-					color[3] = 0.0f;
+					color[i] = decal->color[i] + ((decal->colorVel[i] - decal->color[i]) * (decal->color[3] - color[3]));
 			}
 			else {
-				// Not done living, fade between start/final alpha
-				fade = (lifeTime - (((float)cg.refreshTime - decal->time) * 0.001f)) / lifeTime;
-				color[3] = (fade * decal->color[3]) + ((1.0f - fade) * decal->colorVel[3]);
+				color[i] = decal->color[i];
 			}
+
+			color[i] = clamp (color[i], 0, 255);
 		}
-		else {
-			color[3] = decal->color[3];
-		}
+	}
+	else {
+		Vec3Copy (decal->color, color);
+	}
 
-		// Faded out
-		if (color[3] <= 0.0001f || num > cg_decalMax->intVal) {
-			CG_FreeDecal (decal);
+	// Adjust ramp to desired initial and final alpha settings
+	color[3] = (color[3] * decal->color[3]) + ((1 - color[3]) * decal->colorVel[3]);
+
+	if (decal->flags & DF_ALPHACOLOR)
+		Vec3Scale (color, color[3], color);
+
+	eval->state = DES_VISIBLE;
+}
+
+
+/*
+===============
+CG_DecalJob
+===============
+*/
+static void CG_DecalJob (void *arg, const int taskNum, const int threadNum)
+{
+	const int numDecals = *(int*)arg;
+	const int first = taskNum * DECAL_CHUNK_SIZE;
+	const int last = min(first + DECAL_CHUNK_SIZE, numDecals);
+
+	for (int i=first ; i<last ; i++)
+		CG_EvalDecal (&cg_decalEval[i]);
+}
+
+
+/*
+===============
+CG_AddDecals
+===============
+*/
+void CG_AddDecals ()
+{
+	int			type;
+	uint32		flags;
+	colorb		outColor;
+
+	if (!cg_decals->intVal)
+		return;
+
+	// Gather the list, dropping anything over the limit
+	const int maxDecals = min(cg_decalMax->intVal, MAX_REF_DECALS);
+	int numDecals = 0;
+	cgDecal_t *next;
+	for (cgDecal_t *d=cg_decalHead ; d ; d=next)
+	{
+		next = d->next;
+
+		if (numDecals >= maxDecals) {
+			CG_FreeDecal (d);
 			continue;
 		}
 
-		if (color[3] > 1.0f)
-			color[3] = 1.0f;
+		cg_decalEval[numDecals++].decal = d;
+	}
 
-		// Small decal lod
-		if (cg_decalLOD->intVal && decal->size < 12) {
-			Vec3Subtract (cg.refDef.viewOrigin, decal->refDecal.poly.origin, temp);
-			if (DotProduct(temp, temp)/15000 > 100*decal->size)
-				goto nextDecal;
-		}
+	cg_jobs.Run (CG_DecalJob, &numDecals, (numDecals + DECAL_CHUNK_SIZE-1) / DECAL_CHUNK_SIZE);
 
-		// ColorVel calcs
-		if (decal->color[3] > DECAL_INSTANT) {
-			for (i=0 ; i<3 ; i++) {
-				if (decal->color[i] != decal->colorVel[i]) {
-					if (decal->color[i] > decal->colorVel[i])
-						color[i] = decal->color[i] - ((decal->color[i] - decal->colorVel[i]) * (decal->color[3] - color[3]));
-					else
-						color[i] = decal->color[i] + ((decal->colorVel[i] - decal->color[i]) * (decal->color[3] - color[3]));
-				}
-				else {
-					color[i] = decal->color[i];
-				}
+	// Add to list
+	for (int i=0 ; i<numDecals ; i++)
+	{
+		cgDecalEval_t *eval = &cg_decalEval[i];
+		cgDecal_t *decal = eval->decal;
+		float *color = eval->color;
 
-				color[i] = clamp (color[i], 0, 255);
-			}
-		}
-		else {
-			Vec3Copy (decal->color, color);
+		if (eval->state == DES_DEAD) {
+			CG_FreeDecal (decal);
+			continue;
 		}
 
-		// Adjust ramp to desired initial and final alpha settings
-		color[3] = (color[3] * decal->color[3]) + ((1 - color[3]) * decal->colorVel[3]);
-
-		if (decal->flags & DF_ALPHACOLOR)
-			Vec3Scale (color, color[3], color);
+		if (eval->state == DES_HIDDEN)
+			goto nextDecal;
 
 		// Think func
 		flags = decal->flags;
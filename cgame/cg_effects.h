@@ -268,7 +268,10 @@ void	CG_MapFXShutdown ();
 
 struct cgDecal_t
 {
-	TLinkedList<cgDecal_t*>::Node	*node;
+	cgDecal_t				*prev, *next;			// age order, oldest first; next doubles as the free list link
+	cgDecal_t				*hashPrev, *hashNext;	// spatial hash chain
+	ivec3_t					hashCell;
+	uint32					sequence;
 
 	refDecal_t				refDecal;
 
@@ -350,8 +353,6 @@ enum EParticleStyle
 
 struct cgParticle_t
 {
-	TLinkedList<cgParticle_t*>::Node *node;
-
 	EParticleType			type;
 	float					time;
 
@@ -394,12 +395,6 @@ struct cgParticle_t
 	// For the lighting think functions
 	vec3_t					lighting;
 	float					nextLightingTime;
-
-	// Passed to refresh
-	refPoly_t				outPoly;
-	colorb					outColor[4];
-	vec2_t					outCoords[4];
-	vec3_t					outVertices[4];
 };
 
 void	CG_SpawnParticle (float org0,					float org1,					float org2,
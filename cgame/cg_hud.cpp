@@ -32,6 +32,8 @@ struct hudFile
 };
 hudFile *curHud = null;
 extern cVar_t *cg_hud;
+extern cVar_t *cg_hudRetain;
+extern cVar_t *cg_hudGCStep;
 
 struct hudNums
 {
@@ -42,6 +44,227 @@ struct hudNums
 
 TList<hudNums> hudNumMats;
 
+/*
+=============================================================================
+
+	RETAINED DRAWING
+
+	While ExecuteLayout runs, everything it draws is also recorded, along
+	with every stat and cvar it reads. Following frames replay the recording
+	until one of those inputs, the screen or the config strings change, so
+	the script itself only runs when there's something new to show. Scripts
+	that ask for the time or the server frame are re-run every frame.
+
+=============================================================================
+*/
+
+struct hudDrawCmd
+{
+	refMaterial_t		*mat;			// NULL for strings
+	QuadVertices		quad;
+
+	float				x, y;
+	float				xScale, yScale;
+	uint32				flags;
+	String				text;
+
+	colorb				color;
+};
+
+struct hudWatchedCvar
+{
+	cVar_t				*cvar;
+	String				value;
+};
+
+struct hudRetained
+{
+	bool				bValid;
+	bool				bRecording;
+	bool				bVolatile;
+
+	hudFile				*hud;
+	int					vidWidth;
+	int					vidHeight;
+	float				hudScale[2];
+	float				hudAlpha;
+
+	uint32				watchedStats;
+	sint16				stats[MAX_STATS];
+	TList<hudWatchedCvar> cvars;
+
+	TList<hudDrawCmd>	cmds;
+};
+
+static hudRetained hudRetain;
+
+/*
+================
+HUD_InvalidateRetained
+================
+*/
+void HUD_InvalidateRetained ()
+{
+	hudRetain.bValid = false;
+}
+
+
+/*
+================
+HUD_WatchStat
+================
+*/
+static int HUD_WatchStat (const int index)
+{
+	if (index < 0 || index >= MAX_STATS)
+		return 0;
+
+	hudRetain.watchedStats |= BIT(index);
+	return cg.frame.playerState.stats[index];
+}
+
+
+/*
+================
+HUD_WatchCvar
+================
+*/
+static void HUD_WatchCvar (cVar_t *cvar)
+{
+	if (!hudRetain.bRecording)
+		return;
+
+	for (uint32 i = 0; i < hudRetain.cvars.Count(); ++i)
+	{
+		if (hudRetain.cvars[i].cvar == cvar)
+			return;
+	}
+
+	hudWatchedCvar watch;
+	watch.cvar = cvar;
+	watch.value = cvar->string;
+	hudRetain.cvars.Add(watch);
+}
+
+
+/*
+================
+HUD_RetainedPic
+================
+*/
+static void HUD_RetainedPic (refMaterial_t *mat, const QuadVertices &quad, const colorb &color)
+{
+	cgi.R_DrawPic (mat, 0, quad, color);
+
+	// R_DrawPic drops a NULL material, and a command without one replays as a string
+	if (hudRetain.bRecording && mat)
+	{
+		hudDrawCmd cmd;
+		cmd.mat = mat;
+		cmd.quad = quad;
+		cmd.color = color;
+		hudRetain.cmds.Add(cmd);
+	}
+}
+
+
+/*
+================
+HUD_RetainedString
+================
+*/
+static void HUD_RetainedString (float x, float y, float xScale, float yScale, uint32 flags, const char *string, const colorb &color)
+{
+	cgi.R_DrawString (NULL, x, y, xScale, yScale, flags, (char*)string, color);
+
+	if (hudRetain.bRecording)
+	{
+		hudDrawCmd cmd;
+		cmd.mat = null;
+		cmd.x = x;
+		cmd.y = y;
+		cmd.xScale = xScale;
+		cmd.yScale = yScale;
+		cmd.flags = flags;
+		cmd.text = string;
+		cmd.color = color;
+		hudRetain.cmds.Add(cmd);
+	}
+}
+
+
+/*
+================
+HUD_CanReplay
+================
+*/
+static bool HUD_CanReplay ()
+{
+	if (!cg_hudRetain->intVal || !hudRetain.bValid || hudRetain.bVolatile || hudRetain.hud != curHud)
+		return false;
+
+	if (hudRetain.vidWidth != cg.refConfig.vidWidth || hudRetain.vidHeight != cg.refConfig.vidHeight
+	|| hudRetain.hudScale[0] != cg.hudScale[0] || hudRetain.hudScale[1] != cg.hudScale[1]
+	|| hudRetain.hudAlpha != scr_hudalpha->floatVal)
+		return false;
+
+	for (int i = 0; i < MAX_STATS; ++i)
+	{
+		if ((hudRetain.watchedStats & BIT(i)) && hudRetain.stats[i] != cg.frame.playerState.stats[i])
+			return false;
+	}
+
+	for (uint32 i = 0; i < hudRetain.cvars.Count(); ++i)
+	{
+		if (strcmp(hudRetain.cvars[i].cvar->string, hudRetain.cvars[i].value.CString()))
+			return false;
+	}
+
+	return true;
+}
+
+
+/*
+================
+HUD_ExecuteRetained
+================
+*/
+static void HUD_ExecuteRetained ()
+{
+	if (HUD_CanReplay())
+	{
+		for (uint32 i = 0; i < hudRetain.cmds.Count(); ++i)
+		{
+			hudDrawCmd &cmd = hudRetain.cmds[i];
+
+			if (cmd.mat)
+				cgi.R_DrawPic (cmd.mat, 0, cmd.quad, cmd.color);
+			else
+				cgi.R_DrawString (NULL, cmd.x, cmd.y, cmd.xScale, cmd.yScale, cmd.flags, (char*)cmd.text.CString(), cmd.color);
+		}
+		return;
+	}
+
+	hudRetain.cmds.Clear();
+	hudRetain.cvars.Clear();
+	hudRetain.watchedStats = 0;
+	hudRetain.bVolatile = false;
+	hudRetain.bRecording = true;
+
+	curHud->script->GetGlobal("ExecuteLayout");
+	curHud->script->Call(0, 0);
+
+	hudRetain.bRecording = false;
+	hudRetain.bValid = true;
+	hudRetain.hud = curHud;
+	hudRetain.vidWidth = cg.refConfig.vidWidth;
+	hudRetain.vidHeight = cg.refConfig.vidHeight;
+	hudRetain.hudScale[0] = cg.hudScale[0];
+	hudRetain.hudScale[1] = cg.hudScale[1];
+	hudRetain.hudAlpha = scr_hudalpha->floatVal;
+	memcpy (hudRetain.stats, cg.frame.playerState.stats, sizeof(hudRetain.stats));
+}
+
 /*
 =============================================================================
 
@@ -172,8 +395,8 @@ static void HUD_DrawField (float x, float y, hudNums &hudNumber, int width, int
 
 		frame += (hudNumber.numFields * (index));
 
-		cgi.R_DrawPic (
-			hudNumber.material, 0,
+		HUD_RetainedPic (
+			hudNumber.material,
 			QuadVertices().SetVertices(x, y,
 			iconWidth * cg.hudScale[0],
 			h * cg.hudScale[1])
@@ -637,7 +860,7 @@ int Lua_DrawPic (lua_State *state)
 	var script = cgi.Lua_ScriptFromState(state);
 	colorb hudColor(255, 255, 255, FloatToByte(scr_hudalpha->floatVal));
 
-	var value = cg.frame.playerState.stats[script->ToInteger(3)];
+	var value = HUD_WatchStat(script->ToInteger(3));
 	if (value >= MAX_CS_IMAGES)
 		Com_Error (ERR_DROP, "Pic >= MAX_CS_IMAGES");
 
@@ -651,7 +874,7 @@ int Lua_DrawPic (lua_State *state)
 
 	int w, h;
 	cgi.R_GetImageSize (mat, &w, &h);
-	cgi.R_DrawPic (mat, 0, QuadVertices().SetVertices(script->ToInteger(1), script->ToInteger(2), w * cg.hudScale[0], h * cg.hudScale[1]), hudColor);
+	HUD_RetainedPic (mat, QuadVertices().SetVertices(script->ToInteger(1), script->ToInteger(2), w * cg.hudScale[0], h * cg.hudScale[1]), hudColor);
 
 	return 0;
 }
@@ -668,7 +891,7 @@ int Lua_DrawMaterial (lua_State *state)
 
 	int w, h;
 	cgi.R_GetImageSize (mat, &w, &h);
-	cgi.R_DrawPic (mat, 0, QuadVertices().SetVertices(script->ToInteger(1), script->ToInteger(2), w * cg.hudScale[0], h * cg.hudScale[1]), hudColor);
+	HUD_RetainedPic (mat, QuadVertices().SetVertices(script->ToInteger(1), script->ToInteger(2), w * cg.hudScale[0], h * cg.hudScale[1]), hudColor);
 
 	return 0;
 }
@@ -677,7 +900,7 @@ int Lua_GetStat (lua_State *state)
 {
 	var script = cgi.Lua_ScriptFromState(state);
 
-	script->Push(cg.frame.playerState.stats[script->ToInteger(1)]);
+	script->Push(HUD_WatchStat(script->ToInteger(1)));
 
 	return 1;
 }
@@ -728,11 +951,11 @@ int Lua_StatString (lua_State *state)
 	if (stat < 0 || stat >= MAX_STATS)
 		Com_Error (ERR_DROP, "Bad stat_string stat index %i", stat);
 
-	stat = cg.frame.playerState.stats[stat];
+	stat = HUD_WatchStat(stat);
 	if (stat < 0 || stat >= MAX_CFGSTRINGS)
 		Com_Error (ERR_DROP, "Bad stat_string config string index %i", stat);
 
-	cgi.R_DrawString (NULL, x, y, cg.hudScale[0], cg.hudScale[1], FS_SQUARE, cg.configStrings[stat], colorb(script->ToNumber(4), script->ToNumber(5), script->ToNumber(6), script->ToNumber(7)));
+	HUD_RetainedString (x, y, cg.hudScale[0], cg.hudScale[1], FS_SQUARE, cg.configStrings[stat], colorb(script->ToNumber(4), script->ToNumber(5), script->ToNumber(6), script->ToNumber(7)));
 	return 0;
 }
 
@@ -740,7 +963,7 @@ int Lua_DrawString (lua_State *state)
 {
 	var script = cgi.Lua_ScriptFromState(state);
 
-	cgi.R_DrawString(null, script->ToNumber(1), script->ToNumber(2), script->ToNumber(3), script->ToNumber(4), script->ToInteger(5), (char*)script->ToString(6), colorb(script->ToNumber(7), script->ToNumber(8), script->ToNumber(9), script->ToNumber(10)));
+	HUD_RetainedString(script->ToNumber(1), script->ToNumber(2), script->ToNumber(3), script->ToNumber(4), script->ToInteger(5), script->ToString(6), colorb(script->ToNumber(7), script->ToNumber(8), script->ToNumber(9), script->ToNumber(10)));
 
 	return 0;
 }
@@ -778,6 +1001,7 @@ int Lua_CG_ServerFrame (lua_State *state)
 {
 	var script = cgi.Lua_ScriptFromState(state);
 
+	hudRetain.bVolatile = true;
 	script->Push(cg.frame.serverFrame);
 
 	return 1;
@@ -798,6 +1022,7 @@ int Lua_Cvar_Register (lua_State *state)
 	const int flags = script->ToInteger(3);
 
 	cVar_t *cv = cgi.Cvar_Register(name, val.CString(), flags);
+	HUD_WatchCvar(cv);
 
 	script->Push((void*)cv);
 
@@ -809,6 +1034,7 @@ int Lua_Cvar_GetNumberValue (lua_State *state)
 	var script = cgi.Lua_ScriptFromState(state);
 
 	cVar_t *cvar = (cVar_t*)script->ToUserData(1);
+	HUD_WatchCvar(cvar);
 	script->Push(cvar->floatVal);
 
 	return 1;
@@ -819,6 +1045,7 @@ int Lua_Cvar_GetStringValue (lua_State *state)
 	var script = cgi.Lua_ScriptFromState(state);
 
 	cVar_t *cvar = (cVar_t*)script->ToUserData(1);
+	HUD_WatchCvar(cvar);
 	script->Push(cvar->string);
 
 	return 1;
@@ -848,7 +1075,7 @@ int Lua_R_DrawPic (lua_State *state)
 {
 	var script = cgi.Lua_ScriptFromState(state);
 
-	cgi.R_DrawPic((refMaterial_t*)script->ToUserData(1), 0, QuadVertices().SetVertices(script->ToNumber(2), script->ToNumber(3), script->ToInteger(4), script->ToNumber(5)),
+	HUD_RetainedPic((refMaterial_t*)script->ToUserData(1), QuadVertices().SetVertices(script->ToNumber(2), script->ToNumber(3), script->ToInteger(4), script->ToNumber(5)),
 		colorb(script->ToNumber(6), script->ToNumber(7), script->ToNumber(8), script->ToNumber(9)));
 
 	return 0;
@@ -873,6 +1100,7 @@ int Lua_Cvar_Get (lua_State *state)
 	var script = cgi.Lua_ScriptFromState(state);
 	var cv = script->ToString(1);
 
+	hudRetain.bVolatile = true;
 	script->Push(cgi.Cvar_Exists(cv));
 
 	return 1;
@@ -882,6 +1110,7 @@ int Lua_R_GetFrameTime (lua_State *state)
 {
 	var script = cgi.Lua_ScriptFromState(state);
 
+	hudRetain.bVolatile = true;
 	script->Push(cg.refreshFrameTime);
 
 	return 1;
@@ -931,10 +1160,20 @@ int CG_GetAmmoIndex ();
 int Lua_CG_GetAmmoIndex (lua_State *state)
 {
 	var script = cgi.Lua_ScriptFromState(state);
+	hudRetain.bVolatile = true;
 	script->Push(CG_GetAmmoIndex());
 	return 1;	
 }
 
+// Shadows the engine's version so the HUD knows it's being animated
+int Lua_Hud_Milliseconds (lua_State *state)
+{
+	var script = cgi.Lua_ScriptFromState(state);
+	hudRetain.bVolatile = true;
+	script->Push(cgi.Sys_Milliseconds());
+	return 1;
+}
+
 ScriptFunctionTable cgFunctions[] =
 {
 	{ "Cvar_Get", Lua_Cvar_Get },
@@ -950,6 +1189,7 @@ ScriptFunctionTable cgFunctions[] =
 	{ "R_GetFrameTime", Lua_R_GetFrameTime },
 	{ "R_GetScreenSize", Lua_R_GetScreenSize },
 	{ "CG_GetAmmoIndex", Lua_CG_GetAmmoIndex },
+	{ "Sys_Milliseconds", Lua_Hud_Milliseconds },
 	{ null, null }
 };
 
@@ -1059,6 +1299,10 @@ void HUD_LoadHuds ()
 		file.script->GetGlobal("InitHud");
 		file.script->Call(0, 0);
 
+		// Collection is stepped once a frame in HUD_DrawStatusBar instead
+		file.script->GC(LUA_GCCOLLECT, 0);
+		file.script->GC(LUA_GCSTOP, 0);
+
 		huds.Add(file);
 		curHud = null;
 
@@ -1077,6 +1321,9 @@ void HUD_CloseHuds ()
 	if (reloadCmd || huds.Count())
 	{
 		hudNumMats.Clear();
+		HUD_InvalidateRetained();
+		hudRetain.hud = null;
+		curHud = null;
 
 		Com_Printf (0, "Releasing HUDs...\n");
 		cgi.Cmd_RemoveCommand(reloadCmd);
@@ -1139,8 +1386,16 @@ void HUD_DrawStatusBar ()
 
 	if (curHud != null)
 	{
-		curHud->script->GetGlobal("ExecuteLayout");
-		curHud->script->Call(0, 0);
+		HUD_ExecuteRetained();
+
+		// Spread collection over frames rather than stalling on a full cycle
+		if (cg_hudGCStep->intVal > 0)
+		{
+			curHud->script->GC(LUA_GCSTEP, cg_hudGCStep->intVal);
+			curHud->script->GC(LUA_GCSTOP, 0);
+		}
+		else
+			curHud->script->GC(LUA_GCRESTART, 0);
 	}
 }
 
@@ -256,6 +256,7 @@ struct cgState_t {
 };
 
 extern cgState_t	cg;
+extern JobPool		cg_jobs;
 
 /*
 =============================================================================
@@ -338,6 +339,7 @@ void	V_Unregister ();
 void	HUD_CopyLayout ();
 void	HUD_DrawLayout ();
 void	HUD_DrawStatusBar ();
+void	HUD_InvalidateRetained ();
 
 //
 // cg_inventory.c
@@ -396,6 +398,7 @@ extern cVar_t	*cg_thirdPersonAngle;
 extern cVar_t	*cg_thirdPersonClip;
 extern cVar_t	*cg_thirdPersonDist;
 extern cVar_t	*cg_simpleitems;
+extern cVar_t	*cg_threads;
 
 extern cVar_t	*cg_explorattle;
 extern cVar_t	*cg_explorattle_scale;
@@ -404,6 +407,7 @@ extern cVar_t	*cl_gun;
 extern cVar_t	*cl_noskins;
 extern cVar_t	*cl_predict;
 extern cVar_t	*cl_showmiss;
+extern cVar_t	*cl_showpredict;
 extern cVar_t	*cl_vwep;
 
 extern cVar_t	*crosshair;
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 cgState_t	cg;
 cgMedia_t	cgMedia;
 uiMedia_t	uiMedia;
+JobPool		cg_jobs;
 
 cVar_t	*cg_advInfrared;
 cVar_t	*cg_brassTime;
@@ -54,6 +55,7 @@ cVar_t	*cg_thirdPersonAngle;
 cVar_t	*cg_thirdPersonClip;
 cVar_t	*cg_thirdPersonDist;
 cVar_t	*cg_simpleitems;
+cVar_t	*cg_threads;
 
 cVar_t	*cg_explorattle;
 cVar_t	*cg_explorattle_scale;
@@ -62,6 +64,7 @@ cVar_t	*cl_gun;
 cVar_t	*cl_noskins;
 cVar_t	*cl_predict;
 cVar_t	*cl_showmiss;
+cVar_t	*cl_showpredict;
 cVar_t	*cl_vwep;
 
 cVar_t	*gender_auto;
@@ -129,6 +132,8 @@ cVar_t	*cg_bobPitch;
 cVar_t	*cg_bobYaw;
 cVar_t	*cg_bobRoll;
 cVar_t	*cg_hud;
+cVar_t	*cg_hudRetain;
+cVar_t	*cg_hudGCStep;
 
 // ====================================================================
 
@@ -216,6 +221,19 @@ void CG_UpdateCvars(const bool bForceUpdate)
 			cgi.Cvar_VariableSetValue(cg_particleMax, 0, true);
 	}
 
+	// cg_threads
+	if (cg_threads->modified || bForceUpdate)
+	{
+		cg_threads->modified = false;
+		if (cg_threads->intVal > MAX_JOB_THREADS-1)
+			cgi.Cvar_VariableSetValue(cg_threads, MAX_JOB_THREADS-1, true);
+		else if (cg_threads->intVal < 0)
+			cgi.Cvar_VariableSetValue(cg_threads, 0, true);
+
+		// Worker count, 0 runs every job on the main thread
+		cg_jobs.Init(cg_threads->intVal);
+	}
+
 	// cg_particleGore
 	if (cg_particleGore->modified || bForceUpdate)
 	{
@@ -370,6 +388,7 @@ static void CG_RegisterMain ()
 	cg_thirdPersonClip		= cgi.Cvar_Register ("cg_thirdPersonClip",		"1",			CVAR_ARCHIVE);
 	cg_thirdPersonDist		= cgi.Cvar_Register ("cg_thirdPersonDist",		"50",			CVAR_ARCHIVE);
 	cg_simpleitems			= cgi.Cvar_Register ("cg_simpleitems",			"0",			CVAR_ARCHIVE);
+	cg_threads				= cgi.Cvar_Register ("cg_threads",				"2",			CVAR_ARCHIVE);
 
 	cg_explorattle			= cgi.Cvar_Register ("cg_explorattle",			"1",			CVAR_ARCHIVE);
 	cg_explorattle_scale	= cgi.Cvar_Register ("cg_explorattle_scale",	"0.3",			CVAR_ARCHIVE);
@@ -378,6 +397,7 @@ static void CG_RegisterMain ()
 	cl_noskins				= cgi.Cvar_Register ("cl_noskins",				"0",			CVAR_CHEAT);
 	cl_predict				= cgi.Cvar_Register ("cl_predict",				"1",			0);
 	cl_showmiss				= cgi.Cvar_Register ("cl_showmiss",				"0",			0);
+	cl_showpredict			= cgi.Cvar_Register ("cl_showpredict",			"0",			0);
 	cl_vwep					= cgi.Cvar_Register ("cl_vwep",					"1",			CVAR_ARCHIVE);
 
 	gender_auto				= cgi.Cvar_Register ("gender_auto",				"1",			CVAR_ARCHIVE);
@@ -466,6 +486,8 @@ static void CG_RegisterMain ()
 	cgi.Cvar_Register ("skin",			"",				CVAR_USERINFO|CVAR_ARCHIVE);
 
 	cg_hud					= cgi.Cvar_Register ("cg_hud", "default", CVAR_ARCHIVE);
+	cg_hudRetain			= cgi.Cvar_Register ("cg_hudretain", "1", CVAR_ARCHIVE);
+	cg_hudGCStep			= cgi.Cvar_Register ("cg_hudgcstep", "4", CVAR_ARCHIVE);
 
 	// Register our commands
 	cmd_say			= cgi.Cmd_AddCommand ("say",			0, CG_Say_Preprocessor,	"");
@@ -649,6 +671,9 @@ void CG_Shutdown ()
 
 	HUD_CloseHuds();
 
+	// Stop the worker threads
+	cg_jobs.Shutdown ();
+
 	// The above function calls should release all of this anyways, but this is to be certain
 	CG_FreeTag (CGTAG_ANY);
 	CG_FreeTag (CGTAG_MAPFX);
@@ -52,6 +52,8 @@ void CG_ParseConfigString (int num, char *str)
 	oldCfgStr[sizeof(oldCfgStr)-1] = '\0';
 
 	strcpy (cg.configStrings[num], str);
+	if (strcmp (oldCfgStr, str))
+		HUD_InvalidateRetained ();
 
 	// Do something apropriate
 	if (num >= CS_LIGHTS && num < CS_LIGHTS+MAX_CS_LIGHTSTYLES) {
@@ -23,7 +23,82 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "cg_local.h"
 
-static TLinkedList<cgParticle_t*>	cg_particles;
+/*
+=============================================================================
+
+	PARTICLE POOLS
+
+	Particles without think functions are stored as a structure of arrays
+	and integrated SIMD_WIDTH at a time. Particles with think functions keep
+	a full cgParticle_t, since the think functions poke at it, and live in a
+	separate array. Both pools are fixed size and compact by swapping the
+	last entry into the freed slot.
+
+	The simple pool is updated in chunks on cg_jobs. Each chunk writes its
+	quads into its own slice of the poly buffer, and the slices are handed
+	to the refresh afterwards on the main thread.
+=============================================================================
+*/
+
+struct cgSimpleParticles_t
+{
+	// Integration inputs, SIMD friendly
+	float			time[MAX_PARTICLES];
+	float			timeScale[MAX_PARTICLES];	// 0.001, or 0 for PART_INSTANT
+	float			timeBias[MAX_PARTICLES];	// 0, or 1 for PART_INSTANT
+	float			lerpScale[MAX_PARTICLES];	// 1, or 0 for PART_INSTANT
+
+	float			org[3][MAX_PARTICLES];
+	float			vel[3][MAX_PARTICLES];
+	float			accel[3][MAX_PARTICLES];	// gravity is folded into accel[2]
+
+	float			color[4][MAX_PARTICLES];
+	float			colorVel[4][MAX_PARTICLES];
+
+	float			size[MAX_PARTICLES];
+	float			sizeVel[MAX_PARTICLES];
+
+	// Used only when building the quad
+	vec3_t			angle[MAX_PARTICLES];
+	float			orient[MAX_PARTICLES];
+	EParticleType	type[MAX_PARTICLES];
+	EParticleStyle	style[MAX_PARTICLES];
+	uint32			flags[MAX_PARTICLES];
+	refMaterial_t	*mat[MAX_PARTICLES];
+	bool			bInstant[MAX_PARTICLES];
+
+	int				numParticles;
+};
+
+struct cgSimpleParticleState_t
+{
+	float			org[3][MAX_PARTICLES];
+	float			color[4][MAX_PARTICLES];
+	float			size[MAX_PARTICLES];
+	bool			bDead[MAX_PARTICLES];
+};
+
+// Must be a multiple of SIMD_WIDTH
+#define PART_CHUNK_SIZE		512
+#define MAX_PART_CHUNKS		(MAX_PARTICLES/PART_CHUNK_SIZE)
+
+static cgSimpleParticles_t		cg_simpleParticles;
+static cgSimpleParticleState_t	cg_simpleState;
+
+static cgParticle_t				cg_thinkParticles[MAX_PARTICLES];
+static int						cg_numThinkParticles;
+
+// Quads handed to the refresh, valid until the next CG_AddParticles.
+// The simple pool uses the first MAX_PARTICLES slots, one per particle,
+// and the thinking pool the rest.
+#define PART_THINK_POLYS		MAX_PARTICLES
+#define MAX_PART_POLYS			(MAX_PARTICLES*2)
+
+static refPoly_t				cg_partPolys[MAX_PART_POLYS];
+static colorb					cg_partColors[MAX_PART_POLYS][4];
+static vec2_t					cg_partCoords[MAX_PART_POLYS][4];
+static vec3_t					cg_partVertices[MAX_PART_POLYS][4];
+static int						cg_partChunkPolys[MAX_PART_CHUNKS];
 
 /*
 =============================================================================
@@ -35,41 +110,184 @@ static TLinkedList<cgParticle_t*>	cg_particles;
 
 /*
 ===============
-CG_AllocParticle
+CG_CopySimpleParticle
 ===============
 */
-static cgParticle_t *CG_AllocParticle()
+static void CG_CopySimpleParticle(const int from, const int to)
 {
-	cgParticle_t *p;
+	cgSimpleParticles_t *sp = &cg_simpleParticles;
+
+	sp->time[to] = sp->time[from];
+	sp->timeScale[to] = sp->timeScale[from];
+	sp->timeBias[to] = sp->timeBias[from];
+	sp->lerpScale[to] = sp->lerpScale[from];
 
-	if (cg_particles.Count() >= (uint32)cg_particleMax->intVal)
-		delete cg_particles.PopBack();
+	for (int i=0 ; i<3 ; i++)
+	{
+		sp->org[i][to] = sp->org[i][from];
+		sp->vel[i][to] = sp->vel[i][from];
+		sp->accel[i][to] = sp->accel[i][from];
+	}
 
-	p = new cgParticle_t();
-	p->node = cg_particles.AddToFront(p);
+	for (int i=0 ; i<4 ; i++)
+	{
+		sp->color[i][to] = sp->color[i][from];
+		sp->colorVel[i][to] = sp->colorVel[i][from];
+	}
 
-	// Store static poly info
-	p->outPoly.numVerts = 4;
-	p->outPoly.colors = p->outColor;
-	p->outPoly.texCoords = p->outCoords;
-	p->outPoly.vertices = p->outVertices;
-	p->outPoly.matTime = 0;
+	sp->size[to] = sp->size[from];
+	sp->sizeVel[to] = sp->sizeVel[from];
 
-	return p;
+	Vec3Copy(sp->angle[from], sp->angle[to]);
+	sp->orient[to] = sp->orient[from];
+	sp->type[to] = sp->type[from];
+	sp->style[to] = sp->style[from];
+	sp->flags[to] = sp->flags[from];
+	sp->mat[to] = sp->mat[from];
+	sp->bInstant[to] = sp->bInstant[from];
 }
 
 
 /*
 ===============
-CG_FreeParticle
+CG_FreeSimpleParticle
+
+Swaps the last particle, and whether it died this frame, into the slot.
 ===============
 */
-static inline void CG_FreeParticle(cgParticle_t *p)
+static void CG_FreeSimpleParticle(const int index)
 {
-	cg_particles.RemoveNode(p->node);
-	delete p;
+	const int last = --cg_simpleParticles.numParticles;
+	if (index == last)
+		return;
+
+	CG_CopySimpleParticle(last, index);
+	cg_simpleState.bDead[index] = cg_simpleState.bDead[last];
+}
+
+
+/*
+===============
+CG_FreeThinkParticle
+===============
+*/
+static inline void CG_FreeThinkParticle(const int index)
+{
+	const int last = --cg_numThinkParticles;
+	if (index != last)
+		cg_thinkParticles[index] = cg_thinkParticles[last];
 }
 
+
+/*
+===============
+CG_EvictParticle
+
+Makes room when cg_particleMax is hit by dropping the oldest particle from
+either pool, as the list did. Both pools hold MAX_PARTICLES, so the new one
+fits wherever it's headed.
+===============
+*/
+static bool CG_EvictParticle()
+{
+	if (cg_simpleParticles.numParticles+cg_numThinkParticles < min(cg_particleMax->intVal, MAX_PARTICLES))
+		return true;
+
+	int oldest = -1;
+	bool bThinking = false;
+	float oldestTime = 0;
+	for (int i=0 ; i<cg_simpleParticles.numParticles ; i++)
+	{
+		if (oldest == -1 || cg_simpleParticles.time[i] < oldestTime)
+		{
+			oldest = i;
+			oldestTime = cg_simpleParticles.time[i];
+		}
+	}
+	for (int i=0 ; i<cg_numThinkParticles ; i++)
+	{
+		if (oldest == -1 || cg_thinkParticles[i].time < oldestTime)
+		{
+			oldest = i;
+			oldestTime = cg_thinkParticles[i].time;
+			bThinking = true;
+		}
+	}
+	if (oldest == -1)
+		return false;
+
+	if (bThinking)
+	{
+		CG_FreeThinkParticle(oldest);
+	}
+	else
+	{
+		const int last = --cg_simpleParticles.numParticles;
+		if (oldest != last)
+			CG_CopySimpleParticle(last, oldest);
+	}
+
+	return true;
+}
+
+
+/*
+===============
+CG_SpawnSimpleParticle
+===============
+*/
+static void CG_SpawnSimpleParticle(float org0, float org1, float org2,
+								float angle0, float angle1, float angle2,
+								float vel0, float vel1, float vel2,
+								float accel0, float accel1, float accel2,
+								float red, float green, float blue,
+								float redVel, float greenVel, float blueVel,
+								float alpha, float alphaVel,
+								float size, float sizeVel,
+								const EParticleType type, const uint32 flags,
+								const EParticleStyle style, const float orient)
+{
+	cgSimpleParticles_t *sp = &cg_simpleParticles;
+	const int i = sp->numParticles++;
+	const bool bInstant = (alphaVel <= PART_INSTANT);
+
+	sp->time[i] = (float)cg.refreshTime;
+	sp->timeScale[i] = bInstant ? 0.0f : 0.001f;
+	sp->timeBias[i] = bInstant ? 1.0f : 0.0f;
+	sp->lerpScale[i] = bInstant ? 0.0f : 1.0f;
+	sp->bInstant[i] = bInstant;
+
+	sp->org[0][i] = org0;
+	sp->org[1][i] = org1;
+	sp->org[2][i] = org2;
+	sp->vel[0][i] = vel0;
+	sp->vel[1][i] = vel1;
+	sp->vel[2][i] = vel2;
+	sp->accel[0][i] = accel0;
+	sp->accel[1][i] = accel1;
+	sp->accel[2][i] = (flags & PF_GRAVITY) ? accel2 - PART_GRAVITY : accel2;
+
+	sp->color[0][i] = red;
+	sp->color[1][i] = green;
+	sp->color[2][i] = blue;
+	sp->color[3][i] = alpha;
+	sp->colorVel[0][i] = redVel;
+	sp->colorVel[1][i] = greenVel;
+	sp->colorVel[2][i] = blueVel;
+	sp->colorVel[3][i] = bInstant ? 0.0f : alphaVel;
+
+	sp->size[i] = size;
+	sp->sizeVel[i] = sizeVel;
+
+	Vec3Set(sp->angle[i], angle0, angle1, angle2);
+	sp->orient[i] = orient;
+	sp->type[i] = type;
+	sp->style[i] = style;
+	sp->flags[i] = flags;
+	sp->mat[i] = cgMedia.particleTable[type];
+}
+
+
 /*
 ===============
 CG_SpawnParticle
@@ -92,7 +310,20 @@ void CG_SpawnParticle  (float org0,						float org1,					float org2,
 						const EParticleStyle style,
 						const float orient)
 {
-	cgParticle_t *p = CG_AllocParticle();
+	const bool bThinking = (preThink || think || postThink);
+	if (!CG_EvictParticle())
+		return;
+
+	if (!bThinking)
+	{
+		CG_SpawnSimpleParticle(org0, org1, org2, angle0, angle1, angle2, vel0, vel1, vel2, accel0, accel1, accel2,
+			red, green, blue, redVel, greenVel, blueVel, alpha, alphaVel, size, sizeVel, type, flags, style, orient);
+		return;
+	}
+
+	cgParticle_t *p = &cg_thinkParticles[cg_numThinkParticles++];
+	memset(p, 0, sizeof(*p));
+
 	p->time = (float)cg.refreshTime;
 	p->type = type;
 
@@ -151,37 +382,479 @@ CG_ClearParticles
 */
 void CG_ClearParticles()
 {
-	for (var node = cg_particles.Head(); node != null; node = node->Next)
-		delete node->Value;
+	cg_simpleParticles.numParticles = 0;
+	cg_numThinkParticles = 0;
+}
+
+/*
+=============================================================================
+
+	PARTICLE RENDERING
+
+=============================================================================
+*/
+
+/*
+===============
+CG_BuildParticlePoly
+
+Culls the particle and writes its quad into the given slot of the poly buffer.
+Only touches the slot and read-only view state, so chunks can run in parallel.
+Returns false if the particle was culled.
+===============
+*/
+static bool CG_BuildParticlePoly(const int polyNum, const EParticleType type, const EParticleStyle style, const uint32 flags, refMaterial_t *mat, vec3_t angle, const vec3_t outOrigin, vec4_t color, const float size, const float outOrient)
+{
+	// Culling
+	switch (style)
+	{
+	case PART_STYLE_ANGLED:
+	case PART_STYLE_BEAM:
+	case PART_STYLE_DIRECTION:
+		break;
+
+	default:
+		if (cg_particleCulling->intVal)
+		{
+			// Kill particles behind the view
+			vec3_t temp;
+			Vec3Subtract(outOrigin, cg.refDef.viewOrigin, temp);
+			VectorNormalizeFastf(temp);
+			if (DotProduct(temp, cg.refDef.viewAxis[0]) < 0)
+				return false;
+
+			// Lessen fillrate consumption
+			if (!(flags & PF_NOCLOSECULL))
+			{
+				float dist = Vec3DistSquared(cg.refDef.viewOrigin, outOrigin);
+				if (dist <= 5*5)
+					return false;
+			}
+		}
+		break;
+	}
+
+	// Alpha*color
+	if (flags & PF_ALPHACOLOR)
+		Vec3Scale(color, color[3], color);
+
+	// Add to be rendered
+	float scale;
+	if (flags & PF_SCALED)
+	{
+		scale = (outOrigin[0] - cg.refDef.viewOrigin[0]) * cg.refDef.viewAxis[0][0] +
+				(outOrigin[1] - cg.refDef.viewOrigin[1]) * cg.refDef.viewAxis[0][1] +
+				(outOrigin[2] - cg.refDef.viewOrigin[2]) * cg.refDef.viewAxis[0][2];
+
+		scale = (scale < 20) ? 1 : 1 + scale * 0.004f;
+		scale = (scale - 1) + size;
+	}
+	else
+	{
+		scale = size;
+	}
+
+	// Rendering
+	refPoly_t *poly = &cg_partPolys[polyNum];
+	colorb *outColors = cg_partColors[polyNum];
+	vec2_t *outCoords = cg_partCoords[polyNum];
+	vec3_t *outVerts = cg_partVertices[polyNum];
+
+	poly->numVerts = 4;
+	poly->colors = outColors;
+	poly->texCoords = outCoords;
+	poly->vertices = outVerts;
+	poly->matTime = 0;
 
-	cg_particles.Clear();
+	outColors[0] = colorb(color[0], color[1], color[2], color[3] * 255);
+	outColors[1] = outColors[0];
+	outColors[2] = outColors[0];
+	outColors[3] = outColors[0];
+
+	switch (style)
+	{
+	case PART_STYLE_ANGLED:
+		{
+			vec3_t a_upVec, a_rtVec;
+
+			Angles_Vectors(angle, NULL, a_rtVec, a_upVec); 
+
+			if (outOrient)
+			{
+				float c, s;
+
+				Q_SinCosf(DEG2RAD(outOrient), &c, &s);
+				c *= scale;
+				s *= scale;
+
+				// Top left
+				Vec2Set(outCoords[0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
+				Vec3Set(outVerts[0],	outOrigin[0] + a_upVec[0]*s - a_rtVec[0]*c,
+										outOrigin[1] + a_upVec[1]*s - a_rtVec[1]*c,
+										outOrigin[2] + a_upVec[2]*s - a_rtVec[2]*c);
+
+				// Bottom left
+				Vec2Set(outCoords[1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
+				Vec3Set(outVerts[1],	outOrigin[0] - a_upVec[0]*c - a_rtVec[0]*s,
+										outOrigin[1] - a_upVec[1]*c - a_rtVec[1]*s,
+										outOrigin[2] - a_upVec[2]*c - a_rtVec[2]*s);
+
+				// Bottom right
+				Vec2Set(outCoords[2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
+				Vec3Set(outVerts[2],	outOrigin[0] - a_upVec[0]*s + a_rtVec[0]*c,
+										outOrigin[1] - a_upVec[1]*s + a_rtVec[1]*c,
+										outOrigin[2] - a_upVec[2]*s + a_rtVec[2]*c);
+
+				// Top right
+				Vec2Set(outCoords[3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
+				Vec3Set(outVerts[3],	outOrigin[0] + a_upVec[0]*c + a_rtVec[0]*s,
+										outOrigin[1] + a_upVec[1]*c + a_rtVec[1]*s,
+										outOrigin[2] + a_upVec[2]*c + a_rtVec[2]*s);
+			}
+			else
+			{
+				// Top left
+				Vec2Set(outCoords[0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
+				Vec3Set(outVerts[0],	outOrigin[0] + a_upVec[0]*scale - a_rtVec[0]*scale,
+										outOrigin[1] + a_upVec[1]*scale - a_rtVec[1]*scale,
+										outOrigin[2] + a_upVec[2]*scale - a_rtVec[2]*scale);
+
+				// Bottom left
+				Vec2Set(outCoords[1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
+				Vec3Set(outVerts[1],	outOrigin[0] - a_upVec[0]*scale - a_rtVec[0]*scale,
+										outOrigin[1] - a_upVec[1]*scale - a_rtVec[1]*scale,
+										outOrigin[2] - a_upVec[2]*scale - a_rtVec[2]*scale);
+
+				// Bottom right
+				Vec2Set(outCoords[2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
+				Vec3Set(outVerts[2],	outOrigin[0] - a_upVec[0]*scale + a_rtVec[0]*scale,
+										outOrigin[1] - a_upVec[1]*scale + a_rtVec[1]*scale,
+										outOrigin[2] - a_upVec[2]*scale + a_rtVec[2]*scale);
+
+				// Top right
+				Vec2Set(outCoords[3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
+				Vec3Set(outVerts[3],	outOrigin[0] + a_upVec[0]*scale + a_rtVec[0]*scale,
+										outOrigin[1] + a_upVec[1]*scale + a_rtVec[1]*scale,
+										outOrigin[2] + a_upVec[2]*scale + a_rtVec[2]*scale);
+			}
+
+			poly->mat = mat;
+			Vec3Copy(outOrigin, poly->origin);
+			poly->radius = scale;
+		}
+		break;
+
+	case PART_STYLE_BEAM:
+		{
+			vec3_t point, width;
+
+			Vec3Subtract(outOrigin, cg.refDef.viewOrigin, point);
+			CrossProduct(point, angle, width);
+			VectorNormalizeFastf(width);
+			Vec3Scale(width, scale, width);
+
+			vec3_t delta;
+			Vec3Add(outOrigin, angle, delta);
+			float dist = Vec3DistFast(outOrigin, delta) / 64.0f; // FIXME: tile based off of material's height (see: sizeBase)
+
+			Vec2Set(outCoords[0], 0, 0);
+			Vec3Set(outVerts[0],	outOrigin[0] - width[0],
+									outOrigin[1] - width[1],
+									outOrigin[2] - width[2]);
+
+			Vec2Set(outCoords[1], 1, 0);
+			Vec3Set(outVerts[1],	outOrigin[0] + width[0],
+									outOrigin[1] + width[1],
+									outOrigin[2] + width[2]);
+
+			Vec3Add(point, angle, point);
+			CrossProduct(point, angle, width);
+			VectorNormalizeFastf(width);
+			Vec3Scale(width, scale, width);
+
+			Vec2Set(outCoords[2], 1, dist);
+			Vec3Set(outVerts[2],	delta[0] + width[0],
+									delta[1] + width[1],
+									delta[2] + width[2]);
+
+			Vec2Set(outCoords[3], 0, dist);
+			Vec3Set(outVerts[3],	delta[0] - width[0],
+									delta[1] - width[1],
+									delta[2] - width[2]);
+
+			poly->mat = mat;
+			Vec3Copy(outOrigin, poly->origin);
+			poly->radius = Vec3DistFast(outOrigin, delta);
+		}
+		break;
+
+	case PART_STYLE_DIRECTION:
+		{
+			vec3_t delta, vdelta;
+
+			Vec3Add(angle, outOrigin, vdelta);
+
+			vec3_t move;
+			Vec3Subtract(outOrigin, vdelta, move);
+			VectorNormalizeFastf(move);
+
+			vec3_t a_upVec, a_rtVec;
+			Vec3Copy(move, a_upVec);
+			Vec3Subtract(cg.refDef.viewOrigin, vdelta, delta);
+			CrossProduct(a_upVec, delta, a_rtVec);
+
+			VectorNormalizeFastf(a_rtVec);
+
+			Vec3Scale(a_rtVec, 0.75f, a_rtVec);
+			Vec3Scale(a_upVec, 0.75f * Vec3LengthFast(angle), a_upVec);
+
+			// Top left
+			Vec2Set(outCoords[0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
+			Vec3Set(outVerts[0], outOrigin[0] + a_upVec[0]*scale - a_rtVec[0]*scale,
+								outOrigin[1] + a_upVec[1]*scale - a_rtVec[1]*scale,
+								outOrigin[2] + a_upVec[2]*scale - a_rtVec[2]*scale);
+
+			// Bottom left
+			Vec2Set(outCoords[1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
+			Vec3Set(outVerts[1], outOrigin[0] - a_upVec[0]*scale - a_rtVec[0]*scale,
+								outOrigin[1] - a_upVec[1]*scale - a_rtVec[1]*scale,
+								outOrigin[2] - a_upVec[2]*scale - a_rtVec[2]*scale);
+
+			// Bottom right
+			Vec2Set(outCoords[2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
+			Vec3Set(outVerts[2], outOrigin[0] - a_upVec[0]*scale + a_rtVec[0]*scale,
+								outOrigin[1] - a_upVec[1]*scale + a_rtVec[1]*scale,
+								outOrigin[2] - a_upVec[2]*scale + a_rtVec[2]*scale);
+
+			// Top right
+			Vec2Set(outCoords[3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
+			Vec3Set(outVerts[3], outOrigin[0] + a_upVec[0]*scale + a_rtVec[0]*scale,
+								outOrigin[1] + a_upVec[1]*scale + a_rtVec[1]*scale,
+								outOrigin[2] + a_upVec[2]*scale + a_rtVec[2]*scale);
+
+			poly->mat = mat;
+			Vec3Copy(outOrigin, poly->origin);
+			poly->radius = scale;
+		}
+		break;
+
+	case PART_STYLE_QUAD:
+		if (outOrient)
+		{
+			float c, s;
+
+			Q_SinCosf(DEG2RAD(outOrient), &c, &s);
+			c *= scale;
+			s *= scale;
+
+			// Top left
+			Vec2Set(outCoords[0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
+			Vec3Set(outVerts[0],	outOrigin[0] + cg.refDef.viewAxis[1][0]*c + cg.refDef.viewAxis[2][0]*s,
+									outOrigin[1] + cg.refDef.viewAxis[1][1]*c + cg.refDef.viewAxis[2][1]*s,
+									outOrigin[2] + cg.refDef.viewAxis[1][2]*c + cg.refDef.viewAxis[2][2]*s);
+
+			// Bottom left
+			Vec2Set(outCoords[1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
+			Vec3Set(outVerts[1],	outOrigin[0] - cg.refDef.viewAxis[1][0]*s + cg.refDef.viewAxis[2][0]*c,
+									outOrigin[1] - cg.refDef.viewAxis[1][1]*s + cg.refDef.viewAxis[2][1]*c,
+									outOrigin[2] - cg.refDef.viewAxis[1][2]*s + cg.refDef.viewAxis[2][2]*c);
+
+			// Bottom right
+			Vec2Set(outCoords[2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
+			Vec3Set(outVerts[2],	outOrigin[0] - cg.refDef.viewAxis[1][0]*c - cg.refDef.viewAxis[2][0]*s,
+									outOrigin[1] - cg.refDef.viewAxis[1][1]*c - cg.refDef.viewAxis[2][1]*s,
+									outOrigin[2] - cg.refDef.viewAxis[1][2]*c - cg.refDef.viewAxis[2][2]*s);
+
+			// Top right
+			Vec2Set(outCoords[3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
+			Vec3Set(outVerts[3],	outOrigin[0] + cg.refDef.viewAxis[1][0]*s - cg.refDef.viewAxis[2][0]*c,
+									outOrigin[1] + cg.refDef.viewAxis[1][1]*s - cg.refDef.viewAxis[2][1]*c,
+									outOrigin[2] + cg.refDef.viewAxis[1][2]*s - cg.refDef.viewAxis[2][2]*c);
+		}
+		else
+		{
+			// Top left
+			Vec2Set(outCoords[0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
+			Vec3Set(outVerts[0],	outOrigin[0] + cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
+									outOrigin[1] + cg.refDef.viewAxis[2][1]*scale + cg.refDef.viewAxis[1][1]*scale,
+									outOrigin[2] + cg.refDef.viewAxis[2][2]*scale + cg.refDef.viewAxis[1][2]*scale);
+
+			// Bottom left
+			Vec2Set(outCoords[1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
+			Vec3Set(outVerts[1],	outOrigin[0] - cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
+									outOrigin[1] - cg.refDef.viewAxis[2][1]*scale + cg.refDef.viewAxis[1][1]*scale,
+									outOrigin[2] - cg.refDef.viewAxis[2][2]*scale + cg.refDef.viewAxis[1][2]*scale);
+
+			// Bottom right
+			Vec2Set(outCoords[2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
+			Vec3Set(outVerts[2],	outOrigin[0] - cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
+									outOrigin[1] - cg.refDef.viewAxis[2][1]*scale - cg.refDef.viewAxis[1][1]*scale,
+									outOrigin[2] - cg.refDef.viewAxis[2][2]*scale - cg.refDef.viewAxis[1][2]*scale);
+
+			// Top right
+			Vec2Set(outCoords[3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
+			Vec3Set(outVerts[3],	outOrigin[0] + cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
+									outOrigin[1] + cg.refDef.viewAxis[2][1]*scale - cg.refDef.viewAxis[1][1]*scale,
+									outOrigin[2] + cg.refDef.viewAxis[2][2]*scale - cg.refDef.viewAxis[1][2]*scale);
+		}
+
+		poly->mat = mat;
+		Vec3Copy(outOrigin, poly->origin);
+		poly->radius = scale;
+		break;
+
+	default:
+		assert(0);
+		return false;
+	}
+
+	return true;
 }
 
 
 /*
 ===============
-CG_AddParticles
+CG_IntegrateSimpleParticles
+
+Computes this frame's origin, color and size for a range of simple particles.
 ===============
 */
-void CG_AddParticles()
+static void CG_IntegrateSimpleParticles(const int first, const int last)
 {
-	CG_AddMapFXToList();
-	CG_AddSustains();
+	const cgSimpleParticles_t *sp = &cg_simpleParticles;
+	cgSimpleParticleState_t *st = &cg_simpleState;
 
-	if (!cl_add_particles->intVal)
-		return;
+	const simdVec_t refreshTime = Simd_Splat((float)cg.refreshTime);
+	const simdVec_t one = Simd_Splat(1.0f);
+	const simdVec_t zero = Simd_Zero();
+	const simdVec_t colorMax = Simd_Splat(255.0f);
+
+	// MAX_PARTICLES is a multiple of SIMD_WIDTH, so the last batch never overruns
+	const int numBatched = SIMD_ALIGN(last);
+	for (int i=first ; i<numBatched ; i+=SIMD_WIDTH)
+	{
+		// Time since spawn, or 1 for instant particles
+		const simdVec_t time = Simd_Madd(Simd_Sub(refreshTime, Simd_Load(&sp->time[i])), Simd_Load(&sp->timeScale[i]), Simd_Load(&sp->timeBias[i]));
+		const simdVec_t timeSquared = Simd_Mul(time, time);
+
+		// Alpha
+		const simdVec_t baseAlpha = Simd_Load(&sp->color[3][i]);
+		const simdVec_t alpha = Simd_Min(Simd_Madd(time, Simd_Load(&sp->colorVel[3][i]), baseAlpha), one);
+		Simd_Store(&st->color[3][i], alpha);
+
+		// Origin
+		for (int j=0 ; j<3 ; j++)
+		{
+			simdVec_t org = Simd_Madd(Simd_Load(&sp->vel[j][i]), time, Simd_Load(&sp->org[j][i]));
+			org = Simd_Madd(Simd_Load(&sp->accel[j][i]), timeSquared, org);
+			Simd_Store(&st->org[j][i], org);
+		}
+
+		// Size and color move towards their targets as the particle fades
+		const simdVec_t frac = Simd_Mul(Simd_Sub(baseAlpha, alpha), Simd_Load(&sp->lerpScale[i]));
+
+		const simdVec_t size = Simd_Load(&sp->size[i]);
+		Simd_Store(&st->size[i], Simd_Madd(Simd_Sub(Simd_Load(&sp->sizeVel[i]), size), frac, size));
+
+		for (int j=0 ; j<3 ; j++)
+		{
+			const simdVec_t color = Simd_Load(&sp->color[j][i]);
+			const simdVec_t lerped = Simd_Madd(Simd_Sub(Simd_Load(&sp->colorVel[j][i]), color), frac, color);
+			Simd_Store(&st->color[j][i], Simd_Min(Simd_Max(lerped, zero), colorMax));
+		}
+	}
+}
 
-	int partNum = 0;
-	TLinkedList<cgParticle_t*>::Node *next = null;
 
-	for (var cur = cg_particles.Head(); cur != null; cur = next)
+/*
+===============
+CG_SimpleParticleJob
+
+Integrates one chunk of the simple pool and builds its quads.
+===============
+*/
+static void CG_SimpleParticleJob(void *arg, const int taskNum, const int threadNum)
+{
+	cgSimpleParticles_t *sp = &cg_simpleParticles;
+	cgSimpleParticleState_t *st = &cg_simpleState;
+
+	const int first = taskNum * PART_CHUNK_SIZE;
+	const int last = min(first + PART_CHUNK_SIZE, sp->numParticles);
+
+	CG_IntegrateSimpleParticles(first, last);
+
+	int numPolys = 0;
+	for (int i=first ; i<last ; i++)
 	{
-		next = cur->Next;
-		var p = cur->Value;
+		// Faded out, freed on the main thread
+		st->bDead[i] = (st->color[3][i] <= TINY_NUMBER);
+		if (st->bDead[i])
+			continue;
 
-		// Check if we hit our limit
-		if (++partNum > cg_particleMax->intVal)
-			break;
+		// Skip it if it's too small
+		if (st->size[i] > TINY_NUMBER)
+		{
+			vec3_t outOrigin;
+			vec4_t color;
+
+			Vec3Set(outOrigin, st->org[0][i], st->org[1][i], st->org[2][i]);
+			Vec4Set(color, st->color[0][i], st->color[1][i], st->color[2][i], st->color[3][i]);
+
+			if (CG_BuildParticlePoly(first+numPolys, sp->type[i], sp->style[i], sp->flags[i], sp->mat[i], sp->angle[i], outOrigin, color, st->size[i], sp->orient[i]))
+				numPolys++;
+		}
+
+		// Kill if instant
+		if (sp->bInstant[i])
+			sp->color[3][i] = 0;
+	}
+
+	cg_partChunkPolys[taskNum] = numPolys;
+}
+
+
+/*
+===============
+CG_AddSimpleParticles
+===============
+*/
+static void CG_AddSimpleParticles()
+{
+	cgSimpleParticles_t *sp = &cg_simpleParticles;
+
+	const int numChunks = (sp->numParticles + PART_CHUNK_SIZE-1) / PART_CHUNK_SIZE;
+	cg_jobs.Run(CG_SimpleParticleJob, NULL, numChunks);
+
+	// Merge each chunk's quads in order
+	for (int i=0 ; i<numChunks ; i++)
+	{
+		refPoly_t *poly = &cg_partPolys[i*PART_CHUNK_SIZE];
+		for (int j=0 ; j<cg_partChunkPolys[i] ; j++, poly++)
+			cgi.R_AddPoly(poly);
+	}
+
+	// Compact
+	for (int i=0 ; i<sp->numParticles ; )
+	{
+		if (cg_simpleState.bDead[i])
+			CG_FreeSimpleParticle(i);
+		else
+			i++;
+	}
+}
+
+
+/*
+===============
+CG_AddThinkParticles
+===============
+*/
+static void CG_AddThinkParticles()
+{
+	int numPolys = 0;
+	for (int index=0 ; index<cg_numThinkParticles ; )
+	{
+		cgParticle_t *p = &cg_thinkParticles[index];
 
 		float time;
 		vec4_t color;
@@ -199,7 +872,7 @@ void CG_AddParticles()
 		// Faded out
 		if (color[3] <= TINY_NUMBER)
 		{
-			CG_FreeParticle(p);
+			CG_FreeThinkParticle(index);
 			continue;
 		}
 
@@ -292,336 +965,12 @@ void CG_AddParticles()
 					break;
 			}
 
-			bool culled = false;
-
-			// Culling
-			switch (p->style)
+			const int polyNum = PART_THINK_POLYS + numPolys;
+			if (polyNum < MAX_PART_POLYS && CG_BuildParticlePoly(polyNum, p->type, p->style, p->flags, p->mat, p->angle, outOrigin, color, size, outOrient))
 			{
-			case PART_STYLE_ANGLED:
-			case PART_STYLE_BEAM:
-			case PART_STYLE_DIRECTION:
-				break;
-
-			default:
-				if (cg_particleCulling->intVal)
-				{
-					// Kill particles behind the view
-					vec3_t temp;
-					Vec3Subtract(outOrigin, cg.refDef.viewOrigin, temp);
-					VectorNormalizeFastf(temp);
-					if (DotProduct(temp, cg.refDef.viewAxis[0]) < 0)
-						culled = true;
-
-					// Lessen fillrate consumption
-					if (!(p->flags & PF_NOCLOSECULL))
-					{
-						float dist = Vec3DistSquared(cg.refDef.viewOrigin, outOrigin);
-						if (dist <= 5*5)
-							culled = true;
-					}
-				}
-				break;
-			}
-
-			if (culled)
-				break;
-
-			// Alpha*color
-			if (p->flags & PF_ALPHACOLOR)
-				Vec3Scale(color, color[3], color);
-
-			// Add to be rendered
-			float scale;
-			if (p->flags & PF_SCALED)
-			{
-				scale = (outOrigin[0] - cg.refDef.viewOrigin[0]) * cg.refDef.viewAxis[0][0] +
-						(outOrigin[1] - cg.refDef.viewOrigin[1]) * cg.refDef.viewAxis[0][1] +
-						(outOrigin[2] - cg.refDef.viewOrigin[2]) * cg.refDef.viewAxis[0][2];
-
-				scale = (scale < 20) ? 1 : 1 + scale * 0.004f;
-				scale = (scale - 1) + size;
-			}
-			else
-			{
-				scale = size;
-			}
-
-			// Rendering
-			colorb outColor (
-				color[0],
-				color[1],
-				color[2],
-				color[3] * 255);
-
-			switch(p->style)
-			{
-			case PART_STYLE_ANGLED:
-				{
-					vec3_t a_upVec, a_rtVec;
-
-					Angles_Vectors(p->angle, NULL, a_rtVec, a_upVec); 
-
-					if (outOrient)
-					{
-						float c, s;
-
-						Q_SinCosf(DEG2RAD(outOrient), &c, &s);
-						c *= scale;
-						s *= scale;
-
-						// Top left
-						Vec2Set(p->outCoords[0], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][1]);
-						Vec3Set(p->outVertices[0],	outOrigin[0] + a_upVec[0]*s - a_rtVec[0]*c,
-													outOrigin[1] + a_upVec[1]*s - a_rtVec[1]*c,
-													outOrigin[2] + a_upVec[2]*s - a_rtVec[2]*c);
-
-						// Bottom left
-						Vec2Set(p->outCoords[1], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][3]);
-						Vec3Set(p->outVertices[1],	outOrigin[0] - a_upVec[0]*c - a_rtVec[0]*s,
-													outOrigin[1] - a_upVec[1]*c - a_rtVec[1]*s,
-													outOrigin[2] - a_upVec[2]*c - a_rtVec[2]*s);
-
-						// Bottom right
-						Vec2Set(p->outCoords[2], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][3]);
-						Vec3Set(p->outVertices[2],	outOrigin[0] - a_upVec[0]*s + a_rtVec[0]*c,
-													outOrigin[1] - a_upVec[1]*s + a_rtVec[1]*c,
-													outOrigin[2] - a_upVec[2]*s + a_rtVec[2]*c);
-
-						// Top right
-						Vec2Set(p->outCoords[3], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][1]);
-						Vec3Set(p->outVertices[3],	outOrigin[0] + a_upVec[0]*c + a_rtVec[0]*s,
-													outOrigin[1] + a_upVec[1]*c + a_rtVec[1]*s,
-													outOrigin[2] + a_upVec[2]*c + a_rtVec[2]*s);
-					}
-					else
-					{
-						// Top left
-						Vec2Set(p->outCoords[0], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][1]);
-						Vec3Set(p->outVertices[0],	outOrigin[0] + a_upVec[0]*scale - a_rtVec[0]*scale,
-													outOrigin[1] + a_upVec[1]*scale - a_rtVec[1]*scale,
-													outOrigin[2] + a_upVec[2]*scale - a_rtVec[2]*scale);
-
-						// Bottom left
-						Vec2Set(p->outCoords[1], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][3]);
-						Vec3Set(p->outVertices[1],	outOrigin[0] - a_upVec[0]*scale - a_rtVec[0]*scale,
-													outOrigin[1] - a_upVec[1]*scale - a_rtVec[1]*scale,
-													outOrigin[2] - a_upVec[2]*scale - a_rtVec[2]*scale);
-
-						// Bottom right
-						Vec2Set(p->outCoords[2], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][3]);
-						Vec3Set(p->outVertices[2],	outOrigin[0] - a_upVec[0]*scale + a_rtVec[0]*scale,
-													outOrigin[1] - a_upVec[1]*scale + a_rtVec[1]*scale,
-													outOrigin[2] - a_upVec[2]*scale + a_rtVec[2]*scale);
-
-						// Top right
-						Vec2Set(p->outCoords[3], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][1]);
-						Vec3Set(p->outVertices[3],	outOrigin[0] + a_upVec[0]*scale + a_rtVec[0]*scale,
-													outOrigin[1] + a_upVec[1]*scale + a_rtVec[1]*scale,
-													outOrigin[2] + a_upVec[2]*scale + a_rtVec[2]*scale);
-					}
-
-					// Render it
-					p->outColor[0] = outColor;
-					p->outColor[1] = outColor;
-					p->outColor[2] = outColor;
-					p->outColor[3] = outColor;
-
-					p->outPoly.mat = p->mat;
-					Vec3Copy(outOrigin, p->outPoly.origin);
-					p->outPoly.radius = scale;
-
-					cgi.R_AddPoly(&p->outPoly);
-				}
-				break;
-
-			case PART_STYLE_BEAM:
-				{
-					vec3_t point, width;
-
-					Vec3Subtract(outOrigin, cg.refDef.viewOrigin, point);
-					CrossProduct(point, p->angle, width);
-					VectorNormalizeFastf(width);
-					Vec3Scale(width, scale, width);
-
-					vec3_t delta;
-					Vec3Add(outOrigin, p->angle, delta);
-					float dist = Vec3DistFast(outOrigin, delta) / 64.0f; // FIXME: tile based off of material's height (see: sizeBase)
-
-					Vec2Set(p->outCoords[0], 0, 0);
-					Vec3Set(p->outVertices[0],	outOrigin[0] - width[0],
-												outOrigin[1] - width[1],
-												outOrigin[2] - width[2]);
-
-					Vec2Set(p->outCoords[1], 1, 0);
-					Vec3Set(p->outVertices[1],	outOrigin[0] + width[0],
-												outOrigin[1] + width[1],
-												outOrigin[2] + width[2]);
-
-					Vec3Add(point, p->angle, point);
-					CrossProduct(point, p->angle, width);
-					VectorNormalizeFastf(width);
-					Vec3Scale(width, scale, width);
-
-					Vec2Set(p->outCoords[2], 1, dist);
-					Vec3Set(p->outVertices[2],	delta[0] + width[0],
-												delta[1] + width[1],
-												delta[2] + width[2]);
-
-					Vec2Set(p->outCoords[3], 0, dist);
-					Vec3Set(p->outVertices[3],	delta[0] - width[0],
-												delta[1] - width[1],
-												delta[2] - width[2]);
-
-					// Render it
-					p->outColor[0] = outColor;
-					p->outColor[1] = outColor;
-					p->outColor[2] = outColor;
-					p->outColor[3] = outColor;
-
-					p->outPoly.mat = p->mat;
-					Vec3Copy(outOrigin, p->outPoly.origin);
-					p->outPoly.radius = Vec3DistFast(outOrigin, delta);
-
-					cgi.R_AddPoly(&p->outPoly);
-				}
-				break;
-
-			case PART_STYLE_DIRECTION:
-				{
-					vec3_t delta, vdelta;
-
-					Vec3Add(p->angle, outOrigin, vdelta);
-
-					vec3_t move;
-					Vec3Subtract(outOrigin, vdelta, move);
-					VectorNormalizeFastf(move);
-
-					vec3_t a_upVec, a_rtVec;
-					Vec3Copy(move, a_upVec);
-					Vec3Subtract(cg.refDef.viewOrigin, vdelta, delta);
-					CrossProduct(a_upVec, delta, a_rtVec);
-
-					VectorNormalizeFastf(a_rtVec);
-
-					Vec3Scale(a_rtVec, 0.75f, a_rtVec);
-					Vec3Scale(a_upVec, 0.75f * Vec3LengthFast(p->angle), a_upVec);
-
-					// Top left
-					Vec2Set(p->outCoords[0], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][1]);
-					Vec3Set(p->outVertices[0], outOrigin[0] + a_upVec[0]*scale - a_rtVec[0]*scale,
-												outOrigin[1] + a_upVec[1]*scale - a_rtVec[1]*scale,
-												outOrigin[2] + a_upVec[2]*scale - a_rtVec[2]*scale);
-
-					// Bottom left
-					Vec2Set(p->outCoords[1], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][3]);
-					Vec3Set(p->outVertices[1], outOrigin[0] - a_upVec[0]*scale - a_rtVec[0]*scale,
-												outOrigin[1] - a_upVec[1]*scale - a_rtVec[1]*scale,
-												outOrigin[2] - a_upVec[2]*scale - a_rtVec[2]*scale);
-
-					// Bottom right
-					Vec2Set(p->outCoords[2], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][3]);
-					Vec3Set(p->outVertices[2], outOrigin[0] - a_upVec[0]*scale + a_rtVec[0]*scale,
-												outOrigin[1] - a_upVec[1]*scale + a_rtVec[1]*scale,
-												outOrigin[2] - a_upVec[2]*scale + a_rtVec[2]*scale);
-
-					// Top right
-					Vec2Set(p->outCoords[3], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][1]);
-					Vec3Set(p->outVertices[3], outOrigin[0] + a_upVec[0]*scale + a_rtVec[0]*scale,
-												outOrigin[1] + a_upVec[1]*scale + a_rtVec[1]*scale,
-												outOrigin[2] + a_upVec[2]*scale + a_rtVec[2]*scale);
-
-					// Render it
-					p->outColor[0] = outColor;
-					p->outColor[1] = outColor;
-					p->outColor[2] = outColor;
-					p->outColor[3] = outColor;
-
-					p->outPoly.mat = p->mat;
-					Vec3Copy(outOrigin, p->outPoly.origin);
-					p->outPoly.radius = scale;
-
-					cgi.R_AddPoly(&p->outPoly);
-				}
-				break;
-
-			case PART_STYLE_QUAD:
-				if (outOrient)
-				{
-					float c, s;
-
-					Q_SinCosf(DEG2RAD(outOrient), &c, &s);
-					c *= scale;
-					s *= scale;
-
-					// Top left
-					Vec2Set(p->outCoords[0], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][1]);
-					Vec3Set(p->outVertices[0],	outOrigin[0] + cg.refDef.viewAxis[1][0]*c + cg.refDef.viewAxis[2][0]*s,
-												outOrigin[1] + cg.refDef.viewAxis[1][1]*c + cg.refDef.viewAxis[2][1]*s,
-												outOrigin[2] + cg.refDef.viewAxis[1][2]*c + cg.refDef.viewAxis[2][2]*s);
-
-					// Bottom left
-					Vec2Set(p->outCoords[1], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][3]);
-					Vec3Set(p->outVertices[1],	outOrigin[0] - cg.refDef.viewAxis[1][0]*s + cg.refDef.viewAxis[2][0]*c,
-												outOrigin[1] - cg.refDef.viewAxis[1][1]*s + cg.refDef.viewAxis[2][1]*c,
-												outOrigin[2] - cg.refDef.viewAxis[1][2]*s + cg.refDef.viewAxis[2][2]*c);
-
-					// Bottom right
-					Vec2Set(p->outCoords[2], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][3]);
-					Vec3Set(p->outVertices[2],	outOrigin[0] - cg.refDef.viewAxis[1][0]*c - cg.refDef.viewAxis[2][0]*s,
-												outOrigin[1] - cg.refDef.viewAxis[1][1]*c - cg.refDef.viewAxis[2][1]*s,
-												outOrigin[2] - cg.refDef.viewAxis[1][2]*c - cg.refDef.viewAxis[2][2]*s);
-
-					// Top right
-					Vec2Set(p->outCoords[3], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][1]);
-					Vec3Set(p->outVertices[3],	outOrigin[0] + cg.refDef.viewAxis[1][0]*s - cg.refDef.viewAxis[2][0]*c,
-												outOrigin[1] + cg.refDef.viewAxis[1][1]*s - cg.refDef.viewAxis[2][1]*c,
-												outOrigin[2] + cg.refDef.viewAxis[1][2]*s - cg.refDef.viewAxis[2][2]*c);
-				}
-				else
-				{
-					// Top left
-					Vec2Set(p->outCoords[0], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][1]);
-					Vec3Set(p->outVertices[0],	outOrigin[0] + cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
-												outOrigin[1] + cg.refDef.viewAxis[2][1]*scale + cg.refDef.viewAxis[1][1]*scale,
-												outOrigin[2] + cg.refDef.viewAxis[2][2]*scale + cg.refDef.viewAxis[1][2]*scale);
-
-					// Bottom left
-					Vec2Set(p->outCoords[1], cgMedia.particleCoords[p->type][0], cgMedia.particleCoords[p->type][3]);
-					Vec3Set(p->outVertices[1],	outOrigin[0] - cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
-												outOrigin[1] - cg.refDef.viewAxis[2][1]*scale + cg.refDef.viewAxis[1][1]*scale,
-												outOrigin[2] - cg.refDef.viewAxis[2][2]*scale + cg.refDef.viewAxis[1][2]*scale);
-
-					// Bottom right
-					Vec2Set(p->outCoords[2], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][3]);
-					Vec3Set(p->outVertices[2],	outOrigin[0] - cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
-												outOrigin[1] - cg.refDef.viewAxis[2][1]*scale - cg.refDef.viewAxis[1][1]*scale,
-												outOrigin[2] - cg.refDef.viewAxis[2][2]*scale - cg.refDef.viewAxis[1][2]*scale);
-
-					// Top right
-					Vec2Set(p->outCoords[3], cgMedia.particleCoords[p->type][2], cgMedia.particleCoords[p->type][1]);
-					Vec3Set(p->outVertices[3],	outOrigin[0] + cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
-												outOrigin[1] + cg.refDef.viewAxis[2][1]*scale - cg.refDef.viewAxis[1][1]*scale,
-												outOrigin[2] + cg.refDef.viewAxis[2][2]*scale - cg.refDef.viewAxis[1][2]*scale);
-				}
-
-				// Render it
-				p->outColor[0] = outColor;
-				p->outColor[1] = outColor;
-				p->outColor[2] = outColor;
-				p->outColor[3] = outColor;
-
-				p->outPoly.mat = p->mat;
-				Vec3Copy(outOrigin, p->outPoly.origin);
-				p->outPoly.radius = scale;
-
-				cgi.R_AddPoly(&p->outPoly);
-				break;
-
-			default:
-				assert(0);
-				break;
+				cgi.R_AddPoly(&cg_partPolys[polyNum]);
+				numPolys++;
 			}
-
 			break;
 		}
 
@@ -631,5 +980,37 @@ void CG_AddParticles()
 			p->color[3] = 0;
 			p->colorVel[3] = 0;
 		}
+
+		index++;
+	}
+}
+
+
+/*
+===============
+CG_AddParticles
+===============
+*/
+void CG_AddParticles()
+{
+	CG_AddMapFXToList();
+	CG_AddSustains();
+
+	if (!cl_add_particles->intVal)
+		return;
+
+	// Drop whatever no longer fits if cg_particleMax was lowered
+	const int maxParticles = min(cg_particleMax->intVal, MAX_PARTICLES);
+	while (cg_numThinkParticles+cg_simpleParticles.numParticles > maxParticles)
+	{
+		if (cg_simpleParticles.numParticles)
+			cg_simpleParticles.numParticles--;
+		else
+			cg_numThinkParticles--;
 	}
+
+	// Think functions trace and spawn particles, so they stay on this thread
+	// and run first so anything they spawn is drawn this frame
+	CG_AddThinkParticles();
+	CG_AddSimpleParticles();
 }
@@ -23,7 +23,86 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #include "cg_local.h"
 
-static TList<entityState_t*>	cg_solidList;
+/*
+=============================================================================
+
+	SOLID LIST
+
+	Solid entities of the current frame, with a small bounding volume tree
+	over them that is rebuilt once per server frame. Traces walk the tree to
+	find the solids their box touches, then clip those in list order so the
+	result is the same as testing every solid.
+
+=============================================================================
+*/
+
+#define CG_SOLID_LEAF_SIZE	4
+
+struct cgSolid_t
+{
+	entityState_t	*ent;
+	vec3_t			absMins;
+	vec3_t			absMaxs;
+};
+
+struct cgSolidNode_t
+{
+	vec3_t			mins;
+	vec3_t			maxs;
+	int				firstSolid;		// into cg_solidOrder, leaves only
+	int				numSolids;		// zero for interior nodes
+	int				skip;			// nodes to step over when this one is missed
+};
+
+static cgSolid_t		cg_solids[MAX_PARSE_ENTITIES];
+static int				cg_numSolids;
+static int				cg_solidOrder[MAX_PARSE_ENTITIES];
+static cgSolidNode_t	cg_solidNodes[MAX_PARSE_ENTITIES*2];
+static int				cg_numSolidNodes;
+static int				cg_solidListGen;		// bumped whenever the solid list is rebuilt
+static int				cg_solidSortAxis;
+
+/*
+=============================================================================
+
+	PREDICTION CACHE
+
+	Every client frame re-runs Pmove from the acknowledged state for each
+	outstanding command. Between server frames the base state, the solids and
+	all but the pending command are the same as last time, so the Pmove after
+	each command is kept and replay resumes from the first command that is
+	new or differs.
+
+=============================================================================
+*/
+
+struct cgPredictMove_t
+{
+	int				cmdNum;
+	userCmd_t		cmd;
+	pMoveNew_t		pm;				// state after cmd
+};
+
+struct cgPredictCache_t
+{
+	bool			valid;
+	int				ack;
+	int				solidListGen;
+	pMoveState_t	baseState;
+	float			airAccel;
+	bool			strafeHack;
+	bool			attractLoop;
+
+	cgPredictMove_t	moves[CMD_BACKUP];
+};
+
+static cgPredictCache_t	cg_predictCache;
+
+// cl_showpredict counts, per client frame
+static int				cg_predictMoves;
+static int				cg_predictReplays;
+static int				cg_predictTraces;
+static int				cg_predictClips;
 
 /*
 ===================
@@ -62,6 +141,102 @@ void CG_CheckPredictionError ()
 }
 
 
+/*
+====================
+CG_SolidBox
+
+Decodes the bounding box of a non-bmodel solid.
+====================
+*/
+static void CG_SolidBox (entityState_t *ent, vec3_t bmins, vec3_t bmaxs)
+{
+	int		x, zd, zu;
+
+	if (cg.protocolMinorVersion >= MINOR_VERSION_R1Q2_32BIT_SOLID)
+	{
+		x = (ent->solid & 255);
+		zd = ((ent->solid>>8) & 255);
+		zu = ((ent->solid>>16) & 65535) - 32768;
+	}
+	else
+	{
+		x = 8 * (ent->solid & 31);
+		zd = 8 * ((ent->solid >> 5) & 31);
+		zu = 8 * ((ent->solid >> 10) & 63) - 32;
+	}
+
+	bmins[0] = bmins[1] = -x;
+	bmaxs[0] = bmaxs[1] = x;
+	bmins[2] = -zd;
+	bmaxs[2] = zu;
+}
+
+
+/*
+====================
+CG_SolidSortCmp
+====================
+*/
+static int CG_SolidSortCmp (const void *a, const void *b)
+{
+	const cgSolid_t	*s1 = &cg_solids[*(const int *)a];
+	const cgSolid_t	*s2 = &cg_solids[*(const int *)b];
+	const float		c1 = s1->absMins[cg_solidSortAxis] + s1->absMaxs[cg_solidSortAxis];
+	const float		c2 = s2->absMins[cg_solidSortAxis] + s2->absMaxs[cg_solidSortAxis];
+
+	if (c1 < c2)
+		return -1;
+	if (c1 > c2)
+		return 1;
+	return *(const int *)a - *(const int *)b;
+}
+
+
+/*
+====================
+CG_BuildSolidNode
+
+Splits at the median solid along the longest axis until a node holds at
+most CG_SOLID_LEAF_SIZE solids. Nodes are laid out depth first, so missing a
+node skips straight past its children.
+====================
+*/
+static void CG_BuildSolidNode (const int first, const int num)
+{
+	const int		nodeNum = cg_numSolidNodes++;
+	cgSolidNode_t	*node = &cg_solidNodes[nodeNum];
+	cgSolid_t		*solid;
+	vec3_t			size;
+	int				i;
+
+	ClearBounds (node->mins, node->maxs);
+	for (i=first ; i<first+num ; i++) {
+		solid = &cg_solids[cg_solidOrder[i]];
+		AddPointToBounds (solid->absMins, node->mins, node->maxs);
+		AddPointToBounds (solid->absMaxs, node->mins, node->maxs);
+	}
+
+	if (num <= CG_SOLID_LEAF_SIZE) {
+		node->firstSolid = first;
+		node->numSolids = num;
+		node->skip = 1;
+		return;
+	}
+
+	Vec3Subtract (node->maxs, node->mins, size);
+	cg_solidSortAxis = (size[0] > size[1]) ? 0 : 1;
+	if (size[2] > size[cg_solidSortAxis])
+		cg_solidSortAxis = 2;
+	qsort (&cg_solidOrder[first], num, sizeof(cg_solidOrder[0]), CG_SolidSortCmp);
+
+	node->firstSolid = 0;
+	node->numSolids = 0;
+	CG_BuildSolidNode (first, num/2);
+	CG_BuildSolidNode (first + num/2, num - num/2);
+	cg_solidNodes[nodeNum].skip = cg_numSolidNodes - nodeNum;
+}
+
+
 /*
 ====================
 CG_BuildSolidList
@@ -69,37 +244,125 @@ CG_BuildSolidList
 */
 void CG_BuildSolidList ()
 {
-	entityState_t	*ent;
-	int				num, i;
+	entityState_t		*ent;
+	cgSolid_t			*solid;
+	struct cmBspModel_t	*cmodel;
+	vec3_t				bmins, bmaxs;
+	float				radius;
+	int					num, i, j;
+
+	cg_solidListGen++;
+	cg_numSolids = 0;
+	cg_numSolidNodes = 0;
 
-	cg_solidList.Clear();
 	for (i=0 ; i<cg.frame.numEntities ; i++) {
 		num = (cg.frame.parseEntities + i) & (MAX_PARSEENTITIES_MASK);
 		ent = &cg_parseEntities[num];
 
-		if (ent->solid)
-			cg_solidList.Add(ent);
+		if (!ent->solid)
+			continue;
+
+		if (ent->solid == 31) {
+			// Special value for bmodel
+			cmodel = cg.modelCfgClip[ent->modelIndex];
+			if (!cmodel)
+				continue;
+
+			cgi.CM_InlineModelBounds (cmodel, bmins, bmaxs);
+			if (ent->angles[0] || ent->angles[1] || ent->angles[2]) {
+				// Expand for rotation
+				radius = RadiusFromBounds (bmins, bmaxs);
+				Vec3Set (bmins, -radius, -radius, -radius);
+				Vec3Set (bmaxs, radius, radius, radius);
+			}
+		}
+		else
+			CG_SolidBox (ent, bmins, bmaxs);
+
+		solid = &cg_solids[cg_numSolids];
+		solid->ent = ent;
+		Vec3Add (ent->origin, bmins, solid->absMins);
+		Vec3Add (ent->origin, bmaxs, solid->absMaxs);
+		for (j=0 ; j<3 ; j++) {
+			solid->absMins[j] -= 1;
+			solid->absMaxs[j] += 1;
+		}
+
+		cg_solidOrder[cg_numSolids] = cg_numSolids;
+		cg_numSolids++;
+	}
+
+	if (cg_numSolids)
+		CG_BuildSolidNode (0, cg_numSolids);
+}
+
+
+/*
+====================
+CG_SolidsInBox
+
+Fills list with the solids whose bounds touch the box, in list order.
+====================
+*/
+static int CG_SolidsInBox (const vec3_t mins, const vec3_t maxs, int *list)
+{
+	cgSolidNode_t	*node;
+	int				numList, i, j, k, t;
+
+	numList = 0;
+	for (i=0 ; i<cg_numSolidNodes ; ) {
+		node = &cg_solidNodes[i];
+		if (!BoundsIntersect (node->mins, node->maxs, mins, maxs)) {
+			i += node->skip;
+			continue;
+		}
+
+		for (j=node->firstSolid ; j<node->firstSolid+node->numSolids ; j++) {
+			t = cg_solidOrder[j];
+			if (!BoundsIntersect (cg_solids[t].absMins, cg_solids[t].absMaxs, mins, maxs))
+				continue;
+
+			// Insertion sort, the hit lists are short
+			for (k=numList ; k>0 && list[k-1]>t ; k--)
+				list[k] = list[k-1];
+			list[k] = t;
+			numList++;
+		}
+		i++;
 	}
+
+	return numList;
 }
 
 
 /*
 ====================
 CG_ClipMoveToEntities
+
+Returns the number of solids clipped against.
 ====================
 */
-static void CG_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int ignoreNum, bool entities, bool bModels, cmTrace_t *out)
+static int CG_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int ignoreNum, bool entities, bool bModels, cmTrace_t *out)
 {
-	int				x, zd, zu;
 	cmTrace_t		trace;
 	int				headnode;
 	float			*angles;
 	entityState_t	*ent;
 	struct cmBspModel_t *cmodel;
 	vec3_t			bmins, bmaxs;
+	vec3_t			traceMins, traceMaxs;
+	int				list[MAX_PARSE_ENTITIES];
+	int				numList, numClipped, i;
 
-	for (uint32 i=0 ; i<cg_solidList.Count() ; i++) {
-		ent = cg_solidList[i];
+	for (i=0 ; i<3 ; i++) {
+		traceMins[i] = min (start[i], end[i]) + mins[i];
+		traceMaxs[i] = max (start[i], end[i]) + maxs[i];
+	}
+	numList = CG_SolidsInBox (traceMins, traceMaxs, list);
+
+	numClipped = 0;
+	for (i=0 ; i<numList ; i++) {
+		ent = cg_solids[list[i]].ent;
 		if (ent->number == ignoreNum)
 			continue;
 
@@ -119,31 +382,15 @@ static void CG_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_
 			if (!entities)
 				continue;
 
-			if (cg.protocolMinorVersion >= MINOR_VERSION_R1Q2_32BIT_SOLID)
-			{
-				x = (ent->solid & 255);
-				zd = ((ent->solid>>8) & 255);
-				zu = ((ent->solid>>16) & 65535) - 32768;
-			}
-			else
-			{
-				x = 8 * (ent->solid & 31);
-				zd = 8 * ((ent->solid >> 5) & 31);
-				zu = 8 * ((ent->solid >> 10) & 63) - 32;
-			}
-
-			bmins[0] = bmins[1] = -x;
-			bmaxs[0] = bmaxs[1] = x;
-			bmins[2] = -zd;
-			bmaxs[2] = zu;
-
+			CG_SolidBox (ent, bmins, bmaxs);
 			headnode = cgi.CM_HeadnodeForBox (bmins, bmaxs);
 			angles = vec3Origin;	// Boxes don't rotate
 		}
 
 		if (out->allSolid)
-			return;
+			break;
 
+		numClipped++;
 		cgi.CM_TransformedBoxTrace (&trace, start, end, mins, maxs, headnode, CONTENTS_MASK_PLAYERSOLID, ent->origin, angles);
 		if (trace.allSolid || trace.startSolid || trace.fraction < out->fraction) {
 			trace.ent = (struct edict_t *)ent;
@@ -157,6 +404,8 @@ static void CG_ClipMoveToEntities (vec3_t start, vec3_t mins, vec3_t maxs, vec3_
 		else if (trace.startSolid)
 			out->startSolid = true;
 	}
+
+	return numClipped;
 }
 
 
@@ -211,7 +460,8 @@ static cmTrace_t CG_PMLTrace (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end
 		tr.ent = (struct edict_t *)1;
 
 	// Check all other solid models
-	CG_ClipMoveToEntities (start, mins, maxs, end, cg.playerNum+1, true, true, &tr);
+	cg_predictClips += CG_ClipMoveToEntities (start, mins, maxs, end, cg.playerNum+1, true, true, &tr);
+	cg_predictTraces++;
 
 	return tr;
 }
@@ -257,15 +507,23 @@ Sets cg.predicted.origin and cg.predicted.angles
 */
 void CG_PredictMovement ()
 {
-	int			ack, current;
-	int			frame;
-	int			step;
-	float		oldStep;
-	pMoveNew_t	pm;
+	int				ack, current;
+	int				frame;
+	int				step;
+	float			oldStep;
+	float			airAccel;
+	pMoveNew_t		pm;
+	cgPredictMove_t	*move;
+	bool			cached;
 
 	if (cg_paused->intVal)
 		return;
 
+	cg_predictMoves = 0;
+	cg_predictReplays = 0;
+	cg_predictTraces = 0;
+	cg_predictClips = 0;
+
 	if (!cl_predict->intVal || cg.frame.playerState.pMove.pmFlags & PMF_NO_PREDICTION) {
 		userCmd_t	cmd;
 
@@ -306,13 +564,48 @@ void CG_PredictMovement ()
 		pm.multiplier = 1;
 
 	pm.strafeHack = cg.strafeHack;
+	airAccel = atof (cg.configStrings[CS_AIRACCEL]);
+
+	// The cached moves are only good for the same starting point and world
+	cached = (cg_predictCache.valid
+		&& cg_predictCache.ack == ack
+		&& cg_predictCache.solidListGen == cg_solidListGen
+		&& cg_predictCache.airAccel == airAccel
+		&& cg_predictCache.strafeHack == pm.strafeHack
+		&& cg_predictCache.attractLoop == cg.attractLoop
+		&& !memcmp (&cg_predictCache.baseState, &cg.frame.playerState.pMove, sizeof(pMoveState_t)));
+	if (!cached) {
+		cg_predictCache.valid = true;
+		cg_predictCache.ack = ack;
+		cg_predictCache.solidListGen = cg_solidListGen;
+		cg_predictCache.airAccel = airAccel;
+		cg_predictCache.strafeHack = pm.strafeHack;
+		cg_predictCache.attractLoop = cg.attractLoop;
+		cg_predictCache.baseState = cg.frame.playerState.pMove;
+	}
 
 	// Run frames
 	frame = 0;
 	while (++ack <= current) {		// Changed '<' to '<=' cause current is our pending cmd
 		frame = ack & CMD_MASK;
+		move = &cg_predictCache.moves[frame];
 		cgi.NET_GetUserCmd (frame, &pm.cmd);
 
+		// Resume from the cache until the first new or changed command
+		if (cached && move->cmdNum == ack && !memcmp (&move->cmd, &pm.cmd, sizeof(userCmd_t))) {
+			if (pm.cmd.msec <= 0)
+				continue;
+
+			pm = move->pm;
+			cg_predictReplays++;
+			Vec3Copy (pm.state.origin, cg.predicted.origins[frame]);
+			continue;
+		}
+		cached = false;
+
+		move->cmdNum = ack;
+		move->cmd = pm.cmd;
+
 		if (pm.cmd.msec <= 0)
 			continue;	// Ignore 'null' usercmd entries.
 
@@ -320,12 +613,19 @@ void CG_PredictMovement ()
 		Vec3Set (pm.mins, -16, -16, -24);
 		Vec3Set (pm.maxs,  16,  16,  32);
 
-		Pmove (&pm, atof (cg.configStrings[CS_AIRACCEL]));
+		Pmove (&pm, airAccel);
+		cg_predictMoves++;
+
+		move->pm = pm;
 
 		// Save for debug checking
 		Vec3Copy (pm.state.origin, cg.predicted.origins[frame]);
 	}
 
+	if (cl_showpredict->intVal)
+		Com_Printf (0, "%2i moves %2i cached %3i traces %3i clips\n",
+			cg_predictMoves, cg_predictReplays, cg_predictTraces, cg_predictClips);
+
 	// Calculate the step adjustment
 	step = pm.state.origin[2] - (int)(cg.predicted.origin[2] * 8);
 	if (pm.step && step > 0 && step < 320 && pm.state.pmFlags & PMF_ON_GROUND) {
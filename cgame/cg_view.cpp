@@ -141,19 +141,22 @@ static void V_SizeDown_f ()
 V_TestParticles
 ================
 */
-static cgParticle_t v_testParticleList[PT_PICTOTAL];
+static refPoly_t v_testPartPolys[PT_PICTOTAL];
+static colorb v_testPartColors[PT_PICTOTAL][4];
+static vec2_t v_testPartCoords[PT_PICTOTAL][4];
+static vec3_t v_testPartVertices[PT_PICTOTAL][4];
 static void V_TestParticles ()
 {
 	int				i;
 	float			d, r, u;
 	vec3_t			origin;
 	float			scale;
-	cgParticle_t	*p;
+	refPoly_t		*p;
 
 	cgi.R_ClearScene ();
 	scale = 1;
 
-	for (p=&v_testParticleList[0], i=0 ; i<PT_PICTOTAL ; i++, p++) {
+	for (p=&v_testPartPolys[0], i=0 ; i<PT_PICTOTAL ; i++, p++) {
 		d = i*0.5f;
 		r = 3*((i&7)-3.5f);
 		u = 3*(((i>>3)&7)-3.5f);
@@ -167,42 +170,42 @@ static void V_TestParticles ()
 		origin[2] = cg.refDef.viewOrigin[2] + cg.refDef.viewAxis[0][2]*d - cg.refDef.viewAxis[1][2]*r + cg.refDef.viewAxis[2][2]*u;
 
 		// Top left
-		v_testParticleList[i].outColor[0] = Q_BColorWhite;
-		Vec2Set (v_testParticleList[i].outCoords[0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
-		Vec3Set (v_testParticleList[i].outVertices[0],	origin[0] + cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
+		v_testPartColors[i][0] = Q_BColorWhite;
+		Vec2Set (v_testPartCoords[i][0], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][1]);
+		Vec3Set (v_testPartVertices[i][0],	origin[0] + cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
 														origin[1] + cg.refDef.viewAxis[2][1]*scale + cg.refDef.viewAxis[1][1]*scale,
 														origin[2] + cg.refDef.viewAxis[2][2]*scale + cg.refDef.viewAxis[1][2]*scale);
 
 		// Bottom left
-		v_testParticleList[i].outColor[1] = Q_BColorWhite;
-		Vec2Set (v_testParticleList[i].outCoords[1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
-		Vec3Set (v_testParticleList[i].outVertices[1],	origin[0] - cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
+		v_testPartColors[i][1] = Q_BColorWhite;
+		Vec2Set (v_testPartCoords[i][1], cgMedia.particleCoords[type][0], cgMedia.particleCoords[type][3]);
+		Vec3Set (v_testPartVertices[i][1],	origin[0] - cg.refDef.viewAxis[2][0]*scale + cg.refDef.viewAxis[1][0]*scale,
 														origin[1] - cg.refDef.viewAxis[2][1]*scale + cg.refDef.viewAxis[1][1]*scale,
 														origin[2] - cg.refDef.viewAxis[2][2]*scale + cg.refDef.viewAxis[1][2]*scale);
 
 		// Bottom right
-		v_testParticleList[i].outColor[2] = Q_BColorWhite;
-		Vec2Set (v_testParticleList[i].outCoords[2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
-		Vec3Set (v_testParticleList[i].outVertices[2],	origin[0] - cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
+		v_testPartColors[i][2] = Q_BColorWhite;
+		Vec2Set (v_testPartCoords[i][2], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][3]);
+		Vec3Set (v_testPartVertices[i][2],	origin[0] - cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
 														origin[1] - cg.refDef.viewAxis[2][1]*scale - cg.refDef.viewAxis[1][1]*scale,
 														origin[2] - cg.refDef.viewAxis[2][2]*scale - cg.refDef.viewAxis[1][2]*scale);
 
 		// Top right
-		v_testParticleList[i].outColor[3] = Q_BColorWhite;
-		Vec2Set (v_testParticleList[i].outCoords[3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
-		Vec3Set (v_testParticleList[i].outVertices[3],	origin[0] + cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
+		v_testPartColors[i][3] = Q_BColorWhite;
+		Vec2Set (v_testPartCoords[i][3], cgMedia.particleCoords[type][2], cgMedia.particleCoords[type][1]);
+		Vec3Set (v_testPartVertices[i][3],	origin[0] + cg.refDef.viewAxis[2][0]*scale - cg.refDef.viewAxis[1][0]*scale,
 														origin[1] + cg.refDef.viewAxis[2][1]*scale - cg.refDef.viewAxis[1][1]*scale,
 														origin[2] + cg.refDef.viewAxis[2][2]*scale - cg.refDef.viewAxis[1][2]*scale);
 
 		// Render it
-		p->outPoly.numVerts = 4;
-		p->outPoly.colors = v_testParticleList[i].outColor;
-		p->outPoly.texCoords = v_testParticleList[i].outCoords;
-		p->outPoly.vertices = v_testParticleList[i].outVertices;
-		p->outPoly.mat = cgMedia.particleTable[type];
-		p->outPoly.matTime = 0;
-
-		cgi.R_AddPoly (&p->outPoly);
+		p->numVerts = 4;
+		p->colors = v_testPartColors[i];
+		p->texCoords = v_testPartCoords[i];
+		p->vertices = v_testPartVertices[i];
+		p->mat = cgMedia.particleTable[type];
+		p->matTime = 0;
+
+		cgi.R_AddPoly (p);
 	}
 }
 
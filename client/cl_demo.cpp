@@ -457,3 +457,195 @@ void CL_StopDemoRecording ()
 	cls.demoFile = 0;
 	cls.demoRecording = false;
 }
+
+/*
+==============================================================================
+
+	DEMO BENCHMARK
+
+	Plays a demo file straight through the parser, cgame and the refresh front
+	end as fast as possible, with one refresh per server frame on a fixed clock.
+	The refresh runs with a null backend, so mesh lists are built and sorted but
+	nothing is handed to GL, and the numbers are the client's own CPU work.
+==============================================================================
+*/
+
+enum
+{
+	BENCH_PARSE,
+	BENCH_LOAD,
+	BENCH_VIEW,
+
+	BENCH_MAX
+};
+
+struct benchStage_t
+{
+	double			ms;
+	uint32			numAllocs;
+	uint64			allocBytes;
+
+	uint32			startCycles;
+	memCounters_t	startMem;
+};
+
+static const char	*cl_benchStageNames[BENCH_MAX] = {
+	"parse",
+	"load",
+	"view"
+};
+
+static benchStage_t	cl_benchStages[BENCH_MAX];
+static byte			*cl_benchBuffer;
+static bool			cl_benchTimeDemo;
+
+static inline void CL_BenchBegin (benchStage_t *stage)
+{
+	stage->startMem = com_memCounters;
+	stage->startCycles = Sys_Cycles ();
+}
+
+static inline void CL_BenchEnd (benchStage_t *stage)
+{
+	stage->ms += (Sys_Cycles () - stage->startCycles) * Sys_MSPerCycle ();
+	stage->numAllocs += com_memCounters.numAllocs - stage->startMem.numAllocs;
+	stage->allocBytes += com_memCounters.allocBytes - stage->startMem.allocBytes;
+}
+
+
+/*
+====================
+CL_StopDemoBenchmark
+
+Also called from CL_Disconnect if the demo errors out part way.
+====================
+*/
+void CL_StopDemoBenchmark ()
+{
+	if (cl_benchBuffer) {
+		FS_FreeFile (cl_benchBuffer);
+		cl_benchBuffer = NULL;
+	}
+
+	// The refresh dump breaks the view stage down further
+	if (cl_benchTimeDemo) {
+		R_EndTimeDemo ();
+		cl_benchTimeDemo = false;
+	}
+
+	R_SetNullBackend (false);
+	cls.demoBenchmark = false;
+}
+
+
+/*
+====================
+CL_BenchDemo_f
+====================
+*/
+void CL_BenchDemo_f ()
+{
+	char	name[MAX_QPATH];
+
+	if (Cmd_Argc () != 2) {
+		Com_Printf (0, "Usage: benchdemo <demoname>\n");
+		return;
+	}
+
+	if (Com_ServerState () || Com_ClientState () != CA_DISCONNECTED) {
+		Com_Printf (PRNT_WARNING, "benchdemo: disconnect first\n");
+		return;
+	}
+
+	Q_snprintfz (name, sizeof(name), "demos/%s", Cmd_Argv (1));
+	Com_DefaultExtension (name, ".dm2", sizeof(name));
+
+	const int fileLen = FS_LoadFile (name, (void **)&cl_benchBuffer, false);
+	if (!cl_benchBuffer) {
+		Com_Printf (PRNT_WARNING, "benchdemo: couldn't open %s\n", name);
+		return;
+	}
+
+	memset (cl_benchStages, 0, sizeof(cl_benchStages));
+	cls.demoBenchmark = true;
+	R_SetNullBackend (true);
+
+	// Fixed clock so that runs are comparable
+	double benchTime = Sys_Milliseconds ();
+	cls.realTime = (int)benchTime;
+	cls.netFrameTime = cls.trueNetFrameTime = ServerFrameTime * 0.001f;
+	cls.refreshFrameTime = cls.trueRefreshFrameTime = ServerFrameTime * 0.001f;
+
+	int numMessages = 0;
+	int numFrames = 0;
+	const int startTime = Sys_Milliseconds ();
+
+	for (int offset=0 ; offset+(int)sizeof(int)<=fileLen ; ) {
+		const int msgLen = LittleLong (*(int *)(cl_benchBuffer + offset));
+		offset += sizeof(int);
+		if (msgLen == -1)
+			break;	// End of demo
+
+		if (msgLen < 0 || msgLen > (int)sizeof(cls.netBuffer) || offset+msgLen > fileLen) {
+			Com_Printf (PRNT_WARNING, "benchdemo: bad message length %i at offset %i\n", msgLen, offset);
+			break;
+		}
+
+		memcpy (cls.netBuffer, cl_benchBuffer + offset, msgLen);
+		cls.netMessage.curSize = msgLen;
+		cls.netMessage.readCount = 0;
+		offset += msgLen;
+		numMessages++;
+
+		const int oldFrame = cl.frame.serverFrame;
+
+		CL_BenchBegin (&cl_benchStages[BENCH_PARSE]);
+		CL_ParseServerMessage ();
+		CL_BenchEnd (&cl_benchStages[BENCH_PARSE]);
+
+		// Stuffed "precache" loads the map
+		CL_BenchBegin (&cl_benchStages[BENCH_LOAD]);
+		Cbuf_Execute ();
+		CL_BenchEnd (&cl_benchStages[BENCH_LOAD]);
+
+		if (Com_ClientState () != CA_ACTIVE || !cl.frame.valid || cl.frame.serverFrame == oldFrame)
+			continue;
+
+		if (!cl_benchTimeDemo) {
+			R_BeginTimeDemo ();
+			cl_benchTimeDemo = true;
+		}
+
+		// One refresh per server frame
+		CL_BenchBegin (&cl_benchStages[BENCH_VIEW]);
+		R_TimeDemoFrame ();
+		R_BeginFrame (0);
+		CL_CGModule_RenderView (0);
+		R_EndFrame ();
+		CL_BenchEnd (&cl_benchStages[BENCH_VIEW]);
+		numFrames++;
+
+		benchTime += ServerFrameTime;
+		cls.realTime = (int)benchTime;
+	}
+
+	const float invFrames = numFrames ? 1.0f / (float)numFrames : 0.0f;
+
+	Com_Printf (0, "Client benchmark of %s:\n", name);
+	Com_Printf (0, "...%i messages, %i frames in %ims\n", numMessages, numFrames, Sys_Milliseconds () - startTime);
+	Com_Printf (0, "Stage times and allocations (total/per frame):\n");
+	for (int i=0 ; i<BENCH_MAX ; i++) {
+		const benchStage_t *stage = &cl_benchStages[i];
+
+		Com_Printf (0, "...%-5s %8.2fms/%6.3fms %8u/%6.1f allocs %8uKB\n",
+			cl_benchStageNames[i],
+			stage->ms, stage->ms * invFrames,
+			stage->numAllocs, stage->numAllocs * invFrames,
+			(uint32)(stage->allocBytes / 1024));
+	}
+
+	// Tear down locally, there's no server to tell
+	CL_StopDemoBenchmark ();
+	CL_SetState (CA_DISCONNECTED);
+	CL_Disconnect (true);
+}
@@ -189,12 +189,15 @@ struct clientStatic_t {
 
 	downloadStatic_t	download;
 
+	struct fsZStream_t	*zPacketStream;				// inflate state kept across SVC_ZPACKETs
+
 	//
 	// demo recording info must be here, so it isn't cleared on level change
 	//
 	fileHandle_t		demoFile;
 	bool				demoRecording;
 	bool				demoWaiting;				// don't record until a non-delta message is received
+	bool				demoBenchmark;				// benchdemo is feeding the parser directly
 
 	//
 	// cgame information
@@ -348,6 +351,9 @@ void		CL_WriteDemoMessageFull ();
 bool		CL_StartDemoRecording (char *name);
 void		CL_StopDemoRecording ();
 
+void		CL_StopDemoBenchmark ();
+void		CL_BenchDemo_f ();
+
 //
 // cl_console.c
 //
@@ -357,6 +357,11 @@ void CL_Disconnect (bool openMenu)
 	}
 
 done:
+	if (cls.demoBenchmark)
+		CL_StopDemoBenchmark ();
+
+	FS_ZLibFreeStream (&cls.zPacketStream);
+
 	CM_UnloadMap ();
 	CL_MediaRestart ();
 
@@ -1720,6 +1725,7 @@ static void CL_Register ()
 
 	scr_conspeed			= Cvar_Register ("scr_conspeed",			"3",		0);
 
+	Cmd_AddCommand ("benchdemo",		0, CL_BenchDemo_f,			"Plays a demo without drawing and reports client timings");
 	Cmd_AddCommand ("changing",			0, CL_Changing_f,			"");
 	Cmd_AddCommand ("connect",			0, CL_Connect_f,			"Connects to a server");
 	Cmd_AddCommand ("cmd",				0, CL_ForwardToServer_f,	"Forwards a command to the server");
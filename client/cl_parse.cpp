@@ -942,12 +942,14 @@ static void CL_ParseStartSoundPacket ()
 /*
 =====================
 CL_ParseZPacket
+
+Inflates straight out of the net message into a fixed buffer, reusing the
+connection's inflate state, so nothing is allocated per packet.
 =====================
 */
 void CL_ParseZPacket ()
 {
-	byte		*buff_in;
-	byte		*buff_out;
+	static byte	buff_out[32768];	// uncompressedLen is a positive short
 	netMsg_t	sb, old;
 	sint16		compressedLen;
 	sint16		uncompressedLen;
@@ -963,13 +965,18 @@ void CL_ParseZPacket ()
 	if (compressedLen <= 0)
 		Com_Error (ERR_DROP, "CL_ParseZPacket: compressedLen <= 0");
 
-	buff_in = (byte*)Mem_Alloc (compressedLen);
-	buff_out = (byte*)Mem_Alloc (uncompressedLen);
+	if (cls.netMessage.readCount + compressedLen > cls.netMessage.curSize)
+		Com_Error (ERR_DROP, "CL_ParseZPacket: compressedLen runs past the message");
+	if (cls.netMessage.data == buff_out)
+		Com_Error (ERR_DROP, "CL_ParseZPacket: nested SVC_ZPACKET");
 
-	cls.netMessage.ReadData (buff_in, compressedLen);
+	byte *buff_in = cls.netMessage.data + cls.netMessage.readCount;
+	cls.netMessage.readCount += compressedLen;
 
 	sb.Init(buff_out, uncompressedLen);
-	sb.curSize = FS_ZLibDecompress (buff_in, compressedLen, buff_out, uncompressedLen, -15);
+	sb.curSize = FS_ZLibDecompressStream (&cls.zPacketStream, buff_in, compressedLen, buff_out, uncompressedLen, -15);
+	if (sb.curSize <= 0)
+		Com_Error (ERR_DROP, "CL_ParseZPacket: bad compressed data");
 
 	old = cls.netMessage;
 	cls.netMessage = sb;
@@ -978,9 +985,6 @@ void CL_ParseZPacket ()
 
 	cls.netMessage = old;
 
-	Mem_Free (buff_in);
-	Mem_Free (buff_out);
-
 	Com_DevPrintf (0, "Got a ZPacket, %d->%d\n", uncompressedLen + 4, compressedLen);
 }
 
@@ -54,6 +54,23 @@ int						snd_dmaPaintedTime;	// sample PAIRS
 static vec3_t			snd_dmaOrigin;
 static vec3_t			snd_dmaRightVec;
 
+// Spatialization requests, filled and resolved in one batch
+struct sndSpatial_t {
+	vec3_t			origin;
+	float			masterVol;
+	float			distMult;
+	int				leftVol;
+	int				rightVol;
+};
+
+#define MAX_SPATIALIZE	(MAX_CHANNELS+MAX_PARSE_ENTITIES)
+static sndSpatial_t		snd_dmaSpatial[MAX_SPATIALIZE];
+static int				snd_dmaSpatialChannels[MAX_CHANNELS];
+static int				snd_dmaLoopEntities[MAX_PARSE_ENTITIES];
+
+// Forces the scalar mixing kernels, used by the mixer benchmark
+static bool				snd_dmaScalarMix;
+
 /*
 ================
 DMASnd_ScaleTableInit
@@ -86,67 +103,124 @@ static void DMASnd_ScaleTableInit (float volume)
 
 /*
 =================
-DMASnd_SpatializeOrigin
+DMASnd_SpatializeBatch
 
-Used for spatializing channels and autosounds
+Used for spatializing channels and autosounds. Distance and stereo separation
+are worked out SIMD_WIDTH requests at a time, the occlusion trace is per request.
 =================
 */
-static void DMASnd_SpatializeOrigin (vec3_t origin, float masterVol, float distMult, int &leftVol, int &rightVol)
+static void DMASnd_SpatializeBatch (sndSpatial_t *list, const int count)
 {
-	float		dot, dist;
-	float		leftScale, rightScale, scale;
-	vec3_t		sourceVec;
-
 	if (Com_ClientState () != CA_ACTIVE)
 	{
-		leftVol = 255;
-		rightVol = 255;
+		for (int i=0 ; i<count ; i++)
+		{
+			list[i].leftVol = 255;
+			list[i].rightVol = 255;
+		}
 		return;
 	}
 
-	// Calculate stereo seperation and distance attenuation
-	Vec3Subtract (origin, snd_dmaOrigin, sourceVec);
+	// No stereo seperation on a mono device
+	const simdVec_t monoMask = Simd_CmpGT(Simd_Splat(snd_audioDMA.channels == 1 ? 1.0f : 0.0f), Simd_Zero());
 
-	dist = VectorNormalizef (sourceVec, sourceVec) - SOUND_FULLVOLUME;
-	if (dist < 0)
-		dist = 0;			// close enough to be at full volume
-	dist *= distMult;		// different attenuation levels
-	
-	dot = DotProduct (snd_dmaRightVec, sourceVec);
+	const simdVec_t viewX = Simd_Splat(snd_dmaOrigin[0]), viewY = Simd_Splat(snd_dmaOrigin[1]), viewZ = Simd_Splat(snd_dmaOrigin[2]);
+	const simdVec_t rightX = Simd_Splat(snd_dmaRightVec[0]), rightY = Simd_Splat(snd_dmaRightVec[1]), rightZ = Simd_Splat(snd_dmaRightVec[2]);
+	const simdVec_t zero = Simd_Zero();
+	const simdVec_t half = Simd_Splat(0.5f);
+	const simdVec_t one = Simd_Splat(1.0f);
+	const simdVec_t fullVolume = Simd_Splat(SOUND_FULLVOLUME);
+	const simdVec_t minLength = Simd_Splat(TINY_NUMBER);
 
-	if (snd_audioDMA.channels == 1 || !distMult)
+	for (int i=0 ; i<count ; i+=SIMD_WIDTH)
 	{
+		const int num = min(count - i, SIMD_WIDTH);
+		float x[SIMD_WIDTH], y[SIMD_WIDTH], z[SIMD_WIDTH];
+		float masterVol[SIMD_WIDTH], distMult[SIMD_WIDTH];
+		float leftOut[SIMD_WIDTH], rightOut[SIMD_WIDTH];
+
+		for (int j=0 ; j<SIMD_WIDTH ; j++)
+		{
+			if (j < num)
+			{
+				x[j] = list[i+j].origin[0];
+				y[j] = list[i+j].origin[1];
+				z[j] = list[i+j].origin[2];
+				masterVol[j] = list[i+j].masterVol;
+				distMult[j] = list[i+j].distMult;
+			}
+			else
+			{
+				x[j] = y[j] = z[j] = 0;
+				masterVol[j] = distMult[j] = 0;
+			}
+		}
+
+		// Calculate stereo seperation and distance attenuation
+		const simdVec_t dx = Simd_Sub(Simd_Load(x), viewX);
+		const simdVec_t dy = Simd_Sub(Simd_Load(y), viewY);
+		const simdVec_t dz = Simd_Sub(Simd_Load(z), viewZ);
+		const simdVec_t length = Simd_Sqrt(Simd_Madd(dx, dx, Simd_Madd(dy, dy, Simd_Mul(dz, dz))));
+
+		// A source at the listener has no direction, so the dot product is 0 there
+		const simdVec_t dot = Simd_Div(Simd_Madd(rightX, dx, Simd_Madd(rightY, dy, Simd_Mul(rightZ, dz))), Simd_Max(length, minLength));
+
+		// Close enough to be at full volume, then different attenuation levels
+		const simdVec_t mult = Simd_Load(distMult);
+		const simdVec_t dist = Simd_Mul(Simd_Max(Simd_Sub(length, fullVolume), zero), mult);
+
 		// No attenuation = no spatialization
-		rightScale = 1.0f;
-		leftScale = 1.0f;
-	}
-	else
-	{
-		rightScale = 0.5f * (1.0f + dot);
-		leftScale = 0.5f * (1.0f - dot);
-	}
+		const simdVec_t flatMask = Simd_Or(monoMask, Simd_CmpLE(mult, zero));
+		const simdVec_t rightScale = Simd_Select(flatMask, one, Simd_Mul(half, Simd_Add(one, dot)));
+		const simdVec_t leftScale = Simd_Select(flatMask, one, Simd_Mul(half, Simd_Sub(one, dot)));
 
-	// Add in distance effect
-	scale = (1.0 - dist) * rightScale;
-	rightVol = Q_rint (masterVol * scale);
+		// Add in distance effect
+		const simdVec_t volume = Simd_Mul(Simd_Load(masterVol), Simd_Sub(one, dist));
+		Simd_Store(rightOut, Simd_Mul(volume, rightScale));
+		Simd_Store(leftOut, Simd_Mul(volume, leftScale));
 
-	scale = (1.0 - dist) * leftScale;
-	leftVol = Q_rint (masterVol * scale);
+		for (int j=0 ; j<num ; j++)
+		{
+			sndSpatial_t *sp = &list[i+j];
+			sp->rightVol = Q_rint (rightOut[j]);
+			sp->leftVol = Q_rint (leftOut[j]);
 
-	// Add in an occlusion effect
-	cmTrace_t tr = CM_Trace(origin, snd_dmaOrigin, 1, CONTENTS_SOLID);
-	if (tr.fraction < 1.0f)
-	{
-		scale = 0.5f + (0.25f * tr.fraction);
-		rightVol = Q_rint(rightVol * scale);
-		leftVol = Q_rint(leftVol * scale);
+			// Add in an occlusion effect
+			cmTrace_t tr = CM_Trace(sp->origin, snd_dmaOrigin, 1, CONTENTS_SOLID);
+			if (tr.fraction < 1.0f)
+			{
+				const float scale = 0.5f + (0.25f * tr.fraction);
+				sp->rightVol = Q_rint(sp->rightVol * scale);
+				sp->leftVol = Q_rint(sp->leftVol * scale);
+			}
+
+			// Clamp outputs
+			if (sp->rightVol < 0)
+				sp->rightVol = 0;
+			if (sp->leftVol < 0)
+				sp->leftVol = 0;
+		}
 	}
+}
 
-	// Clamp outputs
-	if (rightVol < 0)
-		rightVol = 0;
-	if (leftVol < 0)
-		leftVol = 0;
+
+/*
+=================
+DMASnd_SpatializeOrigin
+=================
+*/
+static void DMASnd_SpatializeOrigin (vec3_t origin, float masterVol, float distMult, int &leftVol, int &rightVol)
+{
+	sndSpatial_t	sp;
+
+	Vec3Copy (origin, sp.origin);
+	sp.masterVol = masterVol;
+	sp.distMult = distMult;
+
+	DMASnd_SpatializeBatch (&sp, 1);
+
+	leftVol = sp.leftVol;
+	rightVol = sp.rightVol;
 }
 
 
@@ -359,61 +433,70 @@ started, stopped, and merged together as the entities are sent to the client
 */
 static void DMASnd_AddLoopSounds ()
 {
-	int				left, right;
 	int				leftTotal, rightTotal;
 	channel_t		*ch;
 	sfx_t			*sfx;
 	sfxCache_t		*sc;
 	entityState_t	*ent;
-	vec3_t			origin, velocity;
+	vec3_t			velocity;
 	bool			bDone[MAX_PARSE_ENTITIES];
 
 	if (cl_paused->intVal || Com_ClientState () != CA_ACTIVE || !cls.soundPrepped)
 		return;
 
-	memset(&bDone, false, sizeof(bool)*MAX_PARSE_ENTITIES);
-
-	// Add sounds
+	// Gather every audible entity and spatialize them all at once
+	int numLoops = 0;
 	for (int i=0 ; i<cl.frame.numEntities ; i++)
 	{
 		int entIdx = (cl.frame.parseEntities + i)&(MAX_PARSEENTITIES_MASK);
 		ent = &cl_parseEntities[entIdx];
-		if (!ent->sound || bDone[entIdx])
+		if (!ent->sound)
 			continue;
 
 		if (!cl.soundCfgStrings[ent->sound] && cl.configStrings[CS_SOUNDS+ent->sound][0])
 			cl.soundCfgStrings[ent->sound] = Snd_RegisterSound (cl.configStrings[CS_SOUNDS+ent->sound]);
 
 		sfx = cl.soundCfgStrings[ent->sound];
-		if (!sfx)
+		if (!sfx || !sfx->cache)
 			continue;	// Bad sound effect
 
-		sc = sfx->cache;
-		if (!sc)
+		sndSpatial_t *sp = &snd_dmaSpatial[numLoops];
+		CL_CGModule_GetEntitySoundOrigin (ent->number, sp->origin, velocity);
+		sp->masterVol = 255.0f;
+		sp->distMult = SOUND_LOOPATTENUATE;
+
+		snd_dmaLoopEntities[numLoops] = entIdx;
+		bDone[numLoops] = false;
+		numLoops++;
+	}
+
+	DMASnd_SpatializeBatch (snd_dmaSpatial, numLoops);
+
+	// Add sounds
+	for (int i=0 ; i<numLoops ; i++)
+	{
+		if (bDone[i])
 			continue;
 
-		// Get the entity sound origin
-		CL_CGModule_GetEntitySoundOrigin (ent->number, origin, velocity);
+		ent = &cl_parseEntities[snd_dmaLoopEntities[i]];
+		sfx = cl.soundCfgStrings[ent->sound];
+		sc = sfx->cache;
 
 		// Find the total contribution of all sounds of this type
-		DMASnd_SpatializeOrigin (origin, 255.0f, SOUND_LOOPATTENUATE, leftTotal, rightTotal);
-		bDone[entIdx] = true;
+		leftTotal = snd_dmaSpatial[i].leftVol;
+		rightTotal = snd_dmaSpatial[i].rightVol;
+		bDone[i] = true;
 
 		int NumCombined = 1;
-		for (int j=i+1 ; j<cl.frame.numEntities ; j++)
+		for (int j=i+1 ; j<numLoops ; j++)
 		{
-			int otherIdx = (cl.frame.parseEntities + j)&(MAX_PARSEENTITIES_MASK);
-			entityState_t *other = &cl_parseEntities[otherIdx];
-
-			if (other->sound != ent->sound || bDone[otherIdx])
+			if (bDone[j] || cl_parseEntities[snd_dmaLoopEntities[j]].sound != ent->sound)
 				continue;
 
-			CL_CGModule_GetEntitySoundOrigin (other->number, origin, velocity);
-			DMASnd_SpatializeOrigin (origin, 255.0f, SOUND_LOOPATTENUATE, left, right);
-			bDone[otherIdx] = true;
+			bDone[j] = true;
 
-			leftTotal += left;
-			rightTotal += right;
+			leftTotal += snd_dmaSpatial[j].leftVol;
+			rightTotal += snd_dmaSpatial[j].rightVol;
 			NumCombined++;
 		}
 
@@ -449,6 +532,148 @@ static void DMASnd_AddLoopSounds ()
 }
 
 
+/*
+================
+DMASnd_MixSamples8
+
+Adds count mono 8 bit samples into the paint buffer. The scale tables hold
+sample * scale, so the vector path multiplies by table[1] directly. The scale
+is split into its high and low bytes to keep every product within 16 bits.
+================
+*/
+static void DMASnd_MixSamples8 (sfxSamplePair_t *out, const byte *in, const int count, const int *lScale, const int *rScale)
+{
+	int		i = 0;
+
+#ifdef HAVE_SSE2
+	if (!snd_dmaScalarMix && lScale[1] >= 0 && lScale[1] <= 0xFFFF && rScale[1] >= 0 && rScale[1] <= 0xFFFF)
+	{
+		const __m128i scaleHi = _mm_set1_epi32(((rScale[1] >> 8) << 16) | (lScale[1] >> 8));
+		const __m128i scaleLo = _mm_set1_epi32(((rScale[1] & 0xFF) << 16) | (lScale[1] & 0xFF));
+
+		for ( ; i+8<=count ; i+=8)
+		{
+			// Sign extend to 16 bits, then duplicate each sample for left/right
+			const __m128i bytes = _mm_loadl_epi64((const __m128i *)(in + i));
+			const __m128i words = _mm_srai_epi16(_mm_unpacklo_epi8(bytes, bytes), 8);
+			const __m128i pairs[2] = { _mm_unpacklo_epi16(words, words), _mm_unpackhi_epi16(words, words) };
+
+			for (int j=0 ; j<2 ; j++)
+			{
+				const __m128i hi = _mm_mullo_epi16(pairs[j], scaleHi);
+				const __m128i lo = _mm_mullo_epi16(pairs[j], scaleLo);
+
+				for (int k=0 ; k<2 ; k++)
+				{
+					const __m128i hi32 = _mm_srai_epi32(k ? _mm_unpackhi_epi16(hi, hi) : _mm_unpacklo_epi16(hi, hi), 16);
+					const __m128i lo32 = _mm_srai_epi32(k ? _mm_unpackhi_epi16(lo, lo) : _mm_unpacklo_epi16(lo, lo), 16);
+
+					__m128i *dst = (__m128i *)&out[i + j*4 + k*2];
+					_mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), _mm_add_epi32(_mm_slli_epi32(hi32, 8), lo32)));
+				}
+			}
+		}
+	}
+#endif // HAVE_SSE2
+
+	for ( ; i<count ; i++)
+	{
+		out[i].left += lScale[in[i]];
+		out[i].right += rScale[in[i]];
+	}
+}
+
+
+/*
+================
+DMASnd_MixSamples16
+
+Adds (sample * volume) >> 8 for count mono 16 bit samples into the paint buffer.
+The volume is split into (hi << 8) + lo, which gives the same result as the
+scalar path as sample * hi + ((sample * lo) >> 8) using only 16 bit multiplies.
+================
+*/
+static void DMASnd_MixSamples16 (sfxSamplePair_t *out, const sint16 *in, const int count, const int leftVol, const int rightVol)
+{
+	int		i = 0;
+
+#ifdef HAVE_SSE2
+	if (!snd_dmaScalarMix && leftVol >= 0 && leftVol <= 0xFFFF && rightVol >= 0 && rightVol <= 0xFFFF)
+	{
+		const __m128i volHi = _mm_set1_epi32(((rightVol >> 8) << 16) | (leftVol >> 8));
+		const __m128i volLo = _mm_set1_epi32(((rightVol & 0xFF) << 16) | (leftVol & 0xFF));
+
+		for ( ; i+8<=count ; i+=8)
+		{
+			// Duplicate each sample for left/right
+			const __m128i words = _mm_loadu_si128((const __m128i *)(in + i));
+			const __m128i pairs[2] = { _mm_unpacklo_epi16(words, words), _mm_unpackhi_epi16(words, words) };
+
+			for (int j=0 ; j<2 ; j++)
+			{
+				// Full 32 bit products from the low and high halves
+				const __m128i hiLow = _mm_mullo_epi16(pairs[j], volHi);
+				const __m128i hiHigh = _mm_mulhi_epi16(pairs[j], volHi);
+				const __m128i loLow = _mm_mullo_epi16(pairs[j], volLo);
+				const __m128i loHigh = _mm_mulhi_epi16(pairs[j], volLo);
+
+				for (int k=0 ; k<2 ; k++)
+				{
+					const __m128i hi32 = k ? _mm_unpackhi_epi16(hiLow, hiHigh) : _mm_unpacklo_epi16(hiLow, hiHigh);
+					const __m128i lo32 = k ? _mm_unpackhi_epi16(loLow, loHigh) : _mm_unpacklo_epi16(loLow, loHigh);
+
+					__m128i *dst = (__m128i *)&out[i + j*4 + k*2];
+					_mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), _mm_add_epi32(hi32, _mm_srai_epi32(lo32, 8))));
+				}
+			}
+		}
+	}
+#endif // HAVE_SSE2
+
+	for ( ; i<count ; i++)
+	{
+		out[i].left += (in[i] * leftVol)>>8;
+		out[i].right += (in[i] * rightVol)>>8;
+	}
+}
+
+
+/*
+================
+DMASnd_ClipSamples16
+
+Shifts mixed samples down to 16 bits with saturation.
+================
+*/
+static void DMASnd_ClipSamples16 (sint16 *out, const int *in, const int count)
+{
+	int		i = 0;
+
+#ifdef HAVE_SSE2
+	if (!snd_dmaScalarMix)
+	{
+		for ( ; i+8<=count ; i+=8)
+		{
+			const __m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(in + i)), 8);
+			const __m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(in + i + 4)), 8);
+			_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(a, b));
+		}
+	}
+#endif // HAVE_SSE2
+
+	for ( ; i<count ; i++)
+	{
+		const int val = in[i]>>8;
+		if (val > 0x7fff)
+			out[i] = 0x7fff;
+		else if (val < (sint16)0x8000)
+			out[i] = (sint16)0x8000;
+		else
+			out[i] = val;
+	}
+}
+
+
 /*
 ================
 DMASnd_PaintChannelFrom8
@@ -456,12 +681,6 @@ DMASnd_PaintChannelFrom8
 */
 static void DMASnd_PaintChannelFrom8 (channel_t *ch, sfxCache_t *sc, int count, int offset)
 {
-	int		data;
-	int		*lScale, *rScale;
-	byte	*sfx;
-	int		i;
-	sfxSamplePair_t	*samp;
-
 	// Clamp
 	if (ch->leftVol > 255)
 		ch->leftVol = 255;
@@ -469,16 +688,7 @@ static void DMASnd_PaintChannelFrom8 (channel_t *ch, sfxCache_t *sc, int count,
 		ch->rightVol = 255;
 
 	// Left/right scale
-	lScale = snd_dmaScaleTable[ch->leftVol >> 3];
-	rScale = snd_dmaScaleTable[ch->rightVol >> 3];
-	sfx = (byte *)sc->data + ch->position;
-
-	samp = &snd_dmaPaintBuffer[offset];
-	for (i=0 ; i<count ; i++, samp++) {
-		data = sfx[i];
-		samp->left += lScale[data];
-		samp->right += rScale[data];
-	}
+	DMASnd_MixSamples8 (&snd_dmaPaintBuffer[offset], (byte *)sc->data + ch->position, count, snd_dmaScaleTable[ch->leftVol >> 3], snd_dmaScaleTable[ch->rightVol >> 3]);
 	
 	ch->position += count;
 }
@@ -491,24 +701,10 @@ DMASnd_PaintChannelFrom16
 */
 static void DMASnd_PaintChannelFrom16 (channel_t *ch, sfxCache_t *sc, int count, int offset, float volume)
 {
-	int				data, i;
-	int				left, right;
-	int				leftVol, rightVol;
-	signed short	*sfx;
-	sfxSamplePair_t	*samp;
+	const int leftVol = ch->leftVol * volume * 256;
+	const int rightVol = ch->rightVol * volume * 256;
 
-	leftVol = ch->leftVol * volume * 256;
-	rightVol = ch->rightVol * volume * 256;
-	sfx = (signed short *)sc->data + ch->position;
-
-	samp = &snd_dmaPaintBuffer[offset];
-	for (i=0 ; i<count ; i++, samp++) {
-		data = sfx[i];
-		left = (data * leftVol)>>8;
-		right = (data * rightVol)>>8;
-		samp->left += left;
-		samp->right += right;
-	}
+	DMASnd_MixSamples16 (&snd_dmaPaintBuffer[offset], (sint16 *)sc->data + ch->position, count, leftVol, rightVol);
 
 	ch->position += count;
 }
@@ -555,23 +751,7 @@ static void DMASnd_TransferPaintBuffer (int endTime)
 			snd_dmaLinearCount <<= 1;
 
 			// Write a linear blast of samples
-			for (i=0 ; i<snd_dmaLinearCount ; i+=2) {
-				val = snd_dmaMixPointer[i]>>8;
-				if (val > 0x7fff)
-					snd_dmaBufferOutput[i] = 0x7fff;
-				else if (val < (sint16)0x8000)
-					snd_dmaBufferOutput[i] = (sint16)0x8000;
-				else
-					snd_dmaBufferOutput[i] = val;
-
-				val = snd_dmaMixPointer[i+1]>>8;
-				if (val > 0x7fff)
-					snd_dmaBufferOutput[i+1] = 0x7fff;
-				else if (val < (sint16)0x8000)
-					snd_dmaBufferOutput[i+1] = (sint16)0x8000;
-				else
-					snd_dmaBufferOutput[i+1] = val;
-			}
+			DMASnd_ClipSamples16 (snd_dmaBufferOutput, snd_dmaMixPointer, snd_dmaLinearCount);
 
 			snd_dmaMixPointer += snd_dmaLinearCount;
 			paintedTime += (snd_dmaLinearCount>>1);
@@ -624,14 +804,73 @@ static void DMASnd_TransferPaintBuffer (int endTime)
 
 /*
 ================
-DMASnd_PaintChannels
+DMASnd_MixChannels
+
+Paints every active channel from snd_dmaPaintedTime up to endTime.
 ================
 */
-static void DMASnd_PaintChannels (int endTime, float volume)
+static void DMASnd_MixChannels (int endTime, float volume)
 {
 	channel_t	*ch;
 	sfxCache_t	*sc;
 	int			lTime, count;
+	int			i;
+
+	for (i=0, ch=snd_dmaOutChannels ; i<MAX_CHANNELS ; ch++, i++) {
+		lTime = snd_dmaPaintedTime;
+	
+		while (lTime < endTime) {
+			if (!ch->sfx || (!ch->leftVol && !ch->rightVol))
+				break;
+
+			// Max painting is to the end of the buffer
+			count = endTime - lTime;
+
+			// Might be stopped by running out of data
+			if (ch->endTime - lTime < count)
+				count = ch->endTime - lTime;
+	
+			sc = Snd_LoadSound (ch->sfx);
+			if (!sc)
+				break;
+
+			if (count > 0 && ch->sfx) {	
+				if (sc->width == 1)
+					DMASnd_PaintChannelFrom8 (ch, sc, count, lTime - snd_dmaPaintedTime);
+				else
+					DMASnd_PaintChannelFrom16 (ch, sc, count, lTime - snd_dmaPaintedTime, volume);
+
+				lTime += count;
+			}
+
+			// If at end of loop, restart
+			if (lTime >= ch->endTime) {
+				if (ch->autoSound) {
+					// Autolooping sounds always go back to start
+					ch->position = 0;
+					ch->endTime = lTime + sc->length;
+				}
+				else if (sc->loopStart >= 0) {
+					ch->position = sc->loopStart;
+					ch->endTime = lTime + sc->length - ch->position;
+				}
+				else {
+					// Channel just stopped
+					ch->sfx = NULL;
+				}
+			}
+		}
+	}
+}
+
+
+/*
+================
+DMASnd_PaintChannels
+================
+*/
+static void DMASnd_PaintChannels (int endTime, float volume)
+{
 	int			newEnd, i;
 
 	while (snd_dmaPaintedTime < endTime) {
@@ -666,52 +905,7 @@ static void DMASnd_PaintChannels (int endTime, float volume)
 		}
 
 		// Paint in the channels
-		for (i=0, ch=snd_dmaOutChannels ; i<MAX_CHANNELS ; ch++, i++) {
-			lTime = snd_dmaPaintedTime;
-		
-			while (lTime < newEnd) {
-				if (!ch->sfx || (!ch->leftVol && !ch->rightVol))
-					break;
-
-				// Max painting is to the end of the buffer
-				count = newEnd - lTime;
-
-				// Might be stopped by running out of data
-				if (ch->endTime - lTime < count)
-					count = ch->endTime - lTime;
-		
-				sc = Snd_LoadSound (ch->sfx);
-				if (!sc)
-					break;
-
-				if (count > 0 && ch->sfx) {	
-					if (sc->width == 1)
-						DMASnd_PaintChannelFrom8 (ch, sc, count, lTime - snd_dmaPaintedTime);
-					else
-						DMASnd_PaintChannelFrom16 (ch, sc, count, lTime - snd_dmaPaintedTime, volume);
-	
-					lTime += count;
-				}
-
-				// If at end of loop, restart
-				if (lTime >= ch->endTime) {
-					if (ch->autoSound) {
-						// Autolooping sounds always go back to start
-						ch->position = 0;
-						ch->endTime = lTime + sc->length;
-					}
-					else if (sc->loopStart >= 0) {
-						ch->position = sc->loopStart;
-						ch->endTime = lTime + sc->length - ch->position;
-					}
-					else {
-						// Channel just stopped
-						ch->sfx = NULL;
-					}
-				}
-			}
-															  
-		}
+		DMASnd_MixChannels (newEnd, volume);
 
 		// Transfer out according to DMA format
 		DMASnd_TransferPaintBuffer (newEnd);
@@ -856,6 +1050,7 @@ void DMASnd_Update (refDef_t *rd)
 	}
 
 	// Update spatialization for dynamic sounds
+	int numSpatial = 0;
 	for (i=0, ch=snd_dmaOutChannels ; i<MAX_CHANNELS ; ch++, i++)
 	{
 		if (!ch->sfx)
@@ -868,13 +1063,41 @@ void DMASnd_Update (refDef_t *rd)
 			continue;
 		}
 
-		// Respatialize channel
-		DMASnd_SpatializeChannel (ch);
-		if (!ch->leftVol && !ch->rightVol)
+		// Anything coming from the view entity will always be full volume
+		if (ch->psType == PSND_LOCAL)
 		{
-			memset (ch, 0, sizeof(channel_t));
+			ch->leftVol = ch->masterVol;
+			ch->rightVol = ch->masterVol;
 			continue;
 		}
+
+		// Queue fixed/entity sounds for respatialization
+		sndSpatial_t *sp = &snd_dmaSpatial[numSpatial];
+		if (ch->psType == PSND_ENTITY)
+		{
+			vec3_t velocity;
+			CL_CGModule_GetEntitySoundOrigin (ch->entNum, sp->origin, velocity);
+		}
+		else
+		{
+			Vec3Copy (ch->origin, sp->origin);
+		}
+		sp->masterVol = ch->masterVol;
+		sp->distMult = ch->distMult;
+
+		snd_dmaSpatialChannels[numSpatial++] = i;
+	}
+
+	DMASnd_SpatializeBatch (snd_dmaSpatial, numSpatial);
+
+	for (i=0 ; i<numSpatial ; i++)
+	{
+		ch = &snd_dmaOutChannels[snd_dmaSpatialChannels[i]];
+		ch->leftVol = snd_dmaSpatial[i].leftVol;
+		ch->rightVol = snd_dmaSpatial[i].rightVol;
+
+		if (!ch->leftVol && !ch->rightVol)
+			memset (ch, 0, sizeof(channel_t));
 	}
 
 	// Add loopsounds
@@ -945,6 +1168,162 @@ void DMASnd_Update (refDef_t *rd)
 	}
 }
 
+/*
+==============================================================================
+
+	MIXER BENCHMARK
+
+	Renders a synthetic channel set into a private 16 bit stereo buffer, once
+	with the vector kernels and once with the scalar ones, and reports the time
+	taken and whether the two outputs match. The live device is left untouched,
+	so this also works with no audio hardware at all.
+
+==============================================================================
+*/
+
+#define MIXBENCH_SPEED		22050
+#define MIXBENCH_SAMPLES	16384		// mono samples in the output buffer
+
+/*
+================
+DMASnd_MixBenchSound
+
+One second of deterministic noise, looping.
+================
+*/
+static sfxCache_t *DMASnd_MixBenchSound (const int width, uint32 &seed)
+{
+	sfxCache_t *sc = (sfxCache_t*)Mem_Alloc (MIXBENCH_SPEED * width + sizeof(sfxCache_t));
+	sc->length = MIXBENCH_SPEED;
+	sc->loopStart = 0;
+	sc->speed = MIXBENCH_SPEED;
+	sc->width = width;
+	sc->stereo = 1;
+
+	for (int i=0 ; i<MIXBENCH_SPEED ; i++)
+	{
+		seed = seed * 1664525 + 1013904223;
+		if (width == 1)
+			sc->data[i] = (byte)(seed >> 24);
+		else
+			((sint16 *)sc->data)[i] = (sint16)(seed >> 16);
+	}
+
+	return sc;
+}
+
+
+/*
+================
+DMASnd_MixBench_f
+================
+*/
+void DMASnd_MixBench_f ()
+{
+	const float seconds = (Cmd_Argc () > 1) ? atof (Cmd_Argv (1)) : 10.0f;
+	const int numChannels = (Cmd_Argc () > 2) ? clamp (atoi (Cmd_Argv (2)), 1, MAX_CHANNELS) : 32;
+	const int totalSamples = seconds * MIXBENCH_SPEED;
+	if (totalSamples <= 0)
+	{
+		Com_Printf (0, "Usage: snd_mixbench [seconds] [channels]\n");
+		return;
+	}
+
+	// Save the live mixer state
+	channel_t *savedChannels = (channel_t*)Mem_Alloc (sizeof(snd_dmaOutChannels));
+	memcpy (savedChannels, snd_dmaOutChannels, sizeof(snd_dmaOutChannels));
+	const audioDMA_t savedDMA = snd_audioDMA;
+	const int savedPaintedTime = snd_dmaPaintedTime;
+	const int savedRawEnd = snd_dmaRawEnd;
+	const int savedTestSound = s_testsound->intVal;
+
+	// Synthetic device
+	snd_audioDMA.channels = 2;
+	snd_audioDMA.samples = MIXBENCH_SAMPLES;
+	snd_audioDMA.submissionChunk = 1;
+	snd_audioDMA.samplePos = 0;
+	snd_audioDMA.sampleBits = 16;
+	snd_audioDMA.speed = MIXBENCH_SPEED;
+	s_testsound->intVal = 0;
+	DMASnd_ScaleTableInit (1.0f);
+
+	// Synthetic sounds, one 8 bit and one 16 bit
+	uint32 seed = 1;
+	sfx_t benchSfx[2];
+	memset (benchSfx, 0, sizeof(benchSfx));
+	for (int i=0 ; i<2 ; i++)
+	{
+		Q_snprintfz (benchSfx[i].name, sizeof(benchSfx[i].name), "mixbench%i", (i+1)*8);
+		benchSfx[i].cache = DMASnd_MixBenchSound (i+1, seed);
+	}
+
+	sint16 *output[2];
+	uint32 time[2];
+	for (int pass=0 ; pass<2 ; pass++)
+	{
+		output[pass] = (sint16*)Mem_Alloc (MIXBENCH_SAMPLES * sizeof(sint16));
+		snd_audioDMA.buffer = (byte *)output[pass];
+		snd_dmaScalarMix = (pass == 1);
+
+		// Same channel set for both passes
+		memset (snd_dmaOutChannels, 0, sizeof(snd_dmaOutChannels));
+		for (int i=0 ; i<numChannels ; i++)
+		{
+			channel_t *ch = &snd_dmaOutChannels[i];
+			ch->sfx = &benchSfx[i&1];
+			ch->leftVol = (i * 37 + 64) & 255;
+			ch->rightVol = (i * 91 + 128) & 255;
+			ch->autoSound = true;
+			ch->position = (i * 997) % MIXBENCH_SPEED;
+			ch->endTime = MIXBENCH_SPEED - ch->position;
+		}
+
+		snd_dmaPaintedTime = 0;
+		snd_dmaRawEnd = -1;
+
+		const uint32 startTime = Sys_UMilliseconds ();
+		while (snd_dmaPaintedTime < totalSamples)
+		{
+			const int newEnd = min(snd_dmaPaintedTime + SND_PBUFFER, totalSamples);
+
+			memset (snd_dmaPaintBuffer, 0, (newEnd - snd_dmaPaintedTime) * sizeof(sfxSamplePair_t));
+			DMASnd_MixChannels (newEnd, 1.0f);
+			DMASnd_TransferPaintBuffer (newEnd);
+			snd_dmaPaintedTime = newEnd;
+		}
+		time[pass] = Sys_UMilliseconds () - startTime;
+	}
+
+	int numDiffer = 0;
+	for (int i=0 ; i<MIXBENCH_SAMPLES ; i++)
+	{
+		if (output[0][i] != output[1][i])
+			numDiffer++;
+	}
+
+	Com_Printf (0, "Mixed %.1f seconds of %i channels at %ihz\n", seconds, numChannels, MIXBENCH_SPEED);
+	Com_Printf (0, "%6ums vector\n", time[0]);
+	Com_Printf (0, "%6ums scalar\n", time[1]);
+	if (numDiffer)
+		Com_Printf (PRNT_WARNING, "%i output samples differ between the vector and scalar mixers\n", numDiffer);
+
+	// Restore the live mixer state
+	for (int i=0 ; i<2 ; i++)
+	{
+		Mem_Free (output[i]);
+		Mem_Free (benchSfx[i].cache);
+	}
+
+	memcpy (snd_dmaOutChannels, savedChannels, sizeof(snd_dmaOutChannels));
+	Mem_Free (savedChannels);
+	snd_audioDMA = savedDMA;
+	snd_dmaPaintedTime = savedPaintedTime;
+	snd_dmaRawEnd = savedRawEnd;
+	s_testsound->intVal = savedTestSound;
+	snd_dmaScalarMix = false;
+	DMASnd_ScaleTableInit (s_volume->floatVal);
+}
+
 /*
 ==============================================================================
 
@@ -181,6 +181,8 @@ void	DMASnd_RawSamples (int samples, int rate, int width, int channels, byte *da
 
 void	DMASnd_Update (refDef_t *rd);
 
+void	DMASnd_MixBench_f ();
+
 //
 // snd_openal.c
 //
@@ -771,6 +771,7 @@ static conCmd_t	*cmd_play;
 static conCmd_t	*cmd_stopSound;
 static conCmd_t	*cmd_soundList;
 static conCmd_t	*cmd_soundInfo;
+static conCmd_t	*cmd_mixBench;
 
 
 /*
@@ -856,6 +857,7 @@ void Snd_Init()
 	cmd_stopSound	= Cmd_AddCommand("stopsound",		0, Snd_StopAllSounds,	"Stops all currently playing sounds");
 	cmd_soundList	= Cmd_AddCommand("soundlist",		0, Snd_SoundList_f,		"Prints out a list of loaded sound files");
 	cmd_soundInfo	= Cmd_AddCommand("soundinfo",		0, Snd_SoundInfo_f,		"Prints out information on sound subsystem");
+	cmd_mixBench	= Cmd_AddCommand("snd_mixbench",	0, DMASnd_MixBench_f,	"Times the software mixer on a synthetic channel set");
 
 	if (!s_initSound->intVal)
 	{
@@ -911,6 +913,7 @@ void Snd_Shutdown ()
 	Cmd_RemoveCommand(cmd_stopSound);
 	Cmd_RemoveCommand(cmd_soundList);
 	Cmd_RemoveCommand(cmd_soundInfo);
+	Cmd_RemoveCommand(cmd_mixBench);
 
 	if (!snd_isInitialized)
 		return;
@@ -40,13 +40,161 @@ cmBspModel_t			cm_mapCModels[MAX_CM_CMODELS];
 
 int						cm_numTraces;
 int						cm_numBrushTraces;
+int						cm_numPatchTraces;
+int						cm_numFacetTraces;
 int						cm_numPointContents;
+uint32					cm_traceCycles;
+
+bool					cm_scalarClip;
+static fileHandle_t		cm_traceFile;	// cm_traceRecord
+static int				cm_boxHeadNode = -1;			// last CM_HeadnodeForBox, so recorded
+static vec3_t			cm_boxMins, cm_boxMaxs;		// entity clips can rebuild their box
+
+static const byte		*cm_mapImageHeld;		// handed on to the renderer's world model load
 
 cVar_t					*flushmap;
 cVar_t					*cm_noAreas;
 cVar_t					*cm_noCurves;
 cVar_t					*cm_showTrace;
 
+/*
+=============================================================================
+
+	SHARED MAP IMAGE
+
+	The raw .bsp is read and checksummed once and handed to every loader in
+	this process that asks for the same map, so a listen server's collision
+	and world model loads don't both read it. CM_LoadMap keeps its reference
+	until the renderer has loaded the map, and the client's end of
+	registration or the next map unload frees whatever is left. Each loader
+	still decodes its own data from the image, and must not write to it.
+
+=============================================================================
+*/
+
+struct cmMapImage_t
+{
+	char			name[MAX_QPATH];
+	byte			*base;
+	int				length;
+	uint32			checksum;
+	int				refCount;
+};
+
+static cmMapImage_t		cm_mapImage;
+
+/*
+==================
+CM_AcquireMapImage
+
+Returns the read-only file image of a map, or NULL with length set the way
+FS_LoadFile would. checksum may be NULL. Each successful call must be paired
+with CM_ReleaseMapImage.
+==================
+*/
+const byte *CM_AcquireMapImage (const char *name, int *length, uint32 *checksum)
+{
+	char	fixedName[MAX_QPATH];
+	byte	*buffer;
+	int		fileLen;
+
+	Com_NormalizePath (fixedName, sizeof(fixedName), name);
+	if (cm_mapImage.base && !Q_stricmp (cm_mapImage.name, fixedName)) {
+		cm_mapImage.refCount++;
+		*length = cm_mapImage.length;
+		if (checksum)
+			*checksum = cm_mapImage.checksum;
+		return cm_mapImage.base;
+	}
+
+	fileLen = FS_LoadFile (fixedName, (void **)&buffer, false);
+	*length = fileLen;
+	if (!buffer || fileLen <= 0)
+		return NULL;
+
+	// Another map is still held, this one stays private
+	if (cm_mapImage.base) {
+		if (checksum)
+			*checksum = Com_BlockChecksum (buffer, fileLen);
+		return buffer;
+	}
+
+	Q_strncpyz (cm_mapImage.name, fixedName, sizeof(cm_mapImage.name));
+	cm_mapImage.base = buffer;
+	cm_mapImage.length = fileLen;
+	cm_mapImage.checksum = Com_BlockChecksum (buffer, fileLen);
+	cm_mapImage.refCount = 1;
+
+	if (checksum)
+		*checksum = cm_mapImage.checksum;
+	return cm_mapImage.base;
+}
+
+
+/*
+==================
+CM_DropHeldImage
+==================
+*/
+static void CM_DropHeldImage ()
+{
+	const byte	*image;
+
+	image = cm_mapImageHeld;
+	cm_mapImageHeld = NULL;
+	CM_ReleaseMapImage (image);
+}
+
+
+/*
+==================
+CM_ReleaseMapImage
+==================
+*/
+void CM_ReleaseMapImage (const byte *image)
+{
+	if (!image)
+		return;
+
+	if (image != cm_mapImage.base) {
+		FS_FreeFile ((void *)image);
+		return;
+	}
+
+	// Only the collision model's reference is left, so whoever it was
+	// waiting for has loaded and the image can go
+	if (--cm_mapImage.refCount == 1 && cm_mapImageHeld == image) {
+		CM_DropHeldImage ();
+		return;
+	}
+	if (cm_mapImage.refCount > 0)
+		return;
+
+	FS_FreeFile (cm_mapImage.base);
+	memset (&cm_mapImage, 0, sizeof(cm_mapImage));
+}
+
+
+/*
+==================
+CM_FlushMapImage
+
+Frees the image whatever its reference count. A loader that dropped out
+with Com_Error never releases its reference, which would otherwise keep
+the image, and every later map private, for the rest of the session.
+==================
+*/
+void CM_FlushMapImage ()
+{
+	cm_mapImageHeld = NULL;
+	if (!cm_mapImage.base)
+		return;
+
+	FS_FreeFile (cm_mapImage.base);
+	memset (&cm_mapImage, 0, sizeof(cm_mapImage));
+}
+
+
 /*
 =============================================================================
 
@@ -129,12 +277,13 @@ cmBspModel_t *CM_LoadMap(char *name, bool clientLoad, uint32 *checksum)
 	}
 
 	// Load the file
-	fileLen = FS_LoadFile(fixedName, (void **)&buffer, false);
+	buffer = (uint32 *)CM_AcquireMapImage(fixedName, &fileLen, &cm_mapChecksum);
 	if (!buffer || fileLen <= 0)
 		Com_Error (ERR_DROP, "CM_LoadMap: Couldn't %s %s", (fileLen == -1) ? "find" : "load", fixedName);
+	cm_mapImageHeld = (const byte *)buffer;
 
 	// Calculate checksum
-	cm_mapChecksum = LittleLong(Com_BlockChecksum (buffer, fileLen));
+	cm_mapChecksum = LittleLong(cm_mapChecksum);
 	*checksum = cm_mapChecksum;
 
 	// Load the model
@@ -153,15 +302,16 @@ cmBspModel_t *CM_LoadMap(char *name, bool clientLoad, uint32 *checksum)
 	model = descr->loader(buffer);
 	if (!model)
 	{
-		FS_FreeFile(buffer);
+		CM_DropHeldImage();
 		return NULL;
 	}
 
 	cm_bspType = descr->type;
 	Q_strncpyz(cm_mapName, fixedName, sizeof(cm_mapName));
 
-	// Free the buffer
-	FS_FreeFile(buffer);
+	// Keep the image for the renderer, a dedicated server has none
+	if (dedicated->intVal)
+		CM_DropHeldImage();
 
 	// Check integrity and return
 	Mem_CheckPoolIntegrity(com_cmodelSysPool);
@@ -183,14 +333,26 @@ void CM_UnloadMap()
 	else
 		CM_Q2BSP_UnloadMap();
 
+	CM_FlushMapImage();
+
+	if (cm_traceFile) {
+		FS_CloseFile (cm_traceFile);
+		cm_traceFile = 0;
+		Com_Printf (0, "Stopped recording traces, map unloaded.\n");
+	}
+
 	cm_mapName[0] = 0;
 	cm_mapChecksum = 0;
+	cm_boxHeadNode = -1;
 
 	cm_numCModels = 0;
 
 	cm_numTraces = 0;
 	cm_numBrushTraces = 0;
+	cm_numPatchTraces = 0;
+	cm_numFacetTraces = 0;
 	cm_numPointContents = 0;
+	cm_traceCycles = 0;
 }
 
 
@@ -343,9 +505,14 @@ int CM_LeafContents (int leafNum)
 
 int	CM_HeadnodeForBox (vec3_t mins, vec3_t maxs)
 {
+	Vec3Copy (mins, cm_boxMins);
+	Vec3Copy (maxs, cm_boxMaxs);
+
 	if (cm_bspType == BSP_TYPE_Q3)
-		return CM_Q3BSP_HeadnodeForBox (mins, maxs);
-	return CM_Q2BSP_HeadnodeForBox (mins, maxs);
+		cm_boxHeadNode = CM_Q3BSP_HeadnodeForBox (mins, maxs);
+	else
+		cm_boxHeadNode = CM_Q2BSP_HeadnodeForBox (mins, maxs);
+	return cm_boxHeadNode;
 }
 
 int CM_PointLeafnum (vec3_t p)
@@ -384,8 +551,96 @@ int	CM_TransformedPointContents (vec3_t p, int headNode, vec3_t origin, vec3_t a
 =============================================================================
 */
 
+#define CM_TRACEFILE_IDENT		(('C'<<24)+('R'<<16)+('T'<<8)+'C')	// "CTRC"
+#define CM_TRACEFILE_VERSION	2
+
+struct cmTraceFileHeader_t
+{
+	int			ident;
+	int			version;
+	uint32		mapChecksum;
+	char		mapName[MAX_QPATH];
+};
+
+struct cmTraceRecord_t
+{
+	vec3_t		start, end;
+	vec3_t		mins, maxs;
+	vec3_t		origin, angles;		// only for transformed traces
+	int			headNode;
+	int			brushMask;
+	int			transformed;
+	int			boxHull;			// headNode is the shared box hull, set to boxMins/boxMaxs
+	vec3_t		boxMins, boxMaxs;
+};
+
+/*
+==================
+CM_RecordTrace
+==================
+*/
+static void CM_RecordTrace (vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs, int headNode, int brushMask, vec3_t origin, vec3_t angles)
+{
+	cmTraceRecord_t	rec;
+
+	memset (&rec, 0, sizeof(rec));
+	Vec3Copy (start, rec.start);
+	Vec3Copy (end, rec.end);
+	Vec3Copy (mins, rec.mins);
+	Vec3Copy (maxs, rec.maxs);
+	rec.headNode = headNode;
+	rec.brushMask = brushMask;
+	if (headNode == cm_boxHeadNode) {
+		Vec3Copy (cm_boxMins, rec.boxMins);
+		Vec3Copy (cm_boxMaxs, rec.boxMaxs);
+		rec.boxHull = 1;
+	}
+	if (origin && angles) {
+		Vec3Copy (origin, rec.origin);
+		Vec3Copy (angles, rec.angles);
+		rec.transformed = 1;
+	}
+
+	FS_Write (&rec, sizeof(rec), cm_traceFile);
+}
+
+
+// Adds the time spent in a trace to cm_traceCycles when cm_showTrace is 2
+class cmTraceTimer_Scope
+{
+	uint32 StartCycles;
+
+public:
+	cmTraceTimer_Scope()
+		: StartCycles(0)
+	{
+		if (Enabled())
+			StartCycles = Sys_Cycles();
+	}
+	~cmTraceTimer_Scope()
+	{
+		if (Enabled())
+			cm_traceCycles += Sys_Cycles() - StartCycles;
+	}
+
+	static inline bool Enabled()
+	{
+		return (cm_showTrace && cm_showTrace->intVal >= 2);
+	}
+};
+
 cmTrace_t CM_Trace (vec3_t start, vec3_t end, float size, int contentMask)
 {
+	if (cm_traceFile) {
+		vec3_t	mins, maxs;
+
+		Vec3Set (mins, -size, -size, -size);
+		Vec3Set (maxs, size, size, size);
+		CM_RecordTrace (start, end, mins, maxs, 0, contentMask, NULL, NULL);
+	}
+
+	cmTraceTimer_Scope Timer;
+
 	if (cm_bspType == BSP_TYPE_Q3)
 		return CM_Q3BSP_Trace (start, end, size, contentMask);
 	return CM_Q2BSP_Trace (start, end, size, contentMask);
@@ -393,6 +648,11 @@ cmTrace_t CM_Trace (vec3_t start, vec3_t end, float size, int contentMask)
 
 cmTrace_t CM_BoxTrace (vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs, int headNode, int brushMask)
 {
+	if (cm_traceFile)
+		CM_RecordTrace (start, end, mins, maxs, headNode, brushMask, NULL, NULL);
+
+	cmTraceTimer_Scope Timer;
+
 	if (cm_bspType == BSP_TYPE_Q3)
 		return CM_Q3BSP_BoxTrace (start, end, mins, maxs, headNode, brushMask);
 	return CM_Q2BSP_BoxTrace (start, end, mins, maxs, headNode, brushMask);
@@ -402,6 +662,10 @@ void CM_TransformedBoxTrace (cmTrace_t *out, vec3_t start, vec3_t end, vec3_t mi
 {
 	if (!out)
 		return;
+	if (cm_traceFile)
+		CM_RecordTrace (start, end, mins, maxs, headNode, brushMask, origin, angles);
+
+	cmTraceTimer_Scope Timer;
 
 	if (cm_bspType == BSP_TYPE_Q3) {
 		CM_Q3BSP_TransformedBoxTrace (out, start, end, mins, maxs, headNode, brushMask, origin, angles);
@@ -500,6 +764,9 @@ bool CM_HeadnodeVisible (int nodeNum, byte *visBits)
 /*
 ==================
 CM_PrintStats
+
+cm_showTrace 1 prints the per frame counts, 2 adds the patch and facet
+counts and the time spent tracing.
 ==================
 */
 void CM_PrintStats ()
@@ -507,22 +774,211 @@ void CM_PrintStats ()
 	static int	highTrace = 0;
 	static int	highBTrace = 0;
 	static int	highPC = 0;
+	static int	highPatch = 0;
+	static int	highFacet = 0;
 
-	if (cm_showTrace && cm_showTrace->intVal)
+	if (cm_showTrace && cm_showTrace->intVal) {
 		Com_Printf (0, "%4i/%4i tr %4i/%4i brtr %4i/%4i pt\n",
 			cm_numTraces, highTrace,
 			cm_numBrushTraces, highBTrace,
 			cm_numPointContents, highPC);
 
+		if (cm_showTrace->intVal >= 2)
+			Com_Printf (0, "%4i/%4i patch %4i/%4i facet %6.3fms\n",
+				cm_numPatchTraces, highPatch,
+				cm_numFacetTraces, highFacet,
+				cm_traceCycles * Sys_MSPerCycle ());
+	}
+
 	if (cm_numTraces > highTrace)
 		highTrace = cm_numTraces;
 	if (cm_numBrushTraces > highBTrace)
 		highBTrace = cm_numBrushTraces;
 	if (cm_numPointContents > highPC)
 		highPC = cm_numPointContents;
+	if (cm_numPatchTraces > highPatch)
+		highPatch = cm_numPatchTraces;
+	if (cm_numFacetTraces > highFacet)
+		highFacet = cm_numFacetTraces;
 
 	// Reset
 	cm_numTraces = 0;
 	cm_numBrushTraces = 0;
+	cm_numPatchTraces = 0;
+	cm_numFacetTraces = 0;
 	cm_numPointContents = 0;
+	cm_traceCycles = 0;
+}
+
+/*
+=============================================================================
+
+	TRACE RECORDING AND BENCHMARK
+
+	cm_traceRecord captures every trace made through the CM_ entry points,
+	server and client prediction alike, into traces/<name>.trc. cm_traceBench
+	replays a capture against the same map, once with the packed side planes
+	and once with the scalar clipping code, and reports the time taken and any
+	results that differ.
+
+=============================================================================
+*/
+
+/*
+==================
+CM_TraceRecord_f
+==================
+*/
+static void CM_TraceRecord_f ()
+{
+	cmTraceFileHeader_t	header;
+	char				name[MAX_QPATH];
+
+	if (cm_traceFile) {
+		FS_CloseFile (cm_traceFile);
+		cm_traceFile = 0;
+		Com_Printf (0, "Stopped recording traces.\n");
+		return;
+	}
+
+	if (Cmd_Argc () != 2) {
+		Com_Printf (0, "Usage: cm_traceRecord <name>, again with no name to stop\n");
+		return;
+	}
+	if (!cm_mapName[0]) {
+		Com_Printf (0, "No map loaded.\n");
+		return;
+	}
+	if (strstr (Cmd_Argv(1), "..") || strchr (Cmd_Argv(1), '/') || strchr (Cmd_Argv(1), '\\')) {
+		Com_Printf (0, "Illegal filename.\n");
+		return;
+	}
+
+	Q_snprintfz (name, sizeof(name), "traces/%s.trc", Cmd_Argv (1));
+	FS_CreatePath (name);
+	FS_OpenFile (name, &cm_traceFile, FS_MODE_WRITE_BINARY);
+	if (!cm_traceFile) {
+		Com_Printf (PRNT_ERROR, "CM_TraceRecord_f: couldn't open %s.\n", name);
+		return;
+	}
+
+	memset (&header, 0, sizeof(header));
+	header.ident = CM_TRACEFILE_IDENT;
+	header.version = CM_TRACEFILE_VERSION;
+	header.mapChecksum = cm_mapChecksum;
+	Q_strncpyz (header.mapName, cm_mapName, sizeof(header.mapName));
+	FS_Write (&header, sizeof(header), cm_traceFile);
+
+	Com_Printf (0, "Recording traces to %s.\n", name);
+}
+
+
+/*
+==================
+CM_TraceBench_f
+==================
+*/
+static void CM_TraceBench_f ()
+{
+	cmTraceFileHeader_t	*header;
+	cmTraceRecord_t		*recs, *rec;
+	cmTrace_t			*results[2], *tr;
+	uint32				time[2], startTime;
+	char				name[MAX_QPATH];
+	byte				*buffer;
+	int					fileLen, numRecs, numPasses, numDiffer;
+	int					pass, i, j;
+
+	if (Cmd_Argc () < 2) {
+		Com_Printf (0, "Usage: cm_traceBench <name> [passes]\n");
+		return;
+	}
+	if (cm_traceFile) {
+		Com_Printf (0, "Stop recording traces first.\n");
+		return;
+	}
+	numPasses = (Cmd_Argc () > 2) ? max (atoi (Cmd_Argv (2)), 1) : 1;
+
+	Q_snprintfz (name, sizeof(name), "traces/%s.trc", Cmd_Argv (1));
+	fileLen = FS_LoadFile (name, (void **)&buffer, false);
+	if (!buffer || fileLen < (int)sizeof(cmTraceFileHeader_t)) {
+		Com_Printf (PRNT_ERROR, "CM_TraceBench_f: couldn't load %s.\n", name);
+		if (buffer)
+			FS_FreeFile (buffer);
+		return;
+	}
+
+	header = (cmTraceFileHeader_t *)buffer;
+	if (header->ident != CM_TRACEFILE_IDENT || header->version != CM_TRACEFILE_VERSION) {
+		Com_Printf (PRNT_ERROR, "CM_TraceBench_f: %s is not a version %i trace file.\n", name, CM_TRACEFILE_VERSION);
+		FS_FreeFile (buffer);
+		return;
+	}
+	if (header->mapChecksum != cm_mapChecksum || Q_stricmp (header->mapName, cm_mapName)) {
+		Com_Printf (PRNT_ERROR, "CM_TraceBench_f: %s was recorded on %s, load that map first.\n", name, header->mapName);
+		FS_FreeFile (buffer);
+		return;
+	}
+
+	recs = (cmTraceRecord_t *)(buffer + sizeof(cmTraceFileHeader_t));
+	numRecs = (fileLen - sizeof(cmTraceFileHeader_t)) / sizeof(cmTraceRecord_t);
+
+	for (pass=0 ; pass<2 ; pass++) {
+		results[pass] = (cmTrace_t*)Mem_Alloc (sizeof(cmTrace_t) * max (numRecs, 1));
+		cm_scalarClip = (pass == 1);
+
+		startTime = Sys_UMilliseconds ();
+		for (j=0 ; j<numPasses ; j++) {
+			for (i=0, rec=recs, tr=results[pass] ; i<numRecs ; i++, rec++, tr++) {
+				// Entity clips share one box hull, put back the box this one used
+				if (rec->boxHull)
+					rec->headNode = CM_HeadnodeForBox (rec->boxMins, rec->boxMaxs);
+
+				if (rec->transformed)
+					CM_TransformedBoxTrace (tr, rec->start, rec->end, rec->mins, rec->maxs, rec->headNode, rec->brushMask, rec->origin, rec->angles);
+				else
+					*tr = CM_BoxTrace (rec->start, rec->end, rec->mins, rec->maxs, rec->headNode, rec->brushMask);
+			}
+		}
+		time[pass] = Sys_UMilliseconds () - startTime;
+	}
+	cm_scalarClip = false;
+
+	numDiffer = 0;
+	for (i=0 ; i<numRecs ; i++) {
+		cmTrace_t *a = &results[0][i];
+		cmTrace_t *b = &results[1][i];
+
+		if (a->fraction != b->fraction
+		|| !Vec3Compare (a->endPos, b->endPos)
+		|| !Vec3Compare (a->plane.normal, b->plane.normal)
+		|| a->plane.dist != b->plane.dist
+		|| a->startSolid != b->startSolid
+		|| a->allSolid != b->allSolid
+		|| a->contents != b->contents
+		|| a->surface != b->surface)
+			numDiffer++;
+	}
+
+	Com_Printf (0, "Replayed %i traces from %s, %i time(s)\n", numRecs, name, numPasses);
+	Com_Printf (0, "%6ums packed\n", time[0]);
+	Com_Printf (0, "%6ums scalar\n", time[1]);
+	if (numDiffer)
+		Com_Printf (PRNT_WARNING, "%i traces differ between the packed and scalar clipping\n", numDiffer);
+
+	Mem_Free (results[0]);
+	Mem_Free (results[1]);
+	FS_FreeFile (buffer);
+}
+
+
+/*
+==================
+CM_Register
+==================
+*/
+void CM_Register ()
+{
+	Cmd_AddCommand ("cm_traceRecord",	0, CM_TraceRecord_f,	"Records collision traces to traces/<name>.trc");
+	Cmd_AddCommand ("cm_traceBench",	0, CM_TraceBench_f,		"Replays recorded traces with packed and scalar brush clipping");
 }
@@ -25,6 +25,23 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 
 #define MAX_CM_CMODELS		1024		// Must be >= Q2BSP_MAX_MODELS and >= Q3BSP_MAX_MODELS
 
+// Brush side planes packed four at a time for the SIMD clipping: x, y and z
+// of the normals, then the dists. Axial planes are stored as exact unit axes
+// so the dot products match the plane->type < 3 shortcuts.
+#define CM_PACKED_PLANE_FLOATS	16
+
+inline int CM_PackedPlaneFloats (const int numSides)
+{
+	return SIMD_ALIGN(numSides) / SIMD_WIDTH * CM_PACKED_PLANE_FLOATS;
+}
+
+inline void CM_PackPlane (float *block, const int lane, const plane_t *p)
+{
+	for (int i=0 ; i<3 ; i++)
+		block[i*SIMD_WIDTH + lane] = (p->type < 3) ? (float)(i == p->type) : p->normal[i];
+	block[3*SIMD_WIDTH + lane] = p->dist;
+}
+
 struct cmBspModel_t
 {
 	vec3_t					mins;
@@ -46,7 +63,12 @@ extern cmBspModel_t			cm_mapCModels[MAX_CM_CMODELS];
 
 extern int					cm_numTraces;
 extern int					cm_numBrushTraces;
+extern int					cm_numPatchTraces;		// Q3BSP patches whose facet tree was walked
+extern int					cm_numFacetTraces;		// Q3BSP patch facets clipped or tested
 extern int					cm_numPointContents;
+extern uint32				cm_traceCycles;			// only counted with cm_showTrace 2
+
+extern bool					cm_scalarClip;			// cm_traceBench, clip without the packed side planes
 
 extern cVar_t				*flushmap;
 extern cVar_t				*cm_noAreas;
@@ -38,6 +38,12 @@ int			CM_InlineModelHeadNode (struct cmBspModel_t *model);
 // ==========================================================================
 
 void		CM_PrintStats ();
+void		CM_Register ();
+
+// Read-only .bsp file image shared between loaders, see cm_common.cpp
+const byte	*CM_AcquireMapImage (const char *name, int *length, uint32 *checksum);
+void		CM_ReleaseMapImage (const byte *image);
+void		CM_FlushMapImage ();
 
 // ==========================================================================
 
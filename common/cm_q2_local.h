@@ -60,8 +60,12 @@ struct cmQ2BspBrush_t
 	int				numSides;
 	int				firstBrushSide;
 	int				checkCount;			// to avoid repeated testings
+
+	float			*sidePlanes;		// CM_PACKED_PLANE_FLOATS per four sides, NULL for the box hull
 };
 
+#define CM_Q2_MAX_PACKED_SIDES	64		// brushes with more sides use the scalar path
+
 struct cmQ2BspArea_t
 {
 	int				numAreaPortals;
@@ -682,6 +682,47 @@ static void CM_Q2BSP_LoadBrushSides (dQ2BspLump_t *l)
 }
 
 
+/*
+=================
+CM_Q2BSP_PackBrushSides
+
+Copies every brush's side planes into the packed layout the SIMD clipping
+reads. Brushes with bogus side ranges or too many sides are left unpacked.
+=================
+*/
+static void CM_Q2BSP_PackBrushSides ()
+{
+	cmQ2BspBrush_t	*brush;
+	float			*out;
+	int				i, j, numFloats;
+
+	numFloats = 0;
+	for (i=0, brush=cm_q2_brushes ; i<cm_q2_numBrushes ; i++, brush++) {
+		if (brush->numSides <= 0 || brush->numSides > CM_Q2_MAX_PACKED_SIDES)
+			continue;
+		if (brush->firstBrushSide < 0 || brush->firstBrushSide+brush->numSides > cm_q2_numBrushSides)
+			continue;
+
+		numFloats += CM_PackedPlaneFloats (brush->numSides);
+	}
+	if (!numFloats)
+		return;
+
+	out = (float*)Mem_PoolAlloc (sizeof(float) * numFloats, com_cmodelSysPool, 0);
+	for (i=0, brush=cm_q2_brushes ; i<cm_q2_numBrushes ; i++, brush++) {
+		if (brush->numSides <= 0 || brush->numSides > CM_Q2_MAX_PACKED_SIDES)
+			continue;
+		if (brush->firstBrushSide < 0 || brush->firstBrushSide+brush->numSides > cm_q2_numBrushSides)
+			continue;
+
+		brush->sidePlanes = out;
+		for (j=0 ; j<brush->numSides ; j++)
+			CM_PackPlane (out + (j/SIMD_WIDTH)*CM_PACKED_PLANE_FLOATS, j%SIMD_WIDTH, cm_q2_brushSides[brush->firstBrushSide+j].plane);
+		out += CM_PackedPlaneFloats (brush->numSides);
+	}
+}
+
+
 /*
 =================
 CM_Q2BSP_LoadSubmodels
@@ -906,6 +947,7 @@ cmBspModel_t *CM_Q2BSP_LoadMap (uint32 *buffer)
 	CM_Q2BSP_LoadPlanes			(&header.lumps[Q2BSP_LUMP_PLANES]);
 	CM_Q2BSP_LoadBrushes		(&header.lumps[Q2BSP_LUMP_BRUSHES]);
 	CM_Q2BSP_LoadBrushSides		(&header.lumps[Q2BSP_LUMP_BRUSHSIDES]);
+	CM_Q2BSP_PackBrushSides		();
 	CM_Q2BSP_LoadSubmodels		(&header.lumps[Q2BSP_LUMP_MODELS]);
 	CM_Q2BSP_LoadNodes			(&header.lumps[Q2BSP_LUMP_NODES]);
 	CM_Q2BSP_LoadAreas			(&header.lumps[Q2BSP_LUMP_AREAS]);
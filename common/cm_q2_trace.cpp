@@ -44,6 +44,7 @@ static cmTrace_t			cm_q2_currentTrace;
 static vec3_t			cm_q2_traceStart, cm_q2_traceEnd;
 static vec3_t			cm_q2_traceMins, cm_q2_traceMaxs;
 static vec3_t			cm_q2_traceExtents;
+static vec3_t			cm_q2_traceOffsets[8];	// box corner nearest a plane, by plane->signBits
 static int				cm_q2_traceContents;
 static bool				cm_q2_traceIsPoint;		// optimized case
 
@@ -161,7 +162,7 @@ void CM_Q2BSP_InitBoxHull ()
 
 		p = &cm_q2_boxPlanes[i*2+1];
 		p->type = 3 + (i>>1);
-		p->signBits = 0;
+		p->signBits = BIT(i>>1);
 		Vec3Clear (p->normal);
 		p->normal[i>>1] = -1;
 	}	
@@ -368,6 +369,67 @@ int	CM_Q2BSP_TransformedPointContents (vec3_t p, int headNode, vec3_t origin, ve
 =============================================================================
 */
 
+/*
+================
+CM_Q2BSP_SideDist
+
+Distance of point from the plane, pushed out for the trace box.
+================
+*/
+static inline float CM_Q2BSP_SideDist (const plane_t *p, const vec3_t point)
+{
+	float	dist;
+
+	if (p->type < 3) {
+		dist = cm_q2_traceIsPoint ? p->dist : p->dist - cm_q2_traceOffsets[p->signBits][p->type];
+		return point[p->type] - dist;
+	}
+
+	dist = cm_q2_traceIsPoint ? p->dist : p->dist - DotProduct (cm_q2_traceOffsets[p->signBits], p->normal);
+	return DotProduct (point, p->normal) - dist;
+}
+
+
+/*
+================
+CM_Q2BSP_PackedSideDists
+
+CM_Q2BSP_SideDist for four packed sides at a time, with the same operations
+in the same order so the results are bit for bit the same.
+================
+*/
+static void CM_Q2BSP_PackedSideDists (const cmQ2BspBrush_t *brush, const vec3_t point, float *dists)
+{
+	const float	*planes = brush->sidePlanes;
+	simdVec_t	zero, nx, ny, nz, dist;
+	simdVec_t	mn[3], mx[3], pt[3];
+	int			i;
+
+	zero = Simd_Zero ();
+	for (i=0 ; i<3 ; i++) {
+		mn[i] = Simd_Splat (cm_q2_traceMins[i]);
+		mx[i] = Simd_Splat (cm_q2_traceMaxs[i]);
+		pt[i] = Simd_Splat (point[i]);
+	}
+
+	for (i=0 ; i<brush->numSides ; i+=SIMD_WIDTH, planes+=CM_PACKED_PLANE_FLOATS) {
+		nx = Simd_Load (planes);
+		ny = Simd_Load (planes + SIMD_WIDTH);
+		nz = Simd_Load (planes + SIMD_WIDTH*2);
+		dist = Simd_Load (planes + SIMD_WIDTH*3);
+
+		if (!cm_q2_traceIsPoint) {
+			simdVec_t ofs = Simd_Mul (Simd_Select (Simd_CmpLT (nx, zero), mx[0], mn[0]), nx);
+			ofs = Simd_Madd (Simd_Select (Simd_CmpLT (ny, zero), mx[1], mn[1]), ny, ofs);
+			ofs = Simd_Madd (Simd_Select (Simd_CmpLT (nz, zero), mx[2], mn[2]), nz, ofs);
+			dist = Simd_Sub (dist, ofs);
+		}
+
+		Simd_Store (dists + i, Simd_Sub (Simd_Madd (pt[2], nz, Simd_Madd (pt[1], ny, Simd_Mul (pt[0], nx))), dist));
+	}
+}
+
+
 /*
 ================
 CM_Q2BSP_ClipBoxToBrush
@@ -375,12 +437,12 @@ CM_Q2BSP_ClipBoxToBrush
 */
 static void CM_Q2BSP_ClipBoxToBrush (cmQ2BspBrush_t *brush)
 {
-	int					i, j;
+	int					i;
 	plane_t				*p, *clipPlane;
-	float				dist, dot1, dot2, f;
+	float				dot1, dot2, f;
 	float				enterFrac, leaveFrac;
-	vec3_t				ofs;
-	bool				getOut, startOut;
+	float				dists1[CM_Q2_MAX_PACKED_SIDES], dists2[CM_Q2_MAX_PACKED_SIDES];
+	bool				getOut, startOut, packed;
 	cmQ2BspBrushSide_t	*side, *leadSide;
 
 	enterFrac = -1;
@@ -396,31 +458,24 @@ static void CM_Q2BSP_ClipBoxToBrush (cmQ2BspBrush_t *brush)
 	startOut = false;
 	leadSide = NULL;
 
+	packed = (brush->sidePlanes && !cm_scalarClip);
+	if (packed) {
+		CM_Q2BSP_PackedSideDists (brush, cm_q2_traceStart, dists1);
+		CM_Q2BSP_PackedSideDists (brush, cm_q2_traceEnd, dists2);
+	}
+
 	for (i=0, side=&cm_q2_brushSides[brush->firstBrushSide] ; i<brush->numSides ; side++, i++) 	{
 		p = side->plane;
 
-		// FIXME: special case for axial
-		if (!cm_q2_traceIsPoint) {
-			// general box case
-			// push the plane out apropriately for mins/maxs
-			// FIXME: use signBits into 8 way lookup for each mins/maxs
-			for (j=0 ; j<3 ; j++) {
-				if (p->normal[j] < 0)
-					ofs[j] = cm_q2_traceMaxs[j];
-				else
-					ofs[j] = cm_q2_traceMins[j];
-			}
-			dist = DotProduct (ofs, p->normal);
-			dist = p->dist - dist;
+		if (packed) {
+			dot1 = dists1[i];
+			dot2 = dists2[i];
 		}
 		else {
-			// Special point case
-			dist = p->dist;
+			dot1 = CM_Q2BSP_SideDist (p, cm_q2_traceStart);
+			dot2 = CM_Q2BSP_SideDist (p, cm_q2_traceEnd);
 		}
 
-		dot1 = DotProduct (cm_q2_traceStart, p->normal) - dist;
-		dot2 = DotProduct (cm_q2_traceEnd, p->normal) - dist;
-
 		if (dot2 > 0)
 			getOut = true;	// Endpoint is not in solid
 		if (dot1 > 0)
@@ -513,35 +568,26 @@ CM_Q2BSP_TestBoxInBrush
 */
 static void CM_Q2BSP_TestBoxInBrush (cmQ2BspBrush_t *brush)
 {
-	int					i, j;
-	vec3_t				ofs;
-	plane_t				*p;
+	int					i;
+	float				dists[CM_Q2_MAX_PACKED_SIDES];
 	cmQ2BspBrushSide_t	*side;
-	float				dist, dot;
 
 	if (!brush->numSides)
 		return;
 
-	for (i=0, side=&cm_q2_brushSides[brush->firstBrushSide] ; i<brush->numSides ; side++, i++) {
-		p = side->plane;
-
-		// FIXME: special case for axial
-		// general box case
-		// push the plane out apropriately for mins/maxs
-		// FIXME: use signBits into 8 way lookup for each mins/maxs
-		for (j=0 ; j<3 ; j++) {
-			if (p->normal[j] < 0)
-				ofs[j] = cm_q2_traceMaxs[j];
-			else
-				ofs[j] = cm_q2_traceMins[j];
+	// If completely in front of any face, no intersection
+	if (brush->sidePlanes && !cm_scalarClip) {
+		CM_Q2BSP_PackedSideDists (brush, cm_q2_traceStart, dists);
+		for (i=0 ; i<brush->numSides ; i++) {
+			if (dists[i] > 0)
+				return;
+		}
+	}
+	else {
+		for (i=0, side=&cm_q2_brushSides[brush->firstBrushSide] ; i<brush->numSides ; side++, i++) {
+			if (CM_Q2BSP_SideDist (side->plane, cm_q2_traceStart) > 0)
+				return;
 		}
-
-		dist = p->dist - DotProduct (ofs, p->normal);
-		dot = DotProduct (cm_q2_traceStart, p->normal) - dist;
-
-		// If completely in front of face, no intersection
-		if (dot > 0)
-			return;
 	}
 
 	// Inside this brush
@@ -604,43 +650,44 @@ static void CM_Q2BSP_RecursiveHullCheck (int num, float p1f, float p2f, vec3_t p
 	if (cm_q2_currentTrace.fraction <= p1f)
 		return;		// already hit something nearer
 
-	// if < 0, we are in a leaf node
-	if (num < 0) {
-		CM_Q2BSP_ClipBoxes (-1-num);
-		return;
-	}
+	// walk down while the whole segment is on one side, only splits recurse
+	for ( ; ; ) {
+		// if < 0, we are in a leaf node
+		if (num < 0) {
+			CM_Q2BSP_ClipBoxes (-1-num);
+			return;
+		}
 
-	/*
-	** find the point distances to the seperating plane
-	** and the offset for the size of the box
-	*/
-	node = cm_q2_nodes + num;
-	plane = node->plane;
-
-	if (plane->type < 3) {
-		t1 = p1[plane->type] - plane->dist;
-		t2 = p2[plane->type] - plane->dist;
-		offset = cm_q2_traceExtents[plane->type];
-	}
-	else {
-		t1 = DotProduct (plane->normal, p1) - plane->dist;
-		t2 = DotProduct (plane->normal, p2) - plane->dist;
-		if (cm_q2_traceIsPoint)
-			offset = 0;
-		else
-			offset = fabs (cm_q2_traceExtents[0]*plane->normal[0])
-				+ fabs (cm_q2_traceExtents[1]*plane->normal[1])
-				+ fabs (cm_q2_traceExtents[2]*plane->normal[2]);
-	}
+		/*
+		** find the point distances to the seperating plane
+		** and the offset for the size of the box
+		*/
+		node = cm_q2_nodes + num;
+		plane = node->plane;
 
-	// see which sides we need to consider
-	if (t1 >= offset && t2 >= offset) {
-		CM_Q2BSP_RecursiveHullCheck (node->children[0], p1f, p2f, p1, p2);
-		return;
-	}
-	if (t1 < -offset && t2 < -offset) {
-		CM_Q2BSP_RecursiveHullCheck (node->children[1], p1f, p2f, p1, p2);
-		return;
+		if (plane->type < 3) {
+			t1 = p1[plane->type] - plane->dist;
+			t2 = p2[plane->type] - plane->dist;
+			offset = cm_q2_traceExtents[plane->type];
+		}
+		else {
+			t1 = DotProduct (plane->normal, p1) - plane->dist;
+			t2 = DotProduct (plane->normal, p2) - plane->dist;
+			if (cm_q2_traceIsPoint)
+				offset = 0;
+			else
+				offset = fabs (cm_q2_traceExtents[0]*plane->normal[0])
+					+ fabs (cm_q2_traceExtents[1]*plane->normal[1])
+					+ fabs (cm_q2_traceExtents[2]*plane->normal[2]);
+		}
+
+		// see which sides we need to consider
+		if (t1 >= offset && t2 >= offset)
+			num = node->children[0];
+		else if (t1 < -offset && t2 < -offset)
+			num = node->children[1];
+		else
+			break;
 	}
 
 	// put the crosspoint DIST_EPSILON pixels on the near side
@@ -729,6 +776,26 @@ cmTrace_t CM_Q2BSP_BoxTrace (vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
 	Vec3Copy (mins, cm_q2_traceMins);
 	Vec3Copy (maxs, cm_q2_traceMaxs);
 
+	// Corner of the box nearest each plane orientation, so brush clipping
+	// can push planes out with a lookup instead of per-axis sign tests
+	for (int s=0 ; s<8 ; s++) {
+		cm_q2_traceOffsets[s][0] = (s & BIT(0)) ? maxs[0] : mins[0];
+		cm_q2_traceOffsets[s][1] = (s & BIT(1)) ? maxs[1] : mins[1];
+		cm_q2_traceOffsets[s][2] = (s & BIT(2)) ? maxs[2] : mins[2];
+	}
+
+	// Check for point special case
+	if (Vec3Compare (mins, vec3Origin) && Vec3Compare (maxs, vec3Origin)) {
+		cm_q2_traceIsPoint = true;
+		Vec3Clear (cm_q2_traceExtents);
+	}
+	else {
+		cm_q2_traceIsPoint = false;
+		cm_q2_traceExtents[0] = -mins[0] > maxs[0] ? -mins[0] : maxs[0];
+		cm_q2_traceExtents[1] = -mins[1] > maxs[1] ? -mins[1] : maxs[1];
+		cm_q2_traceExtents[2] = -mins[2] > maxs[2] ? -mins[2] : maxs[2];
+	}
+
 	// Check for position test special case
 	if (Vec3Compare (start, end)) {
 		int		leafs[1024];
@@ -753,18 +820,6 @@ cmTrace_t CM_Q2BSP_BoxTrace (vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs,
 		return cm_q2_currentTrace;
 	}
 
-	// Check for point special case
-	if (Vec3Compare (mins, vec3Origin) && Vec3Compare (maxs, vec3Origin)) {
-		cm_q2_traceIsPoint = true;
-		Vec3Clear (cm_q2_traceExtents);
-	}
-	else {
-		cm_q2_traceIsPoint = false;
-		cm_q2_traceExtents[0] = -mins[0] > maxs[0] ? -mins[0] : maxs[0];
-		cm_q2_traceExtents[1] = -mins[1] > maxs[1] ? -mins[1] : maxs[1];
-		cm_q2_traceExtents[2] = -mins[2] > maxs[2] ? -mins[2] : maxs[2];
-	}
-
 	// General sweeping through world
 	CM_Q2BSP_RecursiveHullCheck (headNode, 0, 1, start, end);
 
@@ -91,6 +91,17 @@ struct cmQ3BspBrush_t
 	int					numSides;
 	int					firstBrushSide;
 	int					checkCount;		// to avoid repeated testings
+
+	float				*sidePlanes;	// patch facets only, CM_PACKED_PLANE_FLOATS per four sides
+};
+
+struct cmQ3BspPatchNode_t
+{
+	vec3_t				mins, maxs;
+
+	int					firstBrush;		// into the patch's brushes, leafs only
+	int					numBrushes;		// zero for interior nodes
+	int					skip;			// first node past this one's subtree
 };
 
 struct cmQ3BspPatch_t
@@ -100,6 +111,9 @@ struct cmQ3BspPatch_t
 	int					numBrushes;
 	cmQ3BspBrush_t		*brushes;
 
+	int					numNodes;		// depth first, nodes[0] is the whole patch
+	cmQ3BspPatchNode_t	*nodes;
+
 	cmBspSurface_t		*surface;
 	int					checkCount;		// to avoid repeated testings
 };
@@ -539,6 +539,132 @@ static void CM_Q3BSP_CreateBrush (cmQ3BspBrush_t *brush, vec3_t *verts, cmBspSur
 }
 
 
+/*
+===============
+CM_Q3BSP_CacheFacetPlanes
+
+Copies each facet's side planes into the packed layout CM_Q3BSP_FacetDists
+reads. The padding lanes stay zeroed and their results are never read.
+===============
+*/
+static void CM_Q3BSP_CacheFacetPlanes (cmQ3BspPatch_t *patch)
+{
+	int				i, j, numFloats;
+	float			*out;
+	cmQ3BspBrush_t	*brush;
+
+	numFloats = 0;
+	for (i=0, brush=patch->brushes ; i<patch->numBrushes ; i++, brush++)
+		numFloats += CM_PackedPlaneFloats (brush->numSides);
+	if (!numFloats)
+		return;
+
+	out = (float*)Mem_PoolAlloc (sizeof(float) * numFloats, com_cmodelSysPool, 0);
+	for (i=0, brush=patch->brushes ; i<patch->numBrushes ; i++, brush++) {
+		brush->sidePlanes = out;
+		for (j=0 ; j<brush->numSides ; j++)
+			CM_PackPlane (out + (j/SIMD_WIDTH)*CM_PACKED_PLANE_FLOATS, j%SIMD_WIDTH, cm_q3_brushSides[brush->firstBrushSide+j].plane);
+		out += CM_PackedPlaneFloats (brush->numSides);
+	}
+}
+
+
+/*
+===============
+CM_Q3BSP_BuildPatchNode
+
+Splits the facet grid in half along its longer side until each piece is
+small enough to test brute force. Facets are created in tree order so every
+leaf owns a contiguous run of the patch's brushes.
+===============
+*/
+#define CM_PATCH_LEAF_QUADS		2
+
+static void CM_Q3BSP_BuildPatchNode (cmQ3BspPatch_t *patch, vec4_t *points, int width, int u0, int v0, int u1, int v1)
+{
+	int					u, v, i;
+	cmQ3BspPatchNode_t	*node, *child;
+	cmQ3BspBrush_t		*brush;
+	vec3_t				tverts[4], tverts2[4];
+
+	node = &patch->nodes[patch->numNodes++];
+	ClearBounds (node->mins, node->maxs);
+
+	if ((u1 - u0) * (v1 - v0) <= CM_PATCH_LEAF_QUADS) {
+		node->firstBrush = patch->numBrushes;
+
+		for (v=v0 ; v<v1 ; v++) {
+			for (u=u0 ; u<u1 ; u++) {
+				if (cm_q3_numBrushes+2 > MAX_Q3BSP_CM_BRUSHES)
+					Com_Error (ERR_DROP, "CM_Q3BSP_CreatePatch: too many patch brushes");
+
+				i = v * width + u;
+				Vec3Copy (points[i], tverts[0]);
+				Vec3Copy (points[i + width], tverts[1]);
+				Vec3Copy (points[i + 1], tverts[2]);
+				Vec3Copy (points[i + width + 1], tverts[3]);
+
+				// Add to bounds
+				for (i=0 ; i<4 ; i++)
+					AddPointToBounds (tverts[i], node->mins, node->maxs);
+
+				// Create two brushes
+				brush = &patch->brushes[patch->numBrushes];
+				CM_Q3BSP_CreateBrush (brush, tverts, patch->surface);
+				brush->contents = patch->surface->contents;
+				cm_q3_numBrushes++;
+				patch->numBrushes++;
+
+				Vec3Copy (tverts[2], tverts2[0]);
+				Vec3Copy (tverts[1], tverts2[1]);
+				Vec3Copy (tverts[3], tverts2[2]);
+				brush++;
+				CM_Q3BSP_CreateBrush (brush, tverts2, patch->surface);
+				brush->contents = patch->surface->contents;
+				cm_q3_numBrushes++;
+				patch->numBrushes++;
+			}
+		}
+
+		node->numBrushes = patch->numBrushes - node->firstBrush;
+
+		// Clipping treats the facets as DIST_EPSILON thicker, so pad past that
+		for (i=0 ; i<3 ; i++) {
+			node->mins[i] -= 1;
+			node->maxs[i] += 1;
+		}
+	}
+	else {
+		node->firstBrush = 0;
+		node->numBrushes = 0;
+
+		child = &patch->nodes[patch->numNodes];
+		if (u1 - u0 >= v1 - v0) {
+			u = (u0 + u1) >> 1;
+			CM_Q3BSP_BuildPatchNode (patch, points, width, u0, v0, u, v1);
+			AddPointToBounds (child->mins, node->mins, node->maxs);
+			AddPointToBounds (child->maxs, node->mins, node->maxs);
+
+			child = &patch->nodes[patch->numNodes];
+			CM_Q3BSP_BuildPatchNode (patch, points, width, u, v0, u1, v1);
+		}
+		else {
+			v = (v0 + v1) >> 1;
+			CM_Q3BSP_BuildPatchNode (patch, points, width, u0, v0, u1, v);
+			AddPointToBounds (child->mins, node->mins, node->maxs);
+			AddPointToBounds (child->maxs, node->mins, node->maxs);
+
+			child = &patch->nodes[patch->numNodes];
+			CM_Q3BSP_BuildPatchNode (patch, points, width, u0, v, u1, v1);
+		}
+		AddPointToBounds (child->mins, node->mins, node->maxs);
+		AddPointToBounds (child->maxs, node->mins, node->maxs);
+	}
+
+	node->skip = patch->numNodes;
+}
+
+
 /*
 ===============
 CM_Q3BSP_CreatePatch
@@ -546,11 +672,8 @@ CM_Q3BSP_CreatePatch
 */
 static void CM_Q3BSP_CreatePatch (cmQ3BspPatch_t *patch, int numverts, vec4_t *verts, int *patch_cp)
 {
-    int			step[2], size[2], flat[2], i, u, v;
+    int			step[2], size[2], flat[2], i;
 	vec4_t		points[MAX_Q3BSP_CM_PATCH_VERTS];
-	vec3_t		tverts[4], tverts2[4];
-	cmQ3BspBrush_t	*brush;
-	plane_t		mainplane;
 
 	// Find the degree of subdivision in the u and v directions
 	Patch_GetFlatness2 (CM_SUBDIVLEVEL, verts, patch_cp, flat);
@@ -568,50 +691,20 @@ static void CM_Q3BSP_CreatePatch (cmQ3BspPatch_t *patch, int numverts, vec4_t *v
 	// Fill in
 	Patch_Evaluate2 (verts, patch_cp, step, points);
 
-	patch->brushes = brush = cm_q3_brushes + cm_q3_numBrushes;
+	patch->brushes = cm_q3_brushes + cm_q3_numBrushes;
 	patch->numBrushes = 0;
 
+	// Create a set of brushes, two per quad, under a tree over the grid
+	patch->nodes = (cmQ3BspPatchNode_t*)Mem_PoolAlloc (sizeof(cmQ3BspPatchNode_t) * Max<int>(1, 2 * (size[0]-1) * (size[1]-1)), com_cmodelSysPool, 0);
+	patch->numNodes = 0;
+	CM_Q3BSP_BuildPatchNode (patch, points, size[0], 0, 0, size[0]-1, size[1]-1);
+
+	// The patch bounds stay tight, only the tree nodes are padded
 	ClearBounds (patch->absMins, patch->absMaxs);
+	for (i=0 ; i<size[0]*size[1] ; i++)
+		AddPointToBounds (points[i], patch->absMins, patch->absMaxs);
 
-	// Create a set of brushes
-    for (v=0 ; v<size[1]-1 ; v++) {
-		for (u=0 ; u<size[0]-1 ; u++) {
-			if (cm_q3_numBrushes >= MAX_Q3BSP_CM_BRUSHES)
-				Com_Error (ERR_DROP, "CM_Q3BSP_CreatePatch: too many patch brushes");
-
-			i = v * size[0] + u;
-			Vec3Copy (points[i], tverts[0]);
-			Vec3Copy (points[i + size[0]], tverts[1]);
-			Vec3Copy (points[i + 1], tverts[2]);
-			Vec3Copy (points[i + size[0] + 1], tverts[3]);
-
-			// Add to bounds
-			AddPointToBounds (tverts[0], patch->absMins, patch->absMaxs);
-			AddPointToBounds (tverts[1], patch->absMins, patch->absMaxs);
-			AddPointToBounds (tverts[2], patch->absMins, patch->absMaxs);
-			AddPointToBounds (tverts[3], patch->absMins, patch->absMaxs);
-
-			PlaneFromPoints (tverts, &mainplane);
-
-			// Create two brushes
-			CM_Q3BSP_CreateBrush (brush, tverts, patch->surface);
-
-			brush->contents = patch->surface->contents;
-			brush++;
-			cm_q3_numBrushes++;
-			patch->numBrushes++;
-
-			Vec3Copy (tverts[2], tverts2[0]);
-			Vec3Copy (tverts[1], tverts2[1]);
-			Vec3Copy (tverts[3], tverts2[2]);
-			CM_Q3BSP_CreateBrush (brush, tverts2, patch->surface);
-
-			brush->contents = patch->surface->contents;
-			brush++;
-			cm_q3_numBrushes++;
-			patch->numBrushes++;
-		}
-    }
+	CM_Q3BSP_CacheFacetPlanes (patch);
 }
 
 // ==========================================================================
@@ -494,6 +494,195 @@ static void CM_Q3BSP_ClipBoxToBrush (cmQ3BspBrush_t *brush)
 }
 
 
+/*
+================
+CM_Q3BSP_FacetDists
+
+Distance of the box corner nearest each side plane, four sides at a time.
+The corner picks and the sum run in the same order as the signBits switch,
+so the results are bit for bit the same.
+================
+*/
+static void CM_Q3BSP_FacetDists (cmQ3BspBrush_t *brush, const vec3_t mins, const vec3_t maxs, float *dists)
+{
+	const float	*planes = brush->sidePlanes;
+	simdVec_t	zero, nx, ny, nz, d;
+	simdVec_t	mn[3], mx[3];
+	int			i;
+
+	zero = Simd_Zero ();
+	for (i=0 ; i<3 ; i++) {
+		mn[i] = Simd_Splat (mins[i]);
+		mx[i] = Simd_Splat (maxs[i]);
+	}
+
+	for (i=0 ; i<brush->numSides ; i+=SIMD_WIDTH, planes+=CM_PACKED_PLANE_FLOATS) {
+		nx = Simd_Load (planes);
+		ny = Simd_Load (planes + SIMD_WIDTH);
+		nz = Simd_Load (planes + SIMD_WIDTH*2);
+
+		d = Simd_Mul (nx, Simd_Select (Simd_CmpLT (nx, zero), mx[0], mn[0]));
+		d = Simd_Madd (ny, Simd_Select (Simd_CmpLT (ny, zero), mx[1], mn[1]), d);
+		d = Simd_Madd (nz, Simd_Select (Simd_CmpLT (nz, zero), mx[2], mn[2]), d);
+		Simd_Store (dists + i, Simd_Sub (d, Simd_Load (planes + SIMD_WIDTH*3)));
+	}
+}
+
+
+/*
+================
+CM_Q3BSP_ClipBoxToFacet
+
+CM_Q3BSP_ClipBoxToBrush for patch facets, with the side distances
+computed up front from the cached planes.
+================
+*/
+#define CM_FACET_MAX_SIDES	20
+
+static void CM_Q3BSP_ClipBoxToFacet (cmQ3BspBrush_t *brush)
+{
+	int				i;
+	plane_t			*clipPlane;
+	float			enterFrac, leaveFrac;
+	float			d1, d2;
+	bool			getOut, startOut;
+	float			f;
+	float			dists1[CM_FACET_MAX_SIDES], dists2[CM_FACET_MAX_SIDES];
+	cmQ3BspBrushSide_t *side, *leadSide;
+
+	if (!brush->numSides)
+		return;
+
+	cm_numBrushTraces++;
+	cm_numFacetTraces++;
+
+	CM_Q3BSP_FacetDists (brush, cm_q3_traceStartMins, cm_q3_traceStartMaxs, dists1);
+	CM_Q3BSP_FacetDists (brush, cm_q3_traceEndMins, cm_q3_traceEndMaxs, dists2);
+
+	enterFrac = -1;
+	leaveFrac = 1;
+	clipPlane = NULL;
+	getOut = false;
+	startOut = false;
+	leadSide = NULL;
+
+	for (i=0, side=&cm_q3_brushSides[brush->firstBrushSide] ; i<brush->numSides ; side++, i++) {
+		d1 = dists1[i];
+		d2 = dists2[i];
+
+		if (d2 > 0)
+			getOut = true;	// Endpoint is not in solid
+		if (d1 > 0)
+			startOut = true;
+
+		// If completely in front of face, no intersection
+		if (d1 > 0 && d2 >= d1)
+			return;
+		if (d1 <= 0 && d2 <= 0)
+			continue;
+
+		// Crosses face
+		f = d1 - d2;
+		if (f > 0) {
+			// Enter
+			f = (d1 - DIST_EPSILON) / f;
+			if (f > enterFrac) {
+				enterFrac = f;
+				clipPlane = side->plane;
+				leadSide = side;
+			}
+		}
+		else {
+			// Leave
+			f = (d1 + DIST_EPSILON) / f;
+			if (f < leaveFrac)
+				leaveFrac = f;
+		}
+	}
+
+	if (!startOut) {
+		// Original point was inside brush
+		cm_q3_currentTrace.startSolid = true;
+		if (!getOut)
+			cm_q3_currentTrace.allSolid = true;
+		return;
+	}
+
+	if (enterFrac-(1.0f/1024.0f) <= leaveFrac) {
+		if (enterFrac > -1 && enterFrac < cm_q3_currentTrace.fraction) {
+			if (enterFrac < 0)
+				enterFrac = 0;
+			cm_q3_currentTrace.fraction = enterFrac;
+			cm_q3_currentTrace.plane = *clipPlane;
+			cm_q3_currentTrace.surface = leadSide->surface;
+			cm_q3_currentTrace.contents = brush->contents;
+		}
+	}
+}
+
+
+/*
+================
+CM_Q3BSP_TestBoxInFacet
+================
+*/
+static void CM_Q3BSP_TestBoxInFacet (cmQ3BspBrush_t *brush)
+{
+	int		i;
+	float	dists[CM_FACET_MAX_SIDES];
+
+	if (!brush->numSides)
+		return;
+
+	cm_numFacetTraces++;
+
+	// If completely in front of any face, no intersection
+	CM_Q3BSP_FacetDists (brush, cm_q3_traceStartMins, cm_q3_traceStartMaxs, dists);
+	for (i=0 ; i<brush->numSides ; i++) {
+		if (dists[i] > 0)
+			return;
+	}
+
+	// Inside this brush
+	cm_q3_currentTrace.startSolid = cm_q3_currentTrace.allSolid = true;
+	cm_q3_currentTrace.fraction = 0;
+	cm_q3_currentTrace.contents = brush->contents;
+}
+
+
+/*
+================
+CM_Q3BSP_TracePatch
+
+Walks the patch's facet tree, skipping every subtree whose bounds miss the
+swept box, and hands the facets under the rest to func.
+================
+*/
+static void CM_Q3BSP_TracePatch (cmQ3BspPatch_t *patch, void (*func)(cmQ3BspBrush_t *brush))
+{
+	cmQ3BspPatchNode_t	*node, *end;
+	int					i;
+
+	cm_numPatchTraces++;
+
+	node = patch->nodes;
+	end = patch->nodes + patch->numNodes;
+	while (node < end) {
+		if (!BoundsIntersect (node->mins, node->maxs, cm_q3_traceAbsMins, cm_q3_traceAbsMaxs)) {
+			node = patch->nodes + node->skip;
+			continue;
+		}
+
+		for (i=0 ; i<node->numBrushes ; i++) {
+			func (&patch->brushes[node->firstBrush+i]);
+			if (!cm_q3_currentTrace.fraction)
+				return;
+		}
+		node++;
+	}
+}
+
+
 /*
 ================
 CM_Q3BSP_ClipBoxes
@@ -501,7 +690,7 @@ CM_Q3BSP_ClipBoxes
 */
 static void CM_Q3BSP_ClipBoxes (int leafNum)
 {
-	int			i, j;
+	int			i;
 	int			brushNum, patchNum;
 	cmQ3BspLeaf_t *leaf;
 	cmQ3BspBrush_t *brush;
@@ -543,11 +732,9 @@ static void CM_Q3BSP_ClipBoxes (int leafNum)
 		if (!BoundsIntersect(patch->absMins, patch->absMaxs, cm_q3_traceAbsMins, cm_q3_traceAbsMaxs))
 			continue;
 
-		for (j=0 ; j<patch->numBrushes ; j++) {
-			CM_Q3BSP_ClipBoxToBrush (&patch->brushes[j]);
-			if (!cm_q3_currentTrace.fraction)
-				return;
-		}
+		CM_Q3BSP_TracePatch (patch, cm_scalarClip ? CM_Q3BSP_ClipBoxToBrush : CM_Q3BSP_ClipBoxToFacet);
+		if (!cm_q3_currentTrace.fraction)
+			return;
 	}
 }
 
@@ -630,7 +817,7 @@ CM_Q3BSP_TestBoxInLeaf
 */
 static void CM_Q3BSP_TestBoxInLeaf (int leafNum)
 {
-	int			i, j;
+	int			i;
 	int			brushNum, patchNum;
 	cmQ3BspLeaf_t *leaf;
 	cmQ3BspBrush_t *brush;
@@ -672,11 +859,9 @@ static void CM_Q3BSP_TestBoxInLeaf (int leafNum)
 		if (!BoundsIntersect(patch->absMins, patch->absMaxs, cm_q3_traceAbsMins, cm_q3_traceAbsMaxs))
 			continue;
 
-		for (j=0 ; j<patch->numBrushes; j++) {
-			CM_Q3BSP_TestBoxInBrush (&patch->brushes[j]);
-			if (!cm_q3_currentTrace.fraction)
-				return;
-		}
+		CM_Q3BSP_TracePatch (patch, cm_scalarClip ? CM_Q3BSP_TestBoxInBrush : CM_Q3BSP_TestBoxInFacet);
+		if (!cm_q3_currentTrace.fraction)
+			return;
 	}
 }
 
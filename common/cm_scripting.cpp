@@ -2,23 +2,138 @@
 
 memPool_t *com_luaPool;
 
-static void *LuaAlloc (void *ud, void *ptr, size_t osize, size_t nsize)
+/*
+==============================================================================
+
+	LUA HEAP
+
+	Lua makes a great many small, short lived allocations (strings, tables,
+	closures), so each state gets a heap that carves anything up to
+	LUA_SLAB_MAX bytes out of 16k slabs and recycles it through per-size
+	free lists, instead of paying for a pool block header on every one.
+	Bigger blocks still go to the pool. The heap is also the allocator's
+	userdata, which is how a lua_State finds its Script without a search.
+==============================================================================
+*/
+
+#define LUA_SLAB_SIZE		16384
+#define LUA_SLAB_HEADER		16			// slab chain pointer, keeps blocks 16 byte aligned
+#define LUA_SLAB_GRAIN		16
+#define LUA_SLAB_MAX		256
+#define LUA_SLAB_CLASSES	(LUA_SLAB_MAX/LUA_SLAB_GRAIN)
+
+struct luaHeap_t
 {
-	(void)ud;  (void)osize;  /* not used */
+	Script		*script;
 
-	if (osize == 0 && nsize == 0)
-		return null;
-	else if (nsize == 0)
+	void		*freeLists[LUA_SLAB_CLASSES];
+	byte		*slabs;
+	byte		*slabPos;
+	byte		*slabEnd;
+};
+
+static inline int LuaHeap_Class (const size_t size)
+{
+	return (int)((size + LUA_SLAB_GRAIN - 1) / LUA_SLAB_GRAIN) - 1;
+}
+
+static void *LuaHeap_Alloc (luaHeap_t *heap, const size_t size)
+{
+	if (size > LUA_SLAB_MAX)
+		return Mem_PoolAlloc(size, com_luaPool, 0);
+
+	const int sizeClass = LuaHeap_Class(size);
+	void *block = heap->freeLists[sizeClass];
+	if (block)
+	{
+		heap->freeLists[sizeClass] = *(void**)block;
+		return block;
+	}
+
+	const size_t blockSize = (sizeClass + 1) * LUA_SLAB_GRAIN;
+	if (heap->slabPos + blockSize > heap->slabEnd)
+	{
+		// The tail of the old slab is at most LUA_SLAB_MAX bytes, let it go
+		byte *slab = (byte*)Mem_PoolAlloc(LUA_SLAB_SIZE, com_luaPool, 0);
+		*(byte**)slab = heap->slabs;
+		heap->slabs = slab;
+		heap->slabPos = slab + LUA_SLAB_HEADER;
+		heap->slabEnd = slab + LUA_SLAB_SIZE;
+	}
+
+	block = heap->slabPos;
+	heap->slabPos += blockSize;
+	return block;
+}
+
+static void LuaHeap_Free (luaHeap_t *heap, void *ptr, const size_t size)
+{
+	if (size > LUA_SLAB_MAX)
 	{
 		Mem_Free(ptr);
+		return;
+	}
+
+	const int sizeClass = LuaHeap_Class(size);
+	*(void**)ptr = heap->freeLists[sizeClass];
+	heap->freeLists[sizeClass] = ptr;
+}
+
+static luaHeap_t *LuaHeap_Create (Script *script)
+{
+	luaHeap_t *heap = (luaHeap_t*)Mem_PoolAlloc(sizeof(luaHeap_t), com_luaPool, 0);
+	memset(heap, 0, sizeof(luaHeap_t));
+	heap->script = script;
+	return heap;
+}
+
+// Only once the state is closed, every small block lives in a slab
+static void LuaHeap_Destroy (luaHeap_t *heap)
+{
+	while (heap->slabs)
+	{
+		byte *next = *(byte**)heap->slabs;
+		Mem_Free(heap->slabs);
+		heap->slabs = next;
+	}
+
+	Mem_Free(heap);
+}
+
+static void *LuaAlloc (void *ud, void *ptr, size_t osize, size_t nsize)
+{
+	luaHeap_t *heap = (luaHeap_t*)ud;
+
+	if (nsize == 0)
+	{
+		if (ptr)
+			LuaHeap_Free(heap, ptr, osize);
 		return null;
 	}
-	else if (nsize != 0 && osize == 0)
-		return Mem_PoolAlloc(nsize, com_luaPool, 0);
-	else
+
+	if (!ptr)
+		return LuaHeap_Alloc(heap, nsize);
+
+	// Stays in the same slab size, or both big enough for the pool
+	if (osize > LUA_SLAB_MAX && nsize > LUA_SLAB_MAX)
 		return Mem_ReAlloc(ptr, nsize);
+	if (osize <= LUA_SLAB_MAX && nsize <= LUA_SLAB_MAX && LuaHeap_Class(osize) == LuaHeap_Class(nsize))
+		return ptr;
+
+	void *block = LuaHeap_Alloc(heap, nsize);
+	memcpy(block, ptr, Min<size_t>(osize, nsize));
+	LuaHeap_Free(heap, ptr, osize);
+	return block;
 }
 
+/*
+==============================================================================
+
+	STATES
+
+==============================================================================
+*/
+
 TList<Script*> l_openStates;
 
 int Lua_Sys_Com_Printf (lua_State *s)
@@ -55,7 +170,11 @@ void Lua_Shutdown()
 {
 	for (uint32 i = 0; i < l_openStates.Count(); ++i)
 	{
+		void *heap;
+		lua_getallocf(l_openStates[i]->state, &heap);
+
 		lua_close(l_openStates[i]->state);
+		LuaHeap_Destroy((luaHeap_t*)heap);
 		delete l_openStates[i];
 	}
 
@@ -66,18 +185,10 @@ void Lua_Shutdown()
 
 Script *Lua_ScriptFromState (lua_State *state)
 {
-	Script *scr = null;
+	void *heap;
+	lua_getallocf(state, &heap);
 
-	for (uint32 i = 0; i < l_openStates.Count(); ++i)
-	{
-		if (l_openStates[i]->state == state)
-		{
-			scr = l_openStates[i];
-			break;
-		}
-	}
-
-	return scr;
+	return heap ? ((luaHeap_t*)heap)->script : null;
 }
 
 static const ScriptFunctionTable dblib[] = {
@@ -99,9 +210,9 @@ Script *Lua_CreateLuaState (const char *fileName)
 
 	Script *comState = new Script();
 
-	lua_State *state = lua_newstate(LuaAlloc, null);
+	luaHeap_t *heap = LuaHeap_Create(comState);
+	lua_State *state = lua_newstate(LuaAlloc, heap);
 	comState->state = state;
-	lua_setallocf(state, LuaAlloc, null);
 
 	lua_atpanic(state, Lua_Panic);
 
@@ -109,7 +220,12 @@ Script *Lua_CreateLuaState (const char *fileName)
 	int ret = FS_LoadFile(fileName, (void**)&buffer, false);
 
 	if (ret == -1) // needed?
+	{
+		lua_close(state);
+		LuaHeap_Destroy(heap);
+		delete comState;
 		return null;
+	}
 
 	if (luaL_loadbuffer(state, buffer, ret, Com_SkipPath((char *)fileName)) != 0)
 		Com_Printf (PRNT_ERROR, "Lua error: %s\n", lua_tostring(state, -1));
@@ -168,7 +284,11 @@ void Lua_RegisterGlobals (Script *state, const ScriptGlobalTable *list)
 
 void Lua_DestroyLuaState (Script *state)
 {
+	void *heap;
+	lua_getallocf(state->state, &heap);
+
 	l_openStates.Remove(state);
 	lua_close(state->state);
+	LuaHeap_Destroy((luaHeap_t*)heap);
 	delete state;
 }
\ No newline at end of file
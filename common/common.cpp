@@ -739,6 +739,7 @@ void Com_Init(int argc, char **argv)
 
 	// Init commands and vars
 	Mem_Register ();
+	CM_Register ();
 
 #ifdef _DEBUG
 	Cmd_AddCommand ("error",	0, Com_Error_f,	"Error out with a message");
@@ -130,6 +130,10 @@ char		*Sys_GetClipboardData ();
 
 void		Sys_Mkdir (char *path);
 
+// read-only file mapping, returns NULL if the file is missing or empty
+void		*Sys_MapFile (const char *path, size_t *size);
+void		Sys_UnmapFile (void *base, const size_t size);
+
 // pass in an attribute mask of things you wish to REJECT
 char		*Sys_FindFirst (char *path, uint32 mustHave, uint32 cantHave);
 char		*Sys_FindNext (uint32 mustHave, uint32 cantHave);
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "../lzma/7zCrc.h"
 #include "../lzma/7zFile.h"
 #include "../lzma/7zVersion.h"
+#include <sys/stat.h>
 
 #define FS_MAX_PAKS			1024
 #define FS_MAX_HASHSIZE		1024
@@ -265,6 +266,74 @@ int FS_ZLibDecompress (byte *in, int inLen, byte *out, int outLen, int wbits)
 }
 
 
+/*
+================
+FS_ZLibDecompressStream
+
+Same as FS_ZLibDecompress, but the inflate state lives in *stream and is only
+reset between calls, so its window and tables aren't rebuilt every time.
+Returns -1 on bad data rather than erroring, since the input may come off
+the network.
+================
+*/
+struct fsZStream_t
+{
+	z_stream	zs;
+	int			wbits;
+};
+
+int FS_ZLibDecompressStream (fsZStream_t **stream, byte *in, int inLen, byte *out, int outLen, int wbits)
+{
+	fsZStream_t	*s = *stream;
+	int			result;
+
+	if (s && s->wbits != wbits)
+		FS_ZLibFreeStream (stream);
+
+	if (!*stream) {
+		s = (fsZStream_t*)Mem_Alloc (sizeof(fsZStream_t));
+		memset (&s->zs, 0, sizeof(s->zs));
+		s->wbits = wbits;
+
+		result = inflateInit2 (&s->zs, wbits);
+		if (result != Z_OK) {
+			Sys_Error ("Error on inflateInit %d\nMessage: %s\n", result, s->zs.msg);
+			return -1;
+		}
+		*stream = s;
+	}
+	else
+		inflateReset (&s->zs);
+
+	s->zs.next_in = in;
+	s->zs.avail_in = inLen;
+	s->zs.next_out = out;
+	s->zs.avail_out = outLen;
+
+	result = inflate (&s->zs, Z_FINISH);
+	if (result != Z_STREAM_END)
+		return -1;
+
+	return s->zs.total_out;
+}
+
+
+/*
+================
+FS_ZLibFreeStream
+================
+*/
+void FS_ZLibFreeStream (fsZStream_t **stream)
+{
+	if (!*stream)
+		return;
+
+	inflateEnd (&(*stream)->zs);
+	Mem_Free (*stream);
+	*stream = NULL;
+}
+
+
 /*
 ================
 FS_ZLibCompressChunk
@@ -1108,6 +1177,85 @@ int FS_FileExists(const char *path)
 	return fileLen;
 }
 
+
+/*
+============
+FS_FileStamp
+
+Identifies the version of a file without reading it, for caches keyed on
+a source file. The stamp covers where the file was found, its length and
+the modification time of the file or of the package holding it. Returns
+the file length, or -1 if it isn't found.
+============
+*/
+int FS_FileStamp(const char *path, uint32 *stamp)
+{
+	struct
+	{
+		char		netPath[MAX_OSPATH];
+		int			filePos;
+		int			fileLen;
+		sint64		modified;
+	} key;
+	struct stat st;
+
+	memset(&key, 0, sizeof(key));
+	char name[MAX_QPATH];
+	Com_NormalizePath(name, sizeof(name), path);
+
+	// Links point straight at a file on disk
+	for (fsLink_t *link=fs_fileLinks ; link ; link=link->next)
+	{
+		if (!strncmp(name, link->from, link->fromLength))
+		{
+			Q_snprintfz(key.netPath, sizeof(key.netPath), "%s%s", link->to, name+link->fromLength);
+			break;
+		}
+	}
+
+	const uint32 hashValue = Com_HashFileName(name, FS_MAX_HASHSIZE);
+	for (fsPath_t *searchPath=fs_searchPaths ; searchPath && !key.netPath[0] ; searchPath=searchPath->next)
+	{
+		if (searchPath->package)
+		{
+			mPackBase_t *package = searchPath->package;
+			for (mPackFile_t *searchFile=package->fileHashTree[hashValue] ; searchFile ; searchFile=searchFile->hashNext)
+			{
+				if (Q_stricmp(searchFile->fileName, name))
+					continue;
+
+				// The package's own time covers every entry in it
+				if (stat(package->name, &st))
+					return -1;
+
+				Q_strncpyz(key.netPath, package->name, sizeof(key.netPath));
+				key.filePos = searchFile->filePos;
+				key.fileLen = searchFile->fileLen;
+				key.modified = (sint64)st.st_mtime;
+
+				*stamp = Com_BlockChecksum(&key, sizeof(key));
+				return key.fileLen;
+			}
+		}
+		else
+		{
+			char netPath[MAX_OSPATH];
+			Q_snprintfz(netPath, sizeof(netPath), "%s/%s", searchPath->pathName, name);
+			if (!stat(netPath, &st))
+				Q_strncpyz(key.netPath, netPath, sizeof(key.netPath));
+		}
+	}
+
+	if (!key.netPath[0] || stat(key.netPath, &st) || !(st.st_mode & S_IFREG))
+		return -1;
+
+	key.fileLen = (int)st.st_size;
+	key.modified = (sint64)st.st_mtime;
+
+	*stamp = Com_BlockChecksum(&key, sizeof(key));
+	return key.fileLen;
+}
+
 /*
 =============================================================================
 
@@ -797,6 +797,8 @@ struct dQ3BspGridLight_t {
 #define FS_FreeFileList(list) _FS_FreeFileList ((list),__FILE__,__LINE__)
 
 int FS_ZLibDecompress(byte *in, int inlen, byte *out, int outlen, int wbits);
+int FS_ZLibDecompressStream(struct fsZStream_t **stream, byte *in, int inLen, byte *out, int outLen, int wbits);
+void FS_ZLibFreeStream(struct fsZStream_t **stream);
 int FS_ZLibCompressChunk(byte *in, int len_in, byte *out, int len_out, int method, int wbits);
 
 void FS_CreatePath(char *path);
@@ -818,6 +820,7 @@ int FS_LoadFile(const char *path, void **buffer, bool const terminate);
 void _FS_FreeFile(void *buffer, const char *fileName, const int fileLine);
 
 int FS_FileExists(const char *path);
+int FS_FileStamp(const char *path, uint32 *stamp);
 
 const char *FS_Gamedir();
 void FS_SetGamedir(char *dir, bool firstTime);
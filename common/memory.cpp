@@ -66,6 +66,8 @@ struct memPool_t
 static memPool_t		m_poolList[MEM_MAX_POOL_COUNT];
 static uint32			m_numPools;
 
+memCounters_t			com_memCounters;
+
 #define MEM_MAX_PUDDLES			42
 #define MEM_MAX_PUDDLE_SIZE		(32768+1)
 
@@ -425,6 +427,7 @@ uint32 _Mem_Free (const void *ptr, const char *fileName, const int fileLine)
 	mem->pool->blockCount--;
 	mem->pool->byteCount -= mem->realSize;
 	size = mem->realSize;
+	com_memCounters.numFrees++;
 
 	// De-link it
 	mem->next->prev = mem->prev;
@@ -565,6 +568,8 @@ void *_Mem_Alloc(size_t size, struct memPool_t *pool, const int tagNum, const ch
 	// For integrity checking and stats
 	pool->blockCount++;
 	pool->byteCount += mem->realSize;
+	com_memCounters.numAllocs++;
+	com_memCounters.allocBytes += mem->realSize;
 
 	// Link it in to the appropriate pool
 	mem->prev = &pool->blockHeadNode;
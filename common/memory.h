@@ -70,6 +70,16 @@ void		_Mem_TouchGlobal(const char *fileName, const int fileLine);
 void		Mem_Register();
 void		Mem_Init();
 
+// Running totals across every pool, for benchmarks
+struct memCounters_t
+{
+	uint32		numAllocs;
+	uint32		numFrees;
+	uint64		allocBytes;
+};
+
+extern memCounters_t	com_memCounters;
+
 // But allow these!
 inline void *operator new(size_t Size, struct memPool_t *Pool, const int TagNum, const char *FileName, const int FileLine)
 {
@@ -277,6 +277,225 @@ int range (edict_t *self, edict_t *other)
 	return RANGE_FAR;
 }
 
+/*
+=============================================================================
+
+	VISIBILITY CACHE
+
+	Line of sight results are kept for the rest of the frame, keyed on the
+	edict pair and on both link counts, so a pair that is asked about again
+	without either side being relinked costs a table lookup instead of a
+	trace. Entries from earlier frames are simply ignored.
+
+=============================================================================
+*/
+
+#define VIS_CACHE_SIZE		4096	// must be a power of two
+#define VIS_CACHE_MASK		(VIS_CACHE_SIZE-1)
+
+struct visCacheEntry_t
+{
+	int			framenum;
+	int			selfNum, otherNum;
+	int			selfLinkCount, otherLinkCount;
+	bool		bVisible;
+};
+
+static visCacheEntry_t	ai_visCache[VIS_CACHE_SIZE];
+
+static struct visStats_t
+{
+	uint32		numHits;
+	uint32		numTraces;
+	uint32		numBatched;
+	uint32		numPVSRejects;
+} ai_visStats;
+
+/*
+=============
+AI_ClearVisCache
+
+Called on every map change, since frame numbers and link counts both
+start over.
+=============
+*/
+void AI_ClearVisCache ()
+{
+	memset (ai_visCache, 0, sizeof(ai_visCache));
+	memset (&ai_visStats, 0, sizeof(ai_visStats));
+}
+
+static inline visCacheEntry_t *AI_VisCacheEntry (const int selfNum, const int otherNum)
+{
+	return &ai_visCache[(selfNum * 31 + otherNum * 1021) & VIS_CACHE_MASK];
+}
+
+static inline bool AI_VisCacheValid (const visCacheEntry_t *entry, const edict_t *self, const edict_t *other, const int selfNum, const int otherNum)
+{
+	return (entry->framenum == level.framenum
+		&& entry->selfNum == selfNum
+		&& entry->otherNum == otherNum
+		&& entry->selfLinkCount == self->linkCount
+		&& entry->otherLinkCount == other->linkCount);
+}
+
+static inline void AI_VisCacheStore (visCacheEntry_t *entry, const edict_t *self, const edict_t *other, const int selfNum, const int otherNum, const bool bVisible)
+{
+	entry->framenum = level.framenum;
+	entry->selfNum = selfNum;
+	entry->otherNum = otherNum;
+	entry->selfLinkCount = self->linkCount;
+	entry->otherLinkCount = other->linkCount;
+	entry->bVisible = bVisible;
+}
+
+static inline void AI_EyeSpots (edict_t *self, edict_t *other, vec3_t spot1, vec3_t spot2)
+{
+	Vec3Copy (self->s.origin, spot1);
+	spot1[2] += self->viewheight;
+	Vec3Copy (other->s.origin, spot2);
+	spot2[2] += other->viewheight;
+}
+
+
+/*
+=============
+AI_VisibleBatch
+
+Resolves line of sight for a set of viewer/target pairs ahead of the think
+functions that will ask for it. Pairs already cached are skipped, pairs
+whose eyes are not in each other's PVS are answered without a trace, and
+only the rest are traced. Results land in the visibility cache.
+=============
+*/
+void AI_VisibleBatch (edict_t **viewers, edict_t **targets, const int numPairs)
+{
+	static int	traceList[MAX_CS_EDICTS];
+	static vec3_t	traceSpots[MAX_CS_EDICTS][2];
+	int			numTrace = 0;
+
+	// Cheap rejection first
+	for (int i=0 ; i<numPairs ; i++)
+	{
+		edict_t *self = viewers[i];
+		edict_t *other = targets[i];
+		const int selfNum = self - g_edicts;
+		const int otherNum = other - g_edicts;
+
+		visCacheEntry_t *entry = AI_VisCacheEntry (selfNum, otherNum);
+		if (AI_VisCacheValid (entry, self, other, selfNum, otherNum))
+			continue;
+
+		vec3_t spot1, spot2;
+		AI_EyeSpots (self, other, spot1, spot2);
+		if (!gi.inPVS (spot1, spot2))
+		{
+			AI_VisCacheStore (entry, self, other, selfNum, otherNum, false);
+			ai_visStats.numPVSRejects++;
+			continue;
+		}
+
+		if (numTrace == MAX_CS_EDICTS)
+			break;
+		Vec3Copy (spot1, traceSpots[numTrace][0]);
+		Vec3Copy (spot2, traceSpots[numTrace][1]);
+		traceList[numTrace++] = i;
+	}
+
+	// Then the traces that are left
+	for (int i=0 ; i<numTrace ; i++)
+	{
+		edict_t *self = viewers[traceList[i]];
+		edict_t *other = targets[traceList[i]];
+		const int selfNum = self - g_edicts;
+		const int otherNum = other - g_edicts;
+
+		cmTrace_t trace = gi.trace (traceSpots[i][0], vec3Origin, vec3Origin, traceSpots[i][1], self, CONTENTS_MASK_OPAQUE);
+		AI_VisCacheStore (AI_VisCacheEntry (selfNum, otherNum), self, other, selfNum, otherNum, (trace.fraction == 1.0));
+	}
+
+	ai_visStats.numBatched += numTrace;
+}
+
+
+/*
+=============
+AI_PrepareSight
+
+Called once each frame after AI_SetSightClient. Gathers the monsters that
+will think this frame and are certain to ask for line of sight to their
+enemy or to the sight client, and batches those queries up front. The
+filters mirror ai_checkattack and FindTarget; anything they miss just
+falls back to a trace in visible ().
+=============
+*/
+void AI_PrepareSight ()
+{
+	static edict_t	*viewers[MAX_CS_EDICTS];
+	static edict_t	*targets[MAX_CS_EDICTS];
+	int				numPairs = 0;
+
+	edict_t *sightClient = level.sight_client;
+	if (sightClient && (!sightClient->inUse || sightClient->light_level <= 5 || (sightClient->flags & FL_NOTARGET)))
+		sightClient = NULL;
+
+	// FindTarget looks at these before the sight client
+	if (level.sight_entity_framenum >= (level.framenum - 1)
+	|| level.sound_entity_framenum >= (level.framenum - 1)
+	|| level.sound2_entity_framenum >= (level.framenum - 1))
+		sightClient = NULL;
+
+	edict_t *ent = &g_edicts[game.maxclients+1];
+	for (int i=game.maxclients+1 ; i<globals.numEdicts ; i++, ent++)
+	{
+		if (!ent->inUse || !(ent->svFlags & SVF_MONSTER) || ent->health <= 0)
+			continue;
+		if (ent->nextthink <= 0 || ent->nextthink > level.time+0.001)
+			continue;
+
+		edict_t *target;
+		if (ent->enemy)
+		{
+			if (!ent->enemy->inUse || ent->enemy->health <= 0)
+				continue;
+			if (ent->monsterinfo.aiflags & (AI_COMBAT_POINT|AI_SOUND_TARGET|AI_MEDIC))
+				continue;
+			target = ent->enemy;
+		}
+		else
+		{
+			if (!sightClient)
+				continue;
+			if (ent->monsterinfo.aiflags & (AI_GOOD_GUY|AI_COMBAT_POINT))
+				continue;
+			if (range (ent, sightClient) == RANGE_FAR)
+				continue;
+			target = sightClient;
+		}
+
+		if (numPairs == MAX_CS_EDICTS)
+			break;
+		viewers[numPairs] = ent;
+		targets[numPairs] = target;
+		numPairs++;
+	}
+
+	AI_VisibleBatch (viewers, targets, numPairs);
+}
+
+
+/*
+=============
+AI_PrintVisStats
+=============
+*/
+void AI_PrintVisStats ()
+{
+	gi.cprintf (NULL, PRINT_HIGH, "%u cache hits, %u traces (%u batched), %u PVS rejects\n",
+		ai_visStats.numHits, ai_visStats.numTraces + ai_visStats.numBatched, ai_visStats.numBatched, ai_visStats.numPVSRejects);
+}
+
+
 /*
 =============
 visible
@@ -290,15 +509,21 @@ bool visible (edict_t *self, edict_t *other)
 	vec3_t	spot2;
 	cmTrace_t	trace;
 
-	Vec3Copy (self->s.origin, spot1);
-	spot1[2] += self->viewheight;
-	Vec3Copy (other->s.origin, spot2);
-	spot2[2] += other->viewheight;
+	const int selfNum = self - g_edicts;
+	const int otherNum = other - g_edicts;
+	visCacheEntry_t *entry = AI_VisCacheEntry (selfNum, otherNum);
+	if (AI_VisCacheValid (entry, self, other, selfNum, otherNum))
+	{
+		ai_visStats.numHits++;
+		return entry->bVisible;
+	}
+
+	AI_EyeSpots (self, other, spot1, spot2);
 	trace = gi.trace (spot1, vec3Origin, vec3Origin, spot2, self, CONTENTS_MASK_OPAQUE);
-	
-	if (trace.fraction == 1.0)
-		return true;
-	return false;
+	ai_visStats.numTraces++;
+
+	AI_VisCacheStore (entry, self, other, selfNum, otherNum, (trace.fraction == 1.0));
+	return entry->bVisible;
 }
 
 
@@ -379,7 +604,7 @@ void FoundTarget (edict_t *self)
 	self->monsterinfo.aiflags |= AI_COMBAT_POINT;
 
 	// clear the targetname, that point is ours!
-	self->movetarget->targetname = NULL;
+	G_SetEdictKey (self->movetarget, EK_TARGETNAME, NULL);
 	self->monsterinfo.pausetime = 0;
 
 	// run for it
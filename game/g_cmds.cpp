@@ -234,7 +234,7 @@ void Cmd_Give_f (edict_t *ent)
 	{
 		it = FindItem("Power Shield");
 		it_ent = G_Spawn();
-		it_ent->classname = it->classname;
+		G_SetEdictKey (it_ent, EK_CLASSNAME, it->classname);
 		SpawnItem (it_ent, it);
 		Touch_Item (it_ent, ent, NULL, NULL);
 		if (it_ent->inUse)
@@ -288,7 +288,7 @@ void Cmd_Give_f (edict_t *ent)
 	else
 	{
 		it_ent = G_Spawn();
-		it_ent->classname = it->classname;
+		G_SetEdictKey (it_ent, EK_CLASSNAME, it->classname);
 		SpawnItem (it_ent, it);
 		Touch_Item (it_ent, ent, NULL, NULL);
 		if (it_ent->inUse)
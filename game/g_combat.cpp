@@ -548,12 +548,18 @@ T_RadiusDamage
 void T_RadiusDamage (edict_t *inflictor, edict_t *attacker, float damage, edict_t *ignore, float radius, int mod)
 {
 	float	points;
-	edict_t	*ent = NULL;
+	edict_t	*ent;
 	vec3_t	v;
 	vec3_t	dir;
+	edict_t	*hits[MAX_RADIUS_EDICTS];
 
-	while ((ent = findradius(ent, inflictor->s.origin, radius)) != NULL)
+	const int numHits = G_FindRadius (inflictor->s.origin, radius, hits, MAX_RADIUS_EDICTS);
+	for (int i=0 ; i<numHits ; i++)
 	{
+		// an earlier hit may have taken this one out
+		ent = hits[i];
+		if (!ent->inUse)
+			continue;
 		if (ent == ignore)
 			continue;
 		if (!ent->takedamage)
@@ -1441,7 +1441,7 @@ void SP_func_water (edict_t *self)
 	if (self->wait == -1)
 		self->spawnflags |= DOOR_TOGGLE;
 
-	self->classname = "func_door";
+	G_SetEdictKey (self, EK_CLASSNAME, "func_door");
 
 	gi.linkentity (self);
 }
@@ -2033,7 +2033,7 @@ void SP_func_door_secret (edict_t *ent)
 		ent->touch = door_touch;
 	}
 	
-	ent->classname = "func_door";
+	G_SetEdictKey (ent, EK_CLASSNAME, "func_door");
 
 	gi.linkentity (ent);
 }
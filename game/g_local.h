@@ -504,6 +504,28 @@ struct field_t
 
 extern	field_t fields[];
 
+//
+// g_save.c
+//
+struct saveBuffer_t
+{
+	byte		*data;
+	size_t		size;
+	size_t		maxSize;
+};
+
+struct saveReader_t
+{
+	byte		*data;
+	size_t		size;
+	size_t		pos;
+};
+
+void Save_Write (saveBuffer_t *buf, const void *data, const size_t size);
+void Save_Read (saveReader_t *in, void *data, const size_t size);
+void Save_Error (saveReader_t *in, const char *message);
+void G_FlushSaves ();
+
 
 //
 // g_cmds.c
@@ -532,7 +554,27 @@ void Touch_Item (edict_t *ent, edict_t *other, plane_t *plane, cmBspSurface_t *s
 bool	KillBox (edict_t *ent);
 void	G_ProjectSource (vec3_t point, vec3_t distance, vec3_t forward, vec3_t right, vec3_t result);
 edict_t *G_Find (edict_t *from, int fieldofs, char *match);
+
+enum EEdictKey
+{
+	EK_CLASSNAME,
+	EK_TARGETNAME,
+	EK_TEAM,
+
+	EK_MAX
+};
+
+void	G_InitEdictIndex ();
+void	G_ClearEdictIndex ();
+void	G_RebuildEdictIndex ();
+void	G_ReindexEdict (edict_t *ent);
+void	G_SetEdictKey (edict_t *ent, EEdictKey key, const char *value);
+edict_t *G_FindByKey (edict_t *from, EEdictKey key, const char *match);
+
 edict_t *findradius (edict_t *from, vec3_t org, float rad);
+
+#define MAX_RADIUS_EDICTS	512
+int		G_FindRadius (vec3_t org, float rad, edict_t **list, int maxList);
 edict_t *G_PickTarget (char *targetname);
 void	G_UseTargets (edict_t *ent, edict_t *activator);
 void	G_SetMovedir (vec3_t angles, vec3_t movedir);
@@ -540,6 +582,9 @@ void	G_SetMovedir (vec3_t angles, vec3_t movedir);
 void	G_InitEdict (edict_t *e);
 edict_t	*G_Spawn ();
 void	G_FreeEdict (edict_t *e);
+void	G_InitEdictAllocator ();
+void	G_ResetEdictAllocator (bool bRebuild);
+void	G_PrintEdictStats ();
 void	RemovePhysBody (edict_t *ent);
 
 void	G_TouchTriggers (edict_t *ent);
@@ -600,6 +645,10 @@ void BecomeExplosion1(edict_t *self);
 // g_ai.c
 //
 void AI_SetSightClient ();
+void AI_ClearVisCache ();
+void AI_VisibleBatch (edict_t **viewers, edict_t **targets, const int numPairs);
+void AI_PrepareSight ();
+void AI_PrintVisStats ();
 
 void ai_stand (edict_t *self, float dist);
 void ai_move (edict_t *self, float dist);
@@ -684,6 +733,8 @@ void PlayerNoise(edict_t *who, vec3_t where, int type);
 //
 // m_move.c
 //
+void M_ClearMoveCache ();
+void M_PrintMoveStats ();
 bool M_CheckBottom (edict_t *ent);
 bool M_walkmove (edict_t *ent, float yaw, float dist);
 void M_MoveToGoal (edict_t *ent, float dist);
@@ -1022,6 +1073,8 @@ void ConvertToEntityEvent (edict_t *entity, byte ID, const entityParms_t &parms,
 int IndexFromModelIndex (const String &modelIndex);
 void Phys_SetBModelOnEntity (edict_t *entity, class btCompoundShape *shape);
 class btCompoundShape *GetBModelShape (int index);
+void Phys_WriteState (saveBuffer_t *buf);
+void Phys_ReadState (saveReader_t *in);
 void G_SetClientAnimation (edict_t *ent, int anim, int animTime, bool force);
 
 
@@ -137,6 +137,8 @@ void ShutdownGame ()
 {
 	gi.dprintf ("==== ShutdownGame ====\n");
 
+	G_FlushSaves ();
+
 	gi.FreeTags (TAG_LEVEL);
 	gi.FreeTags (TAG_GAME);
 }
@@ -261,7 +263,7 @@ edict_t *CreateTargetChangeLevel(char *map)
 	edict_t *ent;
 
 	ent = G_Spawn ();
-	ent->classname = "target_changelevel";
+	G_SetEdictKey (ent, EK_CLASSNAME, "target_changelevel");
 	Q_snprintfz(level.nextmap, sizeof(level.nextmap), "%s", map);
 	ent->map = level.nextmap;
 	return ent;
@@ -468,6 +470,9 @@ void G_RunFrame ()
 		}
 	}
 
+	// batch up the line of sight checks the monsters are about to make
+	AI_PrepareSight ();
+
 	//
 	// treat each object in turn
 	// even the world gets a chance to think
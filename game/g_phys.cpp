@@ -1168,6 +1168,8 @@ struct BModel
 	int				Index;
 	btCompoundShape	*Shape;
 	TList<edict_t*>	Users;
+	TList<btRigidBody*>	Bodies;		// parallel to Users
+	TList<String>	Classnames;	// parallel to Users, to spot a reused slot on load
 	bool			Rigid;
 };
 	
@@ -1247,6 +1249,8 @@ void Phys_SetBModelOnEntity (edict_t *entity, btCompoundShape *shape)
 		body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
 		body->setActivationState(DISABLE_DEACTIVATION);
 		model.Users.Add(entity);
+		model.Bodies.Add(body);
+		model.Classnames.Add(String(entity->classname ? entity->classname : ""));
 		entity->physicBody = body;
 	}
 
@@ -1340,8 +1344,13 @@ btRigidBody*	localCreateRigidBody(float mass, const btTransform& startTransform,
 
 btRigidBody **playerBodies;
 
+void Phys_ClearLists ();
+
 void CG_PhysInit ()
 {
+	// nothing from the last map's world carries over
+	Phys_ClearLists ();
+
 	sphereShape = new btSphereShape(2.15f * WORLDSCALE);
 	physicsConfig = new btDefaultCollisionConfiguration();
 
@@ -2066,9 +2075,16 @@ public:
 	}
 };
 
-#include <queue>
+#include <deque>
+
+std::deque<RagDoll*> ragdolls;
 
-std::queue<RagDoll*> ragdolls;
+void Phys_ClearLists ()
+{
+	tempBody.clear();
+	bmodels.Clear();
+	ragdolls.clear();
+}
 
 void FreeRagdoll (RagDoll *raggy)
 {
@@ -2153,11 +2169,11 @@ void SetAsRagdoll (edict_t *player)
 	if (player->client)
 		player->client->chaseEntity = (edict_t*)raggy->m_bodies[RAG_HEAD]->getUserPointer();
 
-	ragdolls.push(raggy);
+	ragdolls.push_back(raggy);
 	if (ragdolls.size() > 4)
 	{
 		FreeRagdoll(ragdolls.front());
-		ragdolls.pop();
+		ragdolls.pop_front();
 	}
 
 	for (int i = 0; i < RAG_COUNT; ++i)
@@ -2242,7 +2258,7 @@ void fire_physgrenade (edict_t *self, vec3_t start, vec3_t aimdir, int damage, i
 	body.refEntity->think = PhysGrenade_Explode;
 	body.refEntity->dmg = damage;
 	body.refEntity->dmg_radius = damage_radius;
-	body.refEntity->classname = "grenade";
+	G_SetEdictKey (body.refEntity, EK_CLASSNAME, "grenade");
 
 	gi.linkentity (body.refEntity);
 }
@@ -2277,7 +2293,7 @@ void fire_physgrenade2 (edict_t *self, vec3_t start, vec3_t aimdir, int damage,
 	body.refEntity->think = PhysGrenade_Explode;
 	body.refEntity->dmg = damage;
 	body.refEntity->dmg_radius = damage_radius;
-	body.refEntity->classname = "hgrenade";
+	G_SetEdictKey (body.refEntity, EK_CLASSNAME, "hgrenade");
 	if (held)
 		body.refEntity->spawnflags = 3;
 	else
@@ -2409,7 +2425,7 @@ edict_t *Drop_Physics_Item (edict_t *ent, gitem_t *item)
 	body.body->setFriction(0.65f);
 	body.body->setRestitution(0.05f);
 
-	body.refEntity->classname = item->classname;
+	G_SetEdictKey (body.refEntity, EK_CLASSNAME, item->classname);
 	body.refEntity->item = item;
 	body.refEntity->spawnflags = DROPPED_ITEM;
 	Vec3Set (body.refEntity->mins, -15, -15, -15);
@@ -2530,3 +2546,355 @@ void Phys_Reset()
 		}
 	}
 }
+
+/*
+ *
+ * SAVED PHYSICS STATE
+ *
+ * Written after the entities in a level save. SpawnEntities has already
+ * rebuilt the bodies that come from the map by the time it's read back, so
+ * those just get their state put back; bodies spawned during play are
+ * created again from the shape they were using. Ragdolls aren't saved as
+ * entities at all, they're rebuilt whole and then posed.
+ *
+ */
+
+enum
+{
+	PSHAPE_NONE,
+	PSHAPE_SPHERE,
+	PSHAPE_BMODEL,
+	PSHAPE_MODEL
+};
+
+struct physBodyState_t
+{
+	float		origin[3];
+	float		quat[4];
+	float		linearVelocity[3];
+	float		angularVelocity[3];
+	int			activationState;
+};
+
+struct physSaveBody_t
+{
+	int				entNum;
+	int				shapeType;
+	int				bmodelIndex;
+	char			model[MAX_QPATH];
+
+	float			mass;
+	float			friction;
+	float			restitution;
+	float			linearDamping, angularDamping;
+	float			normalLinearDamping, normalAngularDamping;
+
+	bool			bCanReset;
+	float			resetOrigin[3];
+	float			resetQuat[4];
+
+	physBodyState_t	state;
+};
+
+struct physSaveRagdoll_t
+{
+	int				playerNum;
+	int				modelIndex[RAG_COUNT];		// KillRag points the parts at their player
+	physBodyState_t	parts[RAG_COUNT];
+};
+
+static void Phys_GetTransform (const btTransform &trans, float *origin, float *quat)
+{
+	const btVector3 &org = trans.getOrigin();
+	const btQuaternion rot = trans.getRotation();
+
+	origin[0] = org.x(); origin[1] = org.y(); origin[2] = org.z();
+	quat[0] = rot.x(); quat[1] = rot.y(); quat[2] = rot.z(); quat[3] = rot.w();
+}
+
+static btTransform Phys_MakeTransform (const float *origin, const float *quat)
+{
+	btTransform trans;
+	trans.setIdentity();
+	trans.setOrigin(btVector3(origin[0], origin[1], origin[2]));
+	trans.setRotation(btQuaternion(quat[0], quat[1], quat[2], quat[3]));
+	return trans;
+}
+
+static void Phys_GetBodyState (myRigidBody *body, physBodyState_t &st)
+{
+	Phys_GetTransform(body->getWorldTransform(), st.origin, st.quat);
+
+	const btVector3 &lin = body->getLinearVelocity();
+	const btVector3 &ang = body->getAngularVelocity();
+	Vec3Set(st.linearVelocity, lin.x(), lin.y(), lin.z());
+	Vec3Set(st.angularVelocity, ang.x(), ang.y(), ang.z());
+	st.activationState = body->getActivationState();
+}
+
+static void Phys_SetBodyState (myRigidBody *body, const physBodyState_t &st)
+{
+	var trans = Phys_MakeTransform(st.origin, st.quat);
+
+	body->setWorldTransform(trans);
+	body->setInterpolationWorldTransform(trans);
+	body->getMotionState()->setWorldTransform(trans);
+
+	body->setLinearVelocity(btVector3(st.linearVelocity[0], st.linearVelocity[1], st.linearVelocity[2]));
+	body->setAngularVelocity(btVector3(st.angularVelocity[0], st.angularVelocity[1], st.angularVelocity[2]));
+	body->setInterpolationLinearVelocity(body->getLinearVelocity());
+	body->setInterpolationAngularVelocity(body->getAngularVelocity());
+	body->forceActivationState(st.activationState);
+}
+
+static bool Phys_GetShapeInfo (btCollisionShape *shape, physSaveBody_t &save)
+{
+	if (shape == sphereShape)
+	{
+		save.shapeType = PSHAPE_SPHERE;
+		return true;
+	}
+
+	if (shape->getShapeType() == COMPOUND_SHAPE_PROXYTYPE)
+	{
+		const uint32 index = (uint32)reinterpret_cast<size_t>(shape->getUserPointer());
+		if (index < bmodels.Count() && bmodels[index].Shape == shape)
+		{
+			save.shapeType = PSHAPE_BMODEL;
+			save.bmodelIndex = bmodels[index].Index;
+			return true;
+		}
+	}
+
+	for (size_t i = 0; i < shapes.size(); ++i)
+	{
+		if (shapes[i].second == shape)
+		{
+			save.shapeType = PSHAPE_MODEL;
+			Q_strncpyz(save.model, shapes[i].first.c_str(), sizeof(save.model));
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static btCollisionShape *Phys_GetSavedShape (const physSaveBody_t &save)
+{
+	switch (save.shapeType)
+	{
+	case PSHAPE_SPHERE:
+		return sphereShape;
+	case PSHAPE_BMODEL:
+		return GetBModelShape(save.bmodelIndex);
+	case PSHAPE_MODEL:
+		return GetConvexShape(save.model);
+	}
+
+	return null;
+}
+
+static void Phys_RemoveTempBody (uint32 index)
+{
+	var body = tempBody[index].body;
+
+	physicsWorld->removeRigidBody(body);
+	delete body->getMotionState();
+	delete body;
+	tempBody.erase(tempBody.begin()+index);
+}
+
+/*
+===============
+Phys_WriteState
+===============
+*/
+void Phys_WriteState (saveBuffer_t *buf)
+{
+	TList<physSaveBody_t> bodies;
+
+	for (uint32 i = 0; i < tempBody.size(); ++i)
+	{
+		var ent = tempBody[i].refEntity;
+		if (!ent->inUse || (ent->s.type & ET_RAGDOLL))
+			continue;
+
+		var body = tempBody[i].body;
+		var state = (QuakeBodyMotionState*)body->getMotionState();
+
+		physSaveBody_t save;
+		memset(&save, 0, sizeof(save));
+		save.entNum = ent - g_edicts;
+		Phys_GetShapeInfo(body->getCollisionShape(), save);
+
+		save.mass = (body->getInvMass() != 0) ? 1.0f / body->getInvMass() : 0;
+		save.friction = body->getFriction();
+		save.restitution = body->getRestitution();
+		save.linearDamping = body->getLinearDamping();
+		save.angularDamping = body->getAngularDamping();
+		save.normalLinearDamping = body->getNormalLinearDamping();
+		save.normalAngularDamping = body->getNormalAngularDamping();
+
+		save.bCanReset = state->canReset;
+		if (state->canReset)
+			Phys_GetTransform(state->resetPosition, save.resetOrigin, save.resetQuat);
+
+		Phys_GetBodyState(body, save.state);
+		bodies.Add(save);
+	}
+
+	int count = bodies.Count();
+	Save_Write(buf, &count, sizeof(count));
+	if (count)
+		Save_Write(buf, bodies.Array(), count * sizeof(physSaveBody_t));
+
+	count = ragdolls.size();
+	Save_Write(buf, &count, sizeof(count));
+	for (size_t i = 0; i < ragdolls.size(); ++i)
+	{
+		var raggy = ragdolls[i];
+
+		physSaveRagdoll_t save;
+		memset(&save, 0, sizeof(save));
+		save.playerNum = raggy->playerNum;
+		for (int j = 0; j < RAG_COUNT; ++j)
+		{
+			save.modelIndex[j] = ((edict_t*)raggy->m_bodies[j]->getUserPointer())->s.modelIndex;
+			Phys_GetBodyState(raggy->m_bodies[j], save.parts[j]);
+		}
+
+		Save_Write(buf, &save, sizeof(save));
+	}
+}
+
+/*
+===============
+Phys_ReadState
+===============
+*/
+void Phys_ReadState (saveReader_t *in)
+{
+	int count;
+
+	// the kinematic brush model bodies were made by SpawnEntities, and the
+	// edicts read over their pointers. A user freed before the save, or its
+	// slot reused by something else, loses its body.
+	for (uint32 i = 0; i < bmodels.Count(); ++i)
+	{
+		BModel &model = bmodels[i];
+		for (int x = model.Users.Count() - 1; x >= 0; --x)
+		{
+			var user = model.Users[x];
+			if (user->inUse && user->classname && !strcmp(user->classname, model.Classnames[x].CString()))
+			{
+				user->physicBody = model.Bodies[x];
+				continue;
+			}
+
+			var body = model.Bodies[x];
+			physicsWorld->removeCollisionObject(body);
+			delete body->getMotionState();
+			delete body;
+
+			model.Users.RemoveAt(x);
+			model.Bodies.RemoveAt(x);
+			model.Classnames.RemoveAt(x);
+		}
+	}
+
+	Save_Read(in, &count, sizeof(count));
+	if (count < 0 || count > game.maxentities)
+		Save_Error (in, "Phys_ReadState: bad body count");
+
+	TList<physSaveBody_t> bodies;
+	for (int i = 0; i < count; ++i)
+	{
+		physSaveBody_t save;
+		Save_Read(in, &save, sizeof(save));
+		bodies.Add(save);
+	}
+
+	TList<bool> restored;
+	for (int i = 0; i < count; ++i)
+		restored.Add(false);
+
+	// bodies from the map spawn are kept if the save still has them
+	for (int i = tempBody.size() - 1; i >= 0; --i)
+	{
+		var ent = tempBody[i].refEntity;
+		const int entNum = ent - g_edicts;
+
+		int found = -1;
+		for (int j = 0; j < count; ++j)
+		{
+			if (bodies[j].entNum == entNum && !restored[j])
+			{
+				found = j;
+				break;
+			}
+		}
+
+		if (found == -1 || !ent->inUse)
+		{
+			Phys_RemoveTempBody(i);
+			continue;
+		}
+
+		ent->physicBody = tempBody[i].body;
+		Phys_SetBodyState(tempBody[i].body, bodies[found].state);
+		restored[found] = true;
+	}
+
+	// the rest were made during play
+	for (int i = 0; i < count; ++i)
+	{
+		if (restored[i])
+			continue;
+
+		const physSaveBody_t &save = bodies[i];
+		if (save.entNum <= 0 || save.entNum >= globals.numEdicts)
+			continue;
+
+		var ent = &g_edicts[save.entNum];
+		var shape = Phys_GetSavedShape(save);
+		if (!ent->inUse || !shape)
+			continue;
+
+		var entity = AllocPhysEntityFromEntity(ent, shape, save.mass, true);
+		var body = entity.body;
+		body->setFriction(save.friction);
+		body->setRestitution(save.restitution);
+		body->setNormalDamping(save.normalLinearDamping, save.normalAngularDamping);
+		body->setDamping(save.linearDamping, save.angularDamping);
+
+		var state = (QuakeBodyMotionState*)body->getMotionState();
+		state->canReset = save.bCanReset;
+		if (save.bCanReset)
+			state->resetPosition = Phys_MakeTransform(save.resetOrigin, save.resetQuat);
+
+		Phys_SetBodyState(body, save.state);
+	}
+
+	// ragdolls are rebuilt and posed
+	Save_Read(in, &count, sizeof(count));
+	if (count < 0 || count > 64)
+		Save_Error (in, "Phys_ReadState: bad ragdoll count");
+
+	for (int i = 0; i < count; ++i)
+	{
+		physSaveRagdoll_t save;
+		Save_Read(in, &save, sizeof(save));
+
+		var raggy = new RagDoll(save.playerNum, physicsWorld, btVector3(0, 0, 0), vec3Origin, vec3Origin, 45);
+		for (int j = 0; j < RAG_COUNT; ++j)
+		{
+			var part = (edict_t*)raggy->m_bodies[j]->getUserPointer();
+
+			Phys_SetBodyState(raggy->m_bodies[j], save.parts[j]);
+			part->s.modelIndex = save.modelIndex[j];
+			part->enemy = (edict_t*)raggy;
+		}
+
+		ragdolls.push_back(raggy);
+	}
+}
@@ -210,12 +210,341 @@ void InitGame ()
 	// initialize all clients for this game
 	game.maxclients = maxclients->floatVal;
 	game.clients = (gclient_t*)gi.TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME);
-	globals.numEdicts = game.maxclients+1;
+	G_InitEdictAllocator ();
+	G_InitEdictIndex ();
+}
+
+/*
+=============================================================================
+
+	SAVE BUFFERS
+
+	Saves are built in memory first, in one pass over the game state, and
+	then handed to a writer thread that packs and writes them out. That
+	keeps the file system off the server frame, so autosaving on a level
+	change costs no more than the copy.
+
+	On disk a save is a saveHeader_t followed by the packed payload. The
+	packing only squeezes out runs of zero bytes, which is most of an
+	edict_t, and is cheap enough to undo on load.
+
+=============================================================================
+*/
+
+#define SAVE_IDENT			(('V'<<24)+('S'<<16)+('G'<<8)+'E')	// "EGSV"
+#define SAVE_VERSION		2
+
+#define SAVE_TYPE_GAME		1
+#define SAVE_TYPE_LEVEL		2
+
+#define MAX_SAVE_JOBS		4
+
+struct saveHeader_t
+{
+	int			ident;
+	int			version;
+	int			type;
+	int			rawSize;
+	int			packedSize;
+};
+
+struct saveJob_t
+{
+	char		fileName[MAX_OSPATH];
+	byte		*data;
+	size_t		size;
+	int			type;
+	bool		bFailed;
+	qThread_t	*thread;
+};
+
+static saveJob_t	g_saveJobs[MAX_SAVE_JOBS];
+static int			g_numSaveJobs;
+
+/*
+==============
+Save_Write
+==============
+*/
+void Save_Write (saveBuffer_t *buf, const void *data, const size_t size)
+{
+	if (buf->size + size > buf->maxSize)
+	{
+		buf->maxSize = Max<size_t> (buf->maxSize * 2, buf->size + size + 65536);
+		buf->data = (byte*)realloc (buf->data, buf->maxSize);
+		if (!buf->data)
+			gi.error ("Save_Write: out of memory");
+	}
+
+	memcpy (buf->data + buf->size, data, size);
+	buf->size += size;
+}
+
+
+/*
+==============
+Save_Error
+
+Frees the save being read before dropping out, gi.error doesn't return.
+==============
+*/
+void Save_Error (saveReader_t *in, const char *message)
+{
+	free (in->data);
+	in->data = NULL;
+	gi.error ("%s", message);
+}
+
+
+/*
+==============
+Save_Read
+==============
+*/
+void Save_Read (saveReader_t *in, void *data, const size_t size)
+{
+	if (size > in->size - in->pos)
+		Save_Error (in, "Save_Read: read past the end of the savegame");
+
+	memcpy (data, in->data + in->pos, size);
+	in->pos += size;
+}
+
+
+/*
+==============
+Save_Pack
+
+Control byte below 0x80 is followed by that many plus one literal bytes.
+At or above, the low seven bits and the next byte give a zero run, minus
+one. Packed data is never more than 1/128th bigger than the input.
+==============
+*/
+static size_t Save_Pack (const byte *in, const size_t inSize, byte *out)
+{
+	byte *start = out;
+	size_t pos = 0;
+
+	while (pos < inSize)
+	{
+		// Zero run
+		size_t run = 0;
+		while (pos+run < inSize && !in[pos+run] && run < 32768)
+			run++;
+
+		if (run >= 3 || (run && pos+run == inSize))
+		{
+			*out++ = 0x80 | (byte)((run-1) >> 8);
+			*out++ = (byte)((run-1) & 0xFF);
+			pos += run;
+			continue;
+		}
+
+		// Literals, up to the next worthwhile zero run
+		size_t lit = 0;
+		while (pos+lit < inSize && lit < 128)
+		{
+			if (!in[pos+lit] && pos+lit+2 < inSize && !in[pos+lit+1] && !in[pos+lit+2])
+				break;
+			lit++;
+		}
+
+		*out++ = (byte)(lit-1);
+		memcpy (out, in+pos, lit);
+		out += lit;
+		pos += lit;
+	}
+
+	return out - start;
+}
+
+
+/*
+==============
+Save_Unpack
+==============
+*/
+static bool Save_Unpack (const byte *in, const size_t inSize, byte *out, const size_t outSize)
+{
+	const byte *inEnd = in + inSize;
+	byte *outEnd = out + outSize;
+
+	while (in < inEnd)
+	{
+		const byte c = *in++;
+		if (c & 0x80)
+		{
+			if (in >= inEnd)
+				return false;
+
+			const size_t run = (((c & 0x7F) << 8) | *in++) + 1;
+			if (out + run > outEnd)
+				return false;
+			memset (out, 0, run);
+			out += run;
+		}
+		else
+		{
+			const size_t lit = c + 1;
+			if (in + lit > inEnd || out + lit > outEnd)
+				return false;
+			memcpy (out, in, lit);
+			in += lit;
+			out += lit;
+		}
+	}
+
+	return (out == outEnd);
+}
+
+
+/*
+==============
+Save_WriterThread
+
+Packs and writes one save. Runs without touching any game state.
+==============
+*/
+static void Save_WriterThread (void *arg)
+{
+	saveJob_t *job = (saveJob_t*)arg;
+
+	saveHeader_t header;
+	header.ident = SAVE_IDENT;
+	header.version = SAVE_VERSION;
+	header.type = job->type;
+	header.rawSize = (int)job->size;
+
+	byte *packed = (byte*)malloc (job->size + job->size/128 + 16);
+	header.packedSize = packed ? (int)Save_Pack (job->data, job->size, packed) : 0;
+
+	FILE *f = packed ? fopen (job->fileName, "wb") : NULL;
+	if (!f
+	|| fwrite (&header, sizeof(header), 1, f) != 1
+	|| fwrite (packed, header.packedSize, 1, f) != 1)
+		job->bFailed = true;
+
+	if (f)
+		fclose (f);
+	free (packed);
+	free (job->data);
+	job->data = NULL;
+}
+
+
+/*
+==============
+G_FlushSaves
+
+Waits for every queued save to reach the disk. Anything that reads the
+save directory back has to call this first.
+==============
+*/
+void G_FlushSaves ()
+{
+	for (int i=0 ; i<g_numSaveJobs ; i++)
+	{
+		saveJob_t *job = &g_saveJobs[i];
+
+		if (job->thread)
+			Thread_Join (job->thread);
+		else
+			Save_WriterThread (job);
+
+		if (job->bFailed)
+			gi.dprintf ("Couldn't write %s\n", job->fileName);
+	}
+
+	memset (g_saveJobs, 0, sizeof(g_saveJobs));
+	g_numSaveJobs = 0;
+}
+
+
+/*
+==============
+Save_Queue
+
+Takes ownership of the buffer.
+==============
+*/
+static void Save_Queue (const char *fileName, const int type, saveBuffer_t *buf)
+{
+	// Two saves of the same file must land in order
+	for (int i=0 ; i<g_numSaveJobs ; i++)
+	{
+		if (!Q_stricmp (g_saveJobs[i].fileName, fileName))
+		{
+			G_FlushSaves ();
+			break;
+		}
+	}
+	if (g_numSaveJobs == MAX_SAVE_JOBS)
+		G_FlushSaves ();
+
+	saveJob_t *job = &g_saveJobs[g_numSaveJobs++];
+	Q_strncpyz (job->fileName, fileName, sizeof(job->fileName));
+	job->data = buf->data;
+	job->size = buf->size;
+	job->type = type;
+	job->bFailed = false;
+
+	// Without a thread the write just happens at the next flush
+	job->thread = Thread_Create (Save_WriterThread, job);
+
+	memset (buf, 0, sizeof(*buf));
+}
+
+
+/*
+==============
+Save_Load
+
+Reads and unpacks a whole save.
+==============
+*/
+static void Save_Load (const char *fileName, const int type, saveReader_t *in)
+{
+	G_FlushSaves ();
+
+	FILE *f = fopen (fileName, "rb");
+	if (!f)
+		gi.error ("Couldn't open %s", fileName);
+
+	saveHeader_t header;
+	if (fread (&header, sizeof(header), 1, f) != 1
+	|| header.ident != SAVE_IDENT
+	|| header.version != SAVE_VERSION
+	|| header.type != type
+	|| header.rawSize <= 0
+	|| header.packedSize <= 0)
+	{
+		fclose (f);
+		gi.error ("Savegame from an older version.\n");
+	}
+
+	byte *packed = (byte*)malloc (header.packedSize);
+	byte *data = (byte*)malloc (header.rawSize);
+	if (!packed || !data
+	|| fread (packed, header.packedSize, 1, f) != 1
+	|| !Save_Unpack (packed, header.packedSize, data, header.rawSize))
+	{
+		fclose (f);
+		free (packed);
+		free (data);
+		gi.error ("%s is damaged", fileName);
+	}
+
+	fclose (f);
+	free (packed);
+
+	in->data = data;
+	in->size = header.rawSize;
+	in->pos = 0;
 }
 
 //=========================================================
 
-void WriteField1 (FILE *f, field_t *field, byte *base)
+void WriteField1 (saveBuffer_t *buf, field_t *field, byte *base)
 {
 	void		*p;
 	int			len;
@@ -288,7 +617,7 @@ void WriteField1 (FILE *f, field_t *field, byte *base)
 }
 
 
-void WriteField2 (FILE *f, field_t *field, byte *base)
+void WriteField2 (saveBuffer_t *buf, field_t *field, byte *base)
 {
 	int			len;
 	void		*p;
@@ -303,13 +632,13 @@ void WriteField2 (FILE *f, field_t *field, byte *base)
 		if ( *(char **)p )
 		{
 			len = strlen(*(char **)p) + 1;
-			fwrite (*(char **)p, len, 1, f);
+			Save_Write (buf, *(char **)p, len);
 		}
 		break;
 	}
 }
 
-void ReadField (FILE *f, field_t *field, byte *base)
+void ReadField (saveReader_t *in, field_t *field, byte *base)
 {
 	void		*p;
 	int			len;
@@ -335,7 +664,7 @@ void ReadField (FILE *f, field_t *field, byte *base)
 		else
 		{
 			*(char **)p = (char*)gi.TagMalloc (len, TAG_LEVEL);
-			fread (*(char **)p, len, 1, f);
+			Save_Read (in, *(char **)p, len);
 		}
 		break;
 	case F_EDICT:
@@ -379,7 +708,7 @@ void ReadField (FILE *f, field_t *field, byte *base)
 		break;
 
 	default:
-		gi.error ("ReadEdict: unknown field type");
+		Save_Error (in, "ReadEdict: unknown field type");
 	}
 }
 
@@ -392,7 +721,7 @@ WriteClient
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void WriteClient (FILE *f, gclient_t *client)
+void WriteClient (saveBuffer_t *buf, gclient_t *client)
 {
 	field_t		*field;
 	gclient_t	temp;
@@ -403,16 +732,16 @@ void WriteClient (FILE *f, gclient_t *client)
 	// change the pointers to lengths or indexes
 	for (field=clientfields ; field->name ; field++)
 	{
-		WriteField1 (f, field, (byte *)&temp);
+		WriteField1 (buf, field, (byte *)&temp);
 	}
 
 	// write the block
-	fwrite (&temp, sizeof(temp), 1, f);
+	Save_Write (buf, &temp, sizeof(temp));
 
 	// now write any allocated data following the edict
 	for (field=clientfields ; field->name ; field++)
 	{
-		WriteField2 (f, field, (byte *)client);
+		WriteField2 (buf, field, (byte *)client);
 	}
 }
 
@@ -423,15 +752,15 @@ ReadClient
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void ReadClient (FILE *f, gclient_t *client)
+void ReadClient (saveReader_t *in, gclient_t *client)
 {
 	field_t		*field;
 
-	fread (client, sizeof(*client), 1, f);
+	Save_Read (in, client, sizeof(*client));
 
 	for (field=clientfields ; field->name ; field++)
 	{
-		ReadField (f, field, (byte *)client);
+		ReadField (in, field, (byte *)client);
 	}
 }
 
@@ -447,63 +776,62 @@ triggers, help computer info, and all client states.
 
 A single player death will automatically restore from the
 last save position.
+
+The server copies the save directory as soon as this returns,
+so unlike WriteLevel it waits for the disk.
 ============
 */
 void WriteGame (char *filename, BOOL autosave)
 {
-	FILE	*f;
+	saveBuffer_t	buf;
 	int		i;
 	char	str[16];
 
 	if (!autosave)
 		SaveClientData ();
 
-	f = fopen (filename, "wb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	memset (&buf, 0, sizeof(buf));
 
 	memset (str, 0, sizeof(str));
 	strcpy (str, __DATE__);
-	fwrite (str, sizeof(str), 1, f);
+	Save_Write (&buf, str, sizeof(str));
 
 	game.autosaved = autosave ? true : false;
-	fwrite (&game, sizeof(game), 1, f);
+	Save_Write (&buf, &game, sizeof(game));
 	game.autosaved = false;
 
 	for (i=0 ; i<game.maxclients ; i++)
-		WriteClient (f, &game.clients[i]);
+		WriteClient (&buf, &game.clients[i]);
 
-	fclose (f);
+	Save_Queue (filename, SAVE_TYPE_GAME, &buf);
+	G_FlushSaves ();
 }
 
 void ReadGame (char *filename)
 {
-	FILE	*f;
+	saveReader_t	in;
 	int		i;
 	char	str[16];
 
-	gi.FreeTags (TAG_GAME);
+	Save_Load (filename, SAVE_TYPE_GAME, &in);
 
-	f = fopen (filename, "rb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	gi.FreeTags (TAG_GAME);
 
-	fread (str, sizeof(str), 1, f);
+	Save_Read (&in, str, sizeof(str));
 	if (strcmp (str, __DATE__))
-	{
-		fclose (f);
-		gi.error ("Savegame from an older version.\n");
-	}
+		Save_Error (&in, "Savegame from an older version.\n");
 
 	g_edicts = (edict_t*)gi.TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
 	globals.edicts = g_edicts;
 
-	fread (&game, sizeof(game), 1, f);
+	Save_Read (&in, &game, sizeof(game));
 	game.clients = (gclient_t*)gi.TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME);
 	for (i=0 ; i<game.maxclients ; i++)
-		ReadClient (f, &game.clients[i]);
+		ReadClient (&in, &game.clients[i]);
+	G_InitEdictAllocator ();
+	G_InitEdictIndex ();
 
-	fclose (f);
+	free (in.data);
 }
 
 //==========================================================
@@ -516,7 +844,7 @@ WriteEdict
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void WriteEdict (FILE *f, edict_t *ent)
+void WriteEdict (saveBuffer_t *buf, edict_t *ent)
 {
 	field_t		*field;
 	edict_t		temp;
@@ -527,16 +855,19 @@ void WriteEdict (FILE *f, edict_t *ent)
 	// change the pointers to lengths or indexes
 	for (field=fields ; field->name ; field++)
 	{
-		WriteField1 (f, field, (byte *)&temp);
+		WriteField1 (buf, field, (byte *)&temp);
 	}
 
+	// the body is written with the physics state
+	temp.physicBody = NULL;
+
 	// write the block
-	fwrite (&temp, sizeof(temp), 1, f);
+	Save_Write (buf, &temp, sizeof(temp));
 
 	// now write any allocated data following the edict
 	for (field=fields ; field->name ; field++)
 	{
-		WriteField2 (f, field, (byte *)ent);
+		WriteField2 (buf, field, (byte *)ent);
 	}
 
 }
@@ -548,7 +879,7 @@ WriteLevelLocals
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void WriteLevelLocals (FILE *f)
+void WriteLevelLocals (saveBuffer_t *buf)
 {
 	field_t		*field;
 	level_locals_t		temp;
@@ -559,16 +890,16 @@ void WriteLevelLocals (FILE *f)
 	// change the pointers to lengths or indexes
 	for (field=levelfields ; field->name ; field++)
 	{
-		WriteField1 (f, field, (byte *)&temp);
+		WriteField1 (buf, field, (byte *)&temp);
 	}
 
 	// write the block
-	fwrite (&temp, sizeof(temp), 1, f);
+	Save_Write (buf, &temp, sizeof(temp));
 
 	// now write any allocated data following the edict
 	for (field=levelfields ; field->name ; field++)
 	{
-		WriteField2 (f, field, (byte *)&level);
+		WriteField2 (buf, field, (byte *)&level);
 	}
 }
 
@@ -580,15 +911,15 @@ ReadEdict
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void ReadEdict (FILE *f, edict_t *ent)
+void ReadEdict (saveReader_t *in, edict_t *ent)
 {
 	field_t		*field;
 
-	fread (ent, sizeof(*ent), 1, f);
+	Save_Read (in, ent, sizeof(*ent));
 
 	for (field=fields ; field->name ; field++)
 	{
-		ReadField (f, field, (byte *)ent);
+		ReadField (in, field, (byte *)ent);
 	}
 }
 
@@ -599,15 +930,15 @@ ReadLevelLocals
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
-void ReadLevelLocals (FILE *f)
+void ReadLevelLocals (saveReader_t *in)
 {
 	field_t		*field;
 
-	fread (&level, sizeof(level), 1, f);
+	Save_Read (in, &level, sizeof(level));
 
 	for (field=levelfields ; field->name ; field++)
 	{
-		ReadField (f, field, (byte *)&level);
+		ReadField (in, field, (byte *)&level);
 	}
 }
 
@@ -615,29 +946,28 @@ void ReadLevelLocals (FILE *f)
 =================
 WriteLevel
 
+Only builds the save in memory, the writer thread takes it from there.
 =================
 */
 void WriteLevel (char *filename)
 {
 	int		i;
 	edict_t	*ent;
-	FILE	*f;
+	saveBuffer_t	buf;
 	void	*base;
 
-	f = fopen (filename, "wb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	memset (&buf, 0, sizeof(buf));
 
 	// write out edict size for checking
 	i = sizeof(edict_t);
-	fwrite (&i, sizeof(i), 1, f);
+	Save_Write (&buf, &i, sizeof(i));
 
 	// write out a function pointer for checking
 	base = (void *)InitGame;
-	fwrite (&base, sizeof(base), 1, f);
+	Save_Write (&buf, &base, sizeof(base));
 
 	// write out level_locals_t
-	WriteLevelLocals (f);
+	WriteLevelLocals (&buf);
 
 	// write out all the entities
 	for (i=0 ; i<globals.numEdicts ; i++)
@@ -645,13 +975,19 @@ void WriteLevel (char *filename)
 		ent = &g_edicts[i];
 		if (!ent->inUse)
 			continue;
-		fwrite (&i, sizeof(i), 1, f);
-		WriteEdict (f, ent);
+		// ragdolls are rebuilt from the physics state
+		if (ent->s.type & ET_RAGDOLL)
+			continue;
+		Save_Write (&buf, &i, sizeof(i));
+		WriteEdict (&buf, ent);
 	}
 	i = -1;
-	fwrite (&i, sizeof(i), 1, f);
+	Save_Write (&buf, &i, sizeof(i));
 
-	fclose (f);
+	// write out the rigid bodies
+	Phys_WriteState (&buf);
+
+	Save_Queue (filename, SAVE_TYPE_LEVEL, &buf);
 }
 
 
@@ -674,14 +1010,12 @@ No clients are connected yet.
 void ReadLevel (char *filename)
 {
 	int		entNum;
-	FILE	*f;
+	saveReader_t	in;
 	int		i;
 	void	*base;
 	edict_t	*ent;
 
-	f = fopen (filename, "rb");
-	if (!f)
-		gi.error ("Couldn't open %s", filename);
+	Save_Load (filename, SAVE_TYPE_LEVEL, &in);
 
 	// free any dynamic memory allocated by loading the level
 	// base state
@@ -692,50 +1026,48 @@ void ReadLevel (char *filename)
 	globals.numEdicts = maxclients->floatVal+1;
 
 	// check edict size
-	fread (&i, sizeof(i), 1, f);
+	Save_Read (&in, &i, sizeof(i));
 	if (i != sizeof(edict_t))
-	{
-		fclose (f);
-		gi.error ("ReadLevel: mismatched edict size");
-	}
+		Save_Error (&in, "ReadLevel: mismatched edict size");
 
 	// check function pointer base address
-	fread (&base, sizeof(base), 1, f);
+	Save_Read (&in, &base, sizeof(base));
 #ifdef _WIN32
 	if (base != (void *)InitGame)
-	{
-		fclose (f);
-		gi.error ("ReadLevel: function pointers have moved");
-	}
+		Save_Error (&in, "ReadLevel: function pointers have moved");
 #else
 	gi.dprintf("Function offsets %d\n", ((byte *)base) - ((byte *)InitGame));
 #endif
 
 	// load the level locals
-	ReadLevelLocals (f);
+	ReadLevelLocals (&in);
 
 	// load all the entities
 	while (1)
 	{
-		if (fread (&entNum, sizeof(entNum), 1, f) != 1)
-		{
-			fclose (f);
-			gi.error ("ReadLevel: failed to read entNum");
-		}
+		Save_Read (&in, &entNum, sizeof(entNum));
 		if (entNum == -1)
 			break;
 		if (entNum >= globals.numEdicts)
 			globals.numEdicts = entNum+1;
 
 		ent = &g_edicts[entNum];
-		ReadEdict (f, ent);
+		ReadEdict (&in, ent);
 
 		// let the server rebuild world links for this ent
 		memset (&ent->area, 0, sizeof(ent->area));
 		gi.linkentity (ent);
 	}
 
-	fclose (f);
+	// queue the free slots between the loaded entities
+	G_ResetEdictAllocator (true);
+	G_RebuildEdictIndex ();
+	AI_ClearVisCache ();
+	M_ClearMoveCache ();
+
+	// put the rigid bodies back where they were
+	Phys_ReadState (&in);
+	free (in.data);
 
 	// mark all clients as unconnected
 	for (i=0 ; i<maxclients->floatVal ; i++)
@@ -268,6 +268,147 @@ spawn_t	spawns[] = {
 	{NULL, NULL}
 };
 
+/*
+=============================================================================
+
+	SPAWN AND FIELD LOOKUP
+
+	Classnames and entity keys are hashed once into open addressed tables,
+	so spawning an entity costs a hash and a compare or two per key instead
+	of a walk over the item list, spawns[] and fields[]. Items still win
+	over spawn functions with the same classname, and the first field with
+	a given key wins, exactly as the linear scans did.
+
+=============================================================================
+*/
+
+#define SPAWN_HASH_SIZE		1024
+#define FIELD_HASH_SIZE		512
+
+struct spawnHash_t
+{
+	const char	*name;
+	gitem_t		*item;
+	void		(*spawn)(edict_t *ent);
+};
+
+static spawnHash_t	ed_spawnHash[SPAWN_HASH_SIZE];
+static field_t		*ed_fieldHash[FIELD_HASH_SIZE];
+static bool			ed_hashBuilt;
+
+static uint32 ED_HashKey (const char *key)
+{
+	uint32 hash = 0;
+	for ( ; *key ; key++)
+		hash = hash * 31 + tolower (*key);
+
+	return hash;
+}
+
+static void ED_AddSpawn (const char *name, gitem_t *item, void (*spawn)(edict_t *ent))
+{
+	uint32 slot = ED_HashKey (name) & (SPAWN_HASH_SIZE-1);
+	while (ed_spawnHash[slot].name)
+	{
+		if (!strcmp (ed_spawnHash[slot].name, name))
+			return;	// first one in wins
+		slot = (slot + 1) & (SPAWN_HASH_SIZE-1);
+	}
+
+	ed_spawnHash[slot].name = name;
+	ed_spawnHash[slot].item = item;
+	ed_spawnHash[slot].spawn = spawn;
+}
+
+static void ED_AddField (field_t *field)
+{
+	uint32 slot = ED_HashKey (field->name) & (FIELD_HASH_SIZE-1);
+	while (ed_fieldHash[slot])
+	{
+		if (!Q_stricmp (ed_fieldHash[slot]->name, field->name))
+			return;
+		slot = (slot + 1) & (FIELD_HASH_SIZE-1);
+	}
+
+	ed_fieldHash[slot] = field;
+}
+
+/*
+===============
+ED_BuildHashes
+
+The item list, spawns[] and fields[] are all static, so this only runs once
+===============
+*/
+static void ED_BuildHashes ()
+{
+	int			numSpawns = 0, numFields = 0;
+	gitem_t		*item;
+	spawn_t		*s;
+	field_t		*f;
+	int			i;
+
+	memset (ed_spawnHash, 0, sizeof(ed_spawnHash));
+	memset (ed_fieldHash, 0, sizeof(ed_fieldHash));
+
+	for (i=0,item=itemlist ; i<Items::numItems ; i++,item++)
+	{
+		if (!item->classname)
+			continue;
+		ED_AddSpawn (item->classname, item, NULL);
+		numSpawns++;
+	}
+	for (s=spawns ; s->name ; s++)
+	{
+		ED_AddSpawn (s->name, NULL, s->spawn);
+		numSpawns++;
+	}
+
+	for (f=fields ; f->name ; f++)
+	{
+		if (f->flags & FFL_NOSPAWN)
+			continue;
+		ED_AddField (f);
+		numFields++;
+	}
+
+	// Keep the tables at most half full so probe chains stay short
+	if (numSpawns > SPAWN_HASH_SIZE/2 || numFields > FIELD_HASH_SIZE/2)
+		gi.error ("ED_BuildHashes: %i spawns, %i fields, raise SPAWN_HASH_SIZE/FIELD_HASH_SIZE", numSpawns, numFields);
+
+	ed_hashBuilt = true;
+}
+
+static spawnHash_t *ED_FindSpawn (const char *classname)
+{
+	if (!ed_hashBuilt)
+		ED_BuildHashes ();
+
+	uint32 slot = ED_HashKey (classname) & (SPAWN_HASH_SIZE-1);
+	for ( ; ed_spawnHash[slot].name ; slot=(slot+1)&(SPAWN_HASH_SIZE-1))
+	{
+		if (!strcmp (ed_spawnHash[slot].name, classname))
+			return &ed_spawnHash[slot];
+	}
+
+	return NULL;
+}
+
+static field_t *ED_FindField (const char *key)
+{
+	if (!ed_hashBuilt)
+		ED_BuildHashes ();
+
+	uint32 slot = ED_HashKey (key) & (FIELD_HASH_SIZE-1);
+	for ( ; ed_fieldHash[slot] ; slot=(slot+1)&(FIELD_HASH_SIZE-1))
+	{
+		if (!Q_stricmp (ed_fieldHash[slot]->name, key))
+			return ed_fieldHash[slot];
+	}
+
+	return NULL;
+}
+
 /*
 ===============
 ED_CallSpawn
@@ -277,71 +418,111 @@ Finds the spawn function for the entity and calls it
 */
 void ED_CallSpawn (edict_t *ent)
 {
-	spawn_t	*s;
-	gitem_t	*item;
-	int		i;
-
 	if (!ent->classname)
 	{
 		gi.dprintf ("ED_CallSpawn: NULL classname\n");
 		return;
 	}
 
-	// check item spawn functions
-	for (i=0,item=itemlist ; i<Items::numItems ; i++,item++)
+	spawnHash_t *s = ED_FindSpawn (ent->classname);
+	if (!s)
 	{
-		if (!item->classname)
-			continue;
-		if (!strcmp(item->classname, ent->classname))
-		{	// found it
-			SpawnItem (ent, item);
-			return;
-		}
+		gi.dprintf ("%s doesn't have a spawn function\n", ent->classname);
+		return;
 	}
 
-	// check normal spawn functions
-	for (s=spawns ; s->name ; s++)
+	if (s->item)
+		SpawnItem (ent, s->item);
+	else
+		s->spawn (ent);
+}
+
+/*
+=============
+ED_UnescapeString
+
+Unescapes in place, the result is never longer than the input
+=============
+*/
+static char *ED_UnescapeString (char *string)
+{
+	char	*in, *out;
+
+	for (in=out=string ; *in ; in++)
 	{
-		if (!strcmp(s->name, ent->classname))
-		{	// found it
-			s->spawn (ent);
-			return;
+		if (*in == '\\' && in[1])
+		{
+			in++;
+			if (*in == 'n')
+				*out++ = '\n';
+			else
+				*out++ = '\\';
 		}
+		else
+			*out++ = *in;
 	}
-	gi.dprintf ("%s doesn't have a spawn function\n", ent->classname);
+	*out = '\0';
+
+	return string;
 }
 
+
 /*
 =============
-ED_NewString
+ED_ParseToken
+
+Com_Parse without the copy. The token is cut out of the string in place by
+terminating it there, so the string has to be writable, and the result stays
+valid for as long as the string does. Returns NULL at the end of the data.
 =============
 */
-char *ED_NewString (char *string)
+static char *ED_ParseToken (char **dataPtr)
 {
-	char	*newb, *new_p;
-	int		i,l;
-	
-	l = strlen(string) + 1;
-
-	newb = (char*)gi.TagMalloc (l, TAG_LEVEL);
+	char	*data = *dataPtr;
+	char	*token;
 
-	new_p = newb;
+	if (!data)
+		return NULL;
 
-	for (i=0 ; i< l ; i++)
+	// Skip whitespace and // comments
+	for ( ; ; )
 	{
-		if (string[i] == '\\' && i < l-1)
+		while (*data && *data <= ' ')
+			data++;
+		if (!*data)
 		{
-			i++;
-			if (string[i] == 'n')
-				*new_p++ = '\n';
-			else
-				*new_p++ = '\\';
+			*dataPtr = NULL;
+			return NULL;
 		}
-		else
-			*new_p++ = string[i];
+
+		if (data[0] != '/' || data[1] != '/')
+			break;
+		while (*data && *data != '\n')
+			data++;
 	}
-	
-	return newb;
+
+	// Quoted strings run to the closing quote
+	if (*data == '\"')
+	{
+		token = ++data;
+		while (*data && *data != '\"')
+			data++;
+		if (*data)
+			*data++ = '\0';
+
+		*dataPtr = data;
+		return token;
+	}
+
+	// Regular words run to the next whitespace
+	token = data;
+	while (*data > ' ')
+		data++;
+	if (*data)
+		*data++ = '\0';
+
+	*dataPtr = data;
+	return token;
 }
 
 
@@ -360,45 +541,45 @@ static void ED_ParseField (char *key, char *value, edict_t *ent)
 	float	v;
 	vec3_t	vec;
 
-	for (f=fields ; f->name ; f++)
+	f = ED_FindField (key);
+	if (!f)
 	{
-		if (!(f->flags & FFL_NOSPAWN) && !Q_stricmp(f->name, key))
-		{	// found it
-			if (f->flags & FFL_SPAWNTEMP)
-				b = (byte *)&st;
-			else
-				b = (byte *)ent;
+		gi.dprintf ("%s is not a field\n", key);
+		return;
+	}
 
-			switch (f->type)
-			{
-			case F_LSTRING:
-				*(char **)(b+f->ofs) = ED_NewString (value);
-				break;
-			case F_VECTOR:
-				sscanf (value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
-				((float *)(b+f->ofs))[0] = vec[0];
-				((float *)(b+f->ofs))[1] = vec[1];
-				((float *)(b+f->ofs))[2] = vec[2];
-				break;
-			case F_INT:
-				*(int *)(b+f->ofs) = atoi(value);
-				break;
-			case F_FLOAT:
-				*(float *)(b+f->ofs) = atof(value);
-				break;
-			case F_ANGLEHACK:
-				v = atof(value);
-				((float *)(b+f->ofs))[0] = 0;
-				((float *)(b+f->ofs))[1] = v;
-				((float *)(b+f->ofs))[2] = 0;
-				break;
-			case F_IGNORE:
-				break;
-			}
-			return;
-		}
+	if (f->flags & FFL_SPAWNTEMP)
+		b = (byte *)&st;
+	else
+		b = (byte *)ent;
+
+	switch (f->type)
+	{
+	case F_LSTRING:
+		// value lives in the level's copy of the entity string
+		*(char **)(b+f->ofs) = ED_UnescapeString (value);
+		break;
+	case F_VECTOR:
+		sscanf (value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
+		((float *)(b+f->ofs))[0] = vec[0];
+		((float *)(b+f->ofs))[1] = vec[1];
+		((float *)(b+f->ofs))[2] = vec[2];
+		break;
+	case F_INT:
+		*(int *)(b+f->ofs) = atoi(value);
+		break;
+	case F_FLOAT:
+		*(float *)(b+f->ofs) = atof(value);
+		break;
+	case F_ANGLEHACK:
+		v = atof(value);
+		((float *)(b+f->ofs))[0] = 0;
+		((float *)(b+f->ofs))[1] = v;
+		((float *)(b+f->ofs))[2] = 0;
+		break;
+	case F_IGNORE:
+		break;
 	}
-	gi.dprintf ("%s is not a field\n", key);
 }
 
 /*
@@ -406,13 +587,14 @@ static void ED_ParseField (char *key, char *value, edict_t *ent)
 ED_ParseEdict
 
 Parses an edict out of the given string, returning the new position
-ed should be a properly initialized empty edict.
+ed should be a properly initialized empty edict. The string is sliced in
+place and string fields point straight into it.
 ====================
 */
 static char *ED_ParseEdict (char *data, edict_t *ent)
 {
 	bool	init;
-	char	keyName[256];
+	char	*keyName;
 	char	*token;
 
 	init = false;
@@ -421,17 +603,15 @@ static char *ED_ParseEdict (char *data, edict_t *ent)
 	// Go through all the dictionary pairs
 	for ( ; ; ) {
 		// Parse key
-		token = Com_Parse (&data);
-		if (token[0] == '}')
-			break;
-		if (!data)
+		keyName = ED_ParseToken (&data);
+		if (!keyName)
 			gi.error ("ED_ParseEntity: EOF without closing brace");
+		if (keyName[0] == '}')
+			break;
 
-		Q_strncpyz (keyName, token, sizeof(keyName));
-		
-		// Parse value	
-		token = Com_Parse (&data);
-		if (!data)
+		// Parse value
+		token = ED_ParseToken (&data);
+		if (!token)
 			gi.error ("ED_ParseEntity: EOF without closing brace");
 		if (token[0] == '}')
 			gi.error ("ED_ParseEntity: closing brace without data");
@@ -449,6 +629,8 @@ static char *ED_ParseEdict (char *data, edict_t *ent)
 	if (!init)
 		memset (ent, 0, sizeof(*ent));
 
+	// The fields were filled in directly
+	G_ReindexEdict (ent);
 	return data;
 }
 
@@ -466,7 +648,7 @@ All but the last will have the teamchain field set to the next one
 void G_FindTeams ()
 {
 	edict_t	*e, *e2, *chain;
-	int		i, j;
+	int		i;
 	int		c, c2;
 
 	c = 0;
@@ -483,12 +665,8 @@ void G_FindTeams ()
 		e->teammaster = e;
 		c++;
 		c2++;
-		for (j=i+1, e2=e+1 ; j < globals.numEdicts ; j++,e2++)
+		for (e2=G_FindByKey (e, EK_TEAM, e->team) ; e2 ; e2=G_FindByKey (e2, EK_TEAM, e->team))
 		{
-			if (!e2->inUse)
-				continue;
-			if (!e2->team)
-				continue;
 			if (e2->flags & FL_TEAMSLAVE)
 				continue;
 			if (!strcmp(e->team, e2->team))
@@ -540,6 +718,10 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 
 	for (i = 0; i < game.maxentities; ++i)
 		g_edicts[i].s.Clear();
+	G_ResetEdictAllocator (false);
+	G_ClearEdictIndex ();
+	AI_ClearVisCache ();
+	M_ClearMoveCache ();
 
 	strncpy (level.mapname, mapname, sizeof(level.mapname)-1);
 	strncpy (game.spawnpoint, spawnpoint, sizeof(game.spawnpoint)-1);
@@ -551,11 +733,17 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 	ent = NULL;
 	inhibit = 0;
 
+	// Work on a level copy of the entity string so the parser can slice it in
+	// place, string fields point into it and go away with TAG_LEVEL
+	const size_t entLength = strlen (entities) + 1;
+	char *entData = (char*)gi.TagMalloc (entLength, TAG_LEVEL);
+	memcpy (entData, entities, entLength);
+
 	// Parse ents
 	for ( ; ; ) {
 		// Parse the opening brace
-		token = Com_Parse (&entities);
-		if (!entities)
+		token = ED_ParseToken (&entData);
+		if (!token)
 			break;
 		if (token[0] != '{')
 			gi.error ("ED_LoadFromFile: found %s when expecting {", token);
@@ -564,7 +752,7 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 			ent = g_edicts;
 		else
 			ent = G_Spawn ();
-		entities = ED_ParseEdict (entities, ent);
+		entData = ED_ParseEdict (entData, ent);
 
 		// Yet another map hack
 		if (!Q_stricmp(level.mapname, "command") && !Q_stricmp(ent->classname, "trigger_once") && !Q_stricmp(ent->model, "*27"))
@@ -279,6 +279,12 @@ void	ServerCommand ()
 		SVCmd_ListIP_f ();
 	else if (Q_stricmp (cmd, "writeip") == 0)
 		SVCmd_WriteIP_f ();
+	else if (Q_stricmp (cmd, "edicts") == 0)
+		G_PrintEdictStats ();
+	else if (Q_stricmp (cmd, "aivis") == 0)
+		AI_PrintVisStats ();
+	else if (Q_stricmp (cmd, "aimove") == 0)
+		M_PrintMoveStats ();
 	else
 		gi.cprintf (NULL, PRINT_HIGH, "Unknown server command \"%s\"\n", cmd);
 }
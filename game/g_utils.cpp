@@ -30,6 +30,208 @@ void G_ProjectSource (vec3_t point, vec3_t distance, vec3_t forward, vec3_t righ
 }
 
 
+/*
+=============================================================================
+
+	EDICT KEY INDEX
+
+	classname, targetname and team are hashed case-insensitively into chains
+	kept in edict order, so a lookup only visits edicts whose key lands in
+	the same bucket. Code that changes one of these keys on an edict should
+	go through G_SetEdictKey. An edict whose key pointer was changed behind
+	the index's back is skipped rather than returned with the wrong key.
+
+=============================================================================
+*/
+
+#define EDICT_KEY_HASH_SIZE		1024
+
+struct edictKeyIndex_t
+{
+	int			hashHeads[EDICT_KEY_HASH_SIZE];
+	int			*hashNext;		// game.maxentities, -1 terminated
+	int			*bucket;		// bucket each edict is linked in, -1 if none
+	char		**indexedKey;	// key pointer each edict was linked with
+};
+
+static edictKeyIndex_t	g_edictKeys[EK_MAX];
+static const int		g_edictKeyOfs[EK_MAX] = { FOFS(classname), FOFS(targetname), FOFS(team) };
+
+static inline char *G_EdictKey (const edict_t *ent, const EEdictKey key)
+{
+	return *(char **)((byte *)ent + g_edictKeyOfs[key]);
+}
+
+static uint32 G_EdictKeyHash (const char *value)
+{
+	uint32 hash = 0;
+	for ( ; *value ; value++)
+		hash = hash * 31 + tolower (*value);
+
+	return hash & (EDICT_KEY_HASH_SIZE-1);
+}
+
+/*
+=================
+G_InitEdictIndex
+
+Called once g_edicts is allocated, the chains live with it in TAG_GAME
+=================
+*/
+void G_InitEdictIndex ()
+{
+	for (int i=0 ; i<EK_MAX ; i++)
+	{
+		g_edictKeys[i].hashNext = (int*)gi.TagMalloc (game.maxentities * sizeof(int), TAG_GAME);
+		g_edictKeys[i].bucket = (int*)gi.TagMalloc (game.maxentities * sizeof(int), TAG_GAME);
+		g_edictKeys[i].indexedKey = (char**)gi.TagMalloc (game.maxentities * sizeof(char*), TAG_GAME);
+	}
+
+	G_ClearEdictIndex ();
+}
+
+/*
+=================
+G_ClearEdictIndex
+
+Called whenever g_edicts is wiped
+=================
+*/
+void G_ClearEdictIndex ()
+{
+	for (int i=0 ; i<EK_MAX ; i++)
+	{
+		edictKeyIndex_t *index = &g_edictKeys[i];
+
+		memset (index->hashHeads, -1, sizeof(index->hashHeads));
+		memset (index->hashNext, -1, game.maxentities * sizeof(int));
+		memset (index->bucket, -1, game.maxentities * sizeof(int));
+		memset (index->indexedKey, 0, game.maxentities * sizeof(char*));
+	}
+}
+
+/*
+=================
+G_RebuildEdictIndex
+
+Called after edicts are read back from a savegame
+=================
+*/
+void G_RebuildEdictIndex ()
+{
+	G_ClearEdictIndex ();
+
+	for (int i=0 ; i<globals.numEdicts ; i++)
+		G_ReindexEdict (&g_edicts[i]);
+}
+
+static void G_UnlinkEdictKey (const EEdictKey key, const int entNum)
+{
+	edictKeyIndex_t *index = &g_edictKeys[key];
+	if (index->bucket[entNum] == -1)
+		return;
+
+	int *link = &index->hashHeads[index->bucket[entNum]];
+	while (*link != entNum)
+		link = &index->hashNext[*link];
+	*link = index->hashNext[entNum];
+
+	index->hashNext[entNum] = -1;
+	index->bucket[entNum] = -1;
+	index->indexedKey[entNum] = NULL;
+}
+
+static void G_LinkEdictKey (const EEdictKey key, const int entNum, char *value)
+{
+	edictKeyIndex_t *index = &g_edictKeys[key];
+	const int bucket = G_EdictKeyHash (value);
+
+	// chains stay sorted so lookups return edicts in the same order a scan would
+	int *link = &index->hashHeads[bucket];
+	while (*link != -1 && *link < entNum)
+		link = &index->hashNext[*link];
+
+	index->hashNext[entNum] = *link;
+	*link = entNum;
+	index->bucket[entNum] = bucket;
+	index->indexedKey[entNum] = value;
+}
+
+/*
+=================
+G_SetEdictKey
+=================
+*/
+void G_SetEdictKey (edict_t *ent, EEdictKey key, const char *value)
+{
+	const int entNum = ent - g_edicts;
+
+	G_UnlinkEdictKey (key, entNum);
+	*(char **)((byte *)ent + g_edictKeyOfs[key]) = (char *)value;
+	if (value)
+		G_LinkEdictKey (key, entNum, (char *)value);
+}
+
+/*
+=================
+G_ReindexEdict
+
+Relinks every key from the edict's current fields, for code that fills the
+fields in directly (the entity parser, savegames)
+=================
+*/
+void G_ReindexEdict (edict_t *ent)
+{
+	for (int i=0 ; i<EK_MAX ; i++)
+		G_SetEdictKey (ent, (EEdictKey)i, G_EdictKey (ent, (EEdictKey)i));
+}
+
+/*
+=================
+G_UnindexEdict
+=================
+*/
+static void G_UnindexEdict (edict_t *ent)
+{
+	for (int i=0 ; i<EK_MAX ; i++)
+		G_UnlinkEdictKey ((EEdictKey)i, ent - g_edicts);
+}
+
+/*
+=============
+G_FindByKey
+
+Like G_Find, but goes through the key index. Returns the next active edict
+after from (or the first one if from is NULL) whose key matches.
+=============
+*/
+edict_t *G_FindByKey (edict_t *from, EEdictKey key, const char *match)
+{
+	edictKeyIndex_t *index = &g_edictKeys[key];
+	const int bucket = G_EdictKeyHash (match);
+	const int fromNum = from ? from - g_edicts : -1;
+
+	// continue down the chain if from is in it
+	int entNum = (from && index->bucket[fromNum] == bucket) ? index->hashNext[fromNum] : index->hashHeads[bucket];
+	for ( ; entNum != -1 ; entNum = index->hashNext[entNum])
+	{
+		if (entNum <= fromNum)
+			continue;
+
+		edict_t *ent = &g_edicts[entNum];
+		if (!ent->inUse)
+			continue;
+
+		char *value = G_EdictKey (ent, key);
+		if (value != index->indexedKey[entNum])
+			continue;
+		if (!Q_stricmp (value, match))
+			return ent;
+	}
+
+	return NULL;
+}
+
 /*
 =============
 G_Find
@@ -40,12 +242,19 @@ the matching string at fieldofs (use the FOFS() macro) in the structure.
 Searches beginning at the edict after from, or the beginning if NULL
 NULL will be returned if the end of the list is reached.
 
+Indexed keys go through G_FindByKey.
 =============
 */
 edict_t *G_Find (edict_t *from, int fieldofs, char *match)
 {
 	char	*s;
 
+	for (int i=0 ; i<EK_MAX ; i++)
+	{
+		if (fieldofs == g_edictKeyOfs[i])
+			return G_FindByKey (from, (EEdictKey)i, match);
+	}
+
 	if (!from)
 		from = g_edicts;
 	else
@@ -92,7 +301,7 @@ edict_t *findradius (edict_t *from, vec3_t org, float rad)
 			continue;
 		for (j=0 ; j<3 ; j++)
 			eorg[j] = org[j] - (from->s.origin[j] + (from->mins[j] + from->maxs[j])*0.5);
-		if (Vec3Length(eorg) > rad)
+		if (DotProduct(eorg, eorg) > rad*rad)
 			continue;
 		return from;
 	}
@@ -101,6 +310,60 @@ edict_t *findradius (edict_t *from, vec3_t org, float rad)
 }
 
 
+static int G_EdictNumSort (const void *a, const void *b)
+{
+	return *(edict_t **)a - *(edict_t **)b;
+}
+
+/*
+=================
+G_FindRadius
+
+Batch version of findradius. Fills list with every edict findradius would
+return, in the same order, and returns how many there are. Candidates come
+from the server's area nodes, so only linked edicts are considered, and the
+distance test is done squared.
+=================
+*/
+int G_FindRadius (vec3_t org, float rad, edict_t **list, int maxList)
+{
+	vec3_t	mins, maxs, eorg;
+	int		numHits = 0;
+
+	for (int i=0 ; i<3 ; i++)
+	{
+		mins[i] = org[i] - rad;
+		maxs[i] = org[i] + rad;
+	}
+
+	const float radSquared = rad*rad;
+	for (int areaType=AREA_SOLID ; areaType<=AREA_TRIGGERS ; areaType++)
+	{
+		var touch = gi.BoxEdicts (mins, maxs, areaType);
+		for (uint32 i=0 ; i<touch.Count() ; i++)
+		{
+			edict_t *hit = touch[i];
+			if (!hit->inUse)
+				continue;
+			for (int j=0 ; j<3 ; j++)
+				eorg[j] = org[j] - (hit->s.origin[j] + (hit->mins[j] + hit->maxs[j])*0.5);
+			if (DotProduct(eorg, eorg) > radSquared)
+				continue;
+
+			if (numHits == maxList)
+			{
+				gi.dprintf ("G_FindRadius: more than %i hits\n", maxList);
+				break;
+			}
+			list[numHits++] = hit;
+		}
+	}
+
+	qsort (list, numHits, sizeof(list[0]), G_EdictNumSort);
+	return numHits;
+}
+
+
 /*
 =============
 G_PickTarget
@@ -129,7 +392,7 @@ edict_t *G_PickTarget (char *targetname)
 
 	while(1)
 	{
-		ent = G_Find (ent, FOFS(targetname), targetname);
+		ent = G_FindByKey (ent, EK_TARGETNAME, targetname);
 		if (!ent)
 			break;
 		choice[num_choices++] = ent;
@@ -181,7 +444,7 @@ void G_UseTargets (edict_t *ent, edict_t *activator)
 	{
 	// create a temp object to fire at a later time
 		t = G_Spawn();
-		t->classname = "DelayedUse";
+		G_SetEdictKey (t, EK_CLASSNAME, "DelayedUse");
 		t->nextthink = level.time + ent->delay;
 		t->think = Think_Delay;
 		t->activator = activator;
@@ -212,7 +475,7 @@ void G_UseTargets (edict_t *ent, edict_t *activator)
 	if (ent->killtarget)
 	{
 		t = NULL;
-		while ((t = G_Find (t, FOFS(targetname), ent->killtarget)))
+		while ((t = G_FindByKey (t, EK_TARGETNAME, ent->killtarget)))
 		{
 			G_FreeEdict (t);
 			if (!ent->inUse)
@@ -229,7 +492,7 @@ void G_UseTargets (edict_t *ent, edict_t *activator)
 	if (ent->target)
 	{
 		t = NULL;
-		while ((t = G_Find (t, FOFS(targetname), ent->target)))
+		while ((t = G_FindByKey (t, EK_TARGETNAME, ent->target)))
 		{
 			// doors fire area portals in a specific way
 			if (!Q_stricmp(t->classname, "func_areaportal") &&
@@ -343,11 +606,81 @@ char *G_CopyString (char *in)
 void G_InitEdict (edict_t *e)
 {
 	e->inUse = true;
-	e->classname = "noclass";
+	G_SetEdictKey (e, EK_CLASSNAME, "noclass");
 	e->gravity = 1.0;
 	e->s.number = e - g_edicts;
 }
 
+/*
+=============================================================================
+
+	EDICT ALLOCATION
+
+	Freed edicts are queued in the order they were freed, and a slot is only
+	handed out again once it has been free for half a second, so clients see
+	the removal before the number is reused. Because the queue is in free
+	order only its head ever needs checking. When nothing is ready a slot is
+	taken from past the highest one handed out so far.
+
+=============================================================================
+*/
+
+struct edictAllocator_t
+{
+	int			*freeQueue;		// game.maxentities ring of freed edict numbers, oldest first
+	int			freeHead;
+	int			freeCount;
+	int			highWater;		// one past the highest edict number handed out
+
+	uint32		numAllocs;
+	uint32		numReused;
+	uint32		numFrees;
+};
+
+static edictAllocator_t	g_edictAlloc;
+
+/*
+=================
+G_InitEdictAllocator
+
+Called once g_edicts is allocated, the queue lives with it in TAG_GAME
+=================
+*/
+void G_InitEdictAllocator ()
+{
+	g_edictAlloc.freeQueue = (int*)gi.TagMalloc (game.maxentities * sizeof(int), TAG_GAME);
+	G_ResetEdictAllocator (false);
+}
+
+/*
+=================
+G_ResetEdictAllocator
+
+Called whenever g_edicts is wiped or reloaded. With bRebuild the free slots
+below numEdicts are queued again, lowest first.
+=================
+*/
+void G_ResetEdictAllocator (bool bRebuild)
+{
+	g_edictAlloc.freeHead = 0;
+	g_edictAlloc.freeCount = 0;
+	g_edictAlloc.numAllocs = g_edictAlloc.numReused = g_edictAlloc.numFrees = 0;
+
+	if (!bRebuild)
+	{
+		globals.numEdicts = game.maxclients+1;
+		g_edictAlloc.highWater = globals.numEdicts;
+		return;
+	}
+
+	g_edictAlloc.highWater = globals.numEdicts;
+	for (int i=game.maxclients+BODY_QUEUE_SIZE+1 ; i<globals.numEdicts ; i++)
+	{
+		if (!g_edicts[i].inUse)
+			g_edictAlloc.freeQueue[g_edictAlloc.freeCount++] = i;
+	}
+}
+
 /*
 =================
 G_Spawn
@@ -361,25 +694,41 @@ angles and bad trails.
 */
 edict_t *G_Spawn ()
 {
-	int			i;
-	edict_t		*e;
+	edict_t		*e = NULL;
 
-	e = &g_edicts[(int)maxclients->floatVal+1];
-	for ( i=maxclients->floatVal+1 ; i<globals.numEdicts ; i++, e++)
+	while (g_edictAlloc.freeCount)
 	{
+		edict_t *head = &g_edicts[g_edictAlloc.freeQueue[g_edictAlloc.freeHead]];
+
 		// the first couple seconds of server time can involve a lot of
 		// freeing and allocating, so relax the replacement policy
-		if (!e->inUse && ( e->freetime < 2 || level.time - e->freetime > 0.5 ) )
+		if (!head->inUse && !( head->freetime < 2 || level.time - head->freetime > 0.5 ) )
+			break;
+
+		g_edictAlloc.freeHead = (g_edictAlloc.freeHead + 1) % game.maxentities;
+		g_edictAlloc.freeCount--;
+
+		// stale if something claimed it without going through here
+		if (!head->inUse)
 		{
-			G_InitEdict (e);
-			return e;
+			e = head;
+			g_edictAlloc.numReused++;
+			break;
 		}
 	}
-	
-	if (i == game.maxentities)
-		gi.error ("ED_Alloc: no free edicts");
-		
-	globals.numEdicts++;
+
+	if (!e)
+	{
+		if (g_edictAlloc.highWater == game.maxentities)
+			gi.error ("ED_Alloc: no free edicts");
+
+		e = &g_edicts[g_edictAlloc.highWater++];
+	}
+
+	if (e - g_edicts >= globals.numEdicts)
+		globals.numEdicts = e - g_edicts + 1;
+
+	g_edictAlloc.numAllocs++;
 	G_InitEdict (e);
 	return e;
 }
@@ -395,7 +744,8 @@ void G_FreeEdict (edict_t *ed)
 {
 	gi.unlinkentity (ed);		// unlink from world
 
-	if ((ed - g_edicts) <= (maxclients->floatVal + BODY_QUEUE_SIZE))
+	const int entNum = ed - g_edicts;
+	if (entNum <= (maxclients->floatVal + BODY_QUEUE_SIZE))
 	{
 //		gi.dprintf("tried to free special edict\n");
 		return;
@@ -404,12 +754,42 @@ void G_FreeEdict (edict_t *ed)
 	if (ed->physicBody != NULL)
 		RemovePhysBody(ed);
 
+	// freeing twice must not queue it twice
+	const bool bWasInUse = ed->inUse;
+
+	G_UnindexEdict (ed);
+
 	memset (ed, 0, sizeof(*ed));
 	ed->s.Clear();
 	ed->classname = "freed";
 	ed->freetime = level.time;
 	ed->inUse = false;
 	ed->physicBody = NULL;
+
+	if (!bWasInUse)
+		return;
+
+	g_edictAlloc.freeQueue[(g_edictAlloc.freeHead + g_edictAlloc.freeCount) % game.maxentities] = entNum;
+	g_edictAlloc.freeCount++;
+	g_edictAlloc.numFrees++;
+
+	// don't make the server walk free slots at the end of the list
+	if (entNum == globals.numEdicts-1)
+	{
+		while (globals.numEdicts > game.maxclients+BODY_QUEUE_SIZE+1 && !g_edicts[globals.numEdicts-1].inUse)
+			globals.numEdicts--;
+	}
+}
+
+/*
+=================
+G_PrintEdictStats
+=================
+*/
+void G_PrintEdictStats ()
+{
+	gi.cprintf (NULL, PRINT_HIGH, "numEdicts %i, high water %i of %i, %i queued free\n", globals.numEdicts, g_edictAlloc.highWater, game.maxentities, g_edictAlloc.freeCount);
+	gi.cprintf (NULL, PRINT_HIGH, "%u allocs (%u reused), %u frees\n", g_edictAlloc.numAllocs, g_edictAlloc.numReused, g_edictAlloc.numFrees);
 }
 
 
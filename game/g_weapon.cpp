@@ -379,7 +379,7 @@ void fire_blaster (edict_t *self, vec3_t start, vec3_t dir, int damage, int spee
 	bolt->nextthink = level.time + 2;
 	bolt->think = G_FreeEdict;
 	bolt->dmg = damage;
-	bolt->classname = "bolt";
+	G_SetEdictKey (bolt, EK_CLASSNAME, "bolt");
 	if (hyper)
 		bolt->spawnflags = 1;
 	gi.linkentity (bolt);
@@ -498,7 +498,7 @@ void fire_grenade (edict_t *self, vec3_t start, vec3_t aimdir, int damage, int s
 	grenade->think = Grenade_Explode;
 	grenade->dmg = damage;
 	grenade->dmg_radius = damage_radius;
-	grenade->classname = "grenade";
+	G_SetEdictKey (grenade, EK_CLASSNAME, "grenade");
 
 	gi.linkentity (grenade);
 }
@@ -531,7 +531,7 @@ void fire_grenade2 (edict_t *self, vec3_t start, vec3_t aimdir, int damage, int
 	grenade->think = Grenade_Explode;
 	grenade->dmg = damage;
 	grenade->dmg_radius = damage_radius;
-	grenade->classname = "hgrenade";
+	G_SetEdictKey (grenade, EK_CLASSNAME, "hgrenade");
 	if (held)
 		grenade->spawnflags = 3;
 	else
@@ -630,7 +630,7 @@ void fire_rocket (edict_t *self, vec3_t start, vec3_t dir, int damage, int speed
 	rocket->radius_dmg = radius_damage;
 	rocket->dmg_radius = damage_radius;
 	rocket->s.sound = gi.soundindex ("weapons/rockfly.wav");
-	rocket->classname = "rocket";
+	G_SetEdictKey (rocket, EK_CLASSNAME, "rocket");
 
 	if (self->client)
 		check_dodge (self, rocket->s.origin, dir, speed);
@@ -722,9 +722,13 @@ void bfg_explode (edict_t *self)
 	if (self->s.frame == 0)
 	{
 		// the BFG effect
-		ent = NULL;
-		while ((ent = findradius(ent, self->s.origin, self->dmg_radius)) != NULL)
+		edict_t *hits[MAX_RADIUS_EDICTS];
+		const int numHits = G_FindRadius (self->s.origin, self->dmg_radius, hits, MAX_RADIUS_EDICTS);
+		for (int i=0 ; i<numHits ; i++)
 		{
+			ent = hits[i];
+			if (!ent->inUse)
+				continue;
 			if (!ent->takedamage)
 				continue;
 			if (ent == self->owner)
@@ -815,9 +819,14 @@ void bfg_think (edict_t *self)
 
 	PhysExplosion(self->s.origin, 350, 0.85f, -55.0f);
 
-	ent = NULL;
-	while ((ent = findradius(ent, self->s.origin, 256)) != NULL)
+	edict_t *hits[MAX_RADIUS_EDICTS];
+	const int numHits = G_FindRadius (self->s.origin, 256, hits, MAX_RADIUS_EDICTS);
+	for (int i=0 ; i<numHits ; i++)
 	{
+		ent = hits[i];
+		if (!ent->inUse)
+			continue;
+
 		if (ent == self)
 			continue;
 
@@ -900,7 +909,7 @@ void fire_bfg (edict_t *self, vec3_t start, vec3_t dir, int damage, int speed, f
 	bfg->think = G_FreeEdict;
 	bfg->radius_dmg = damage;
 	bfg->dmg_radius = damage_radius;
-	bfg->classname = "bfg blast";
+	G_SetEdictKey (bfg, EK_CLASSNAME, "bfg blast");
 	bfg->s.sound = gi.soundindex ("weapons/bfg__l1a.wav");
 
 	bfg->think = bfg_think;
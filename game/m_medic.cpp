@@ -45,11 +45,14 @@ static int	sound_hook_retract;
 
 edict_t *medic_FindDeadMonster (edict_t *self)
 {
-	edict_t	*ent = NULL;
+	edict_t	*ent;
 	edict_t	*best = NULL;
+	edict_t	*hits[MAX_RADIUS_EDICTS];
 
-	while ((ent = findradius(ent, self->s.origin, 1024)) != NULL)
+	const int numHits = G_FindRadius (self->s.origin, 1024, hits, MAX_RADIUS_EDICTS);
+	for (int i=0 ; i<numHits ; i++)
 	{
+		ent = hits[i];
 		if (ent == self)
 			continue;
 		if (!(ent->svFlags & SVF_MONSTER))
@@ -614,7 +617,7 @@ void medic_cable_attack (edict_t *self)
 		self->enemy->spawnflags = 0;
 		self->enemy->monsterinfo.aiflags = 0;
 		self->enemy->target = NULL;
-		self->enemy->targetname = NULL;
+		G_SetEdictKey (self->enemy, EK_TARGETNAME, NULL);
 		self->enemy->combattarget = NULL;
 		self->enemy->deathtarget = NULL;
 		self->enemy->owner = self;
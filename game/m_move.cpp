@@ -23,6 +23,116 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 #define STEPSIZE	18
 
+/*
+=============================================================================
+
+	MOVE TRACE CACHE
+
+	A monster that can't step in one direction tries again in up to nine
+	others, and SV_NewChaseDir often comes back to a direction it already
+	tried this frame from the same spot. Movement traces go through here
+	and are kept for the rest of the frame, keyed on the exact trace and the
+	entity it passes through, so a repeated query costs a lookup instead of
+	a trace. Entries from earlier frames are simply ignored.
+
+=============================================================================
+*/
+
+#define MOVE_CACHE_SIZE		1024	// must be a power of two
+#define MOVE_CACHE_MASK		(MOVE_CACHE_SIZE-1)
+
+struct moveCacheEntry_t
+{
+	int			framenum;
+	edict_t		*passEnt;
+	int			contentMask;
+	vec3_t		start, mins, maxs, end;
+	cmTrace_t	trace;
+};
+
+static moveCacheEntry_t	m_moveCache[MOVE_CACHE_SIZE];
+
+static struct moveStats_t
+{
+	uint32		numHits;
+	uint32		numTraces;
+} m_moveStats;
+
+/*
+=============
+M_ClearMoveCache
+
+Called on every map change, since frame numbers start over.
+=============
+*/
+void M_ClearMoveCache ()
+{
+	memset (m_moveCache, 0, sizeof(m_moveCache));
+	memset (&m_moveStats, 0, sizeof(m_moveStats));
+}
+
+static inline uint32 M_MoveCacheHash (const vec3_t start, const vec3_t end, const edict_t *passEnt)
+{
+	const uint32 *s = (const uint32 *)start;
+	const uint32 *e = (const uint32 *)end;
+
+	uint32 hash = passEnt ? passEnt - g_edicts : 0;
+	for (int i=0 ; i<3 ; i++)
+		hash = (hash * 31 + s[i]) * 31 + e[i];
+
+	return (hash ^ (hash >> 15)) & MOVE_CACHE_MASK;
+}
+
+/*
+=============
+M_MoveTrace
+
+gi.trace for monster movement, reusing this frame's result when the exact
+same trace was already asked for.
+=============
+*/
+static cmTrace_t M_MoveTrace (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, edict_t *passEnt, const int contentMask)
+{
+	moveCacheEntry_t *entry = &m_moveCache[M_MoveCacheHash (start, end, passEnt)];
+
+	if (entry->framenum == level.framenum
+	&& entry->passEnt == passEnt
+	&& entry->contentMask == contentMask
+	&& Vec3Compare (entry->start, start)
+	&& Vec3Compare (entry->end, end)
+	&& Vec3Compare (entry->mins, mins)
+	&& Vec3Compare (entry->maxs, maxs))
+	{
+		m_moveStats.numHits++;
+		return entry->trace;
+	}
+
+	m_moveStats.numTraces++;
+	entry->trace = gi.trace (start, mins, maxs, end, passEnt, contentMask);
+
+	entry->framenum = level.framenum;
+	entry->passEnt = passEnt;
+	entry->contentMask = contentMask;
+	Vec3Copy (start, entry->start);
+	Vec3Copy (end, entry->end);
+	Vec3Copy (mins, entry->mins);
+	Vec3Copy (maxs, entry->maxs);
+
+	return entry->trace;
+}
+
+/*
+=============
+M_PrintMoveStats
+=============
+*/
+void M_PrintMoveStats ()
+{
+	gi.cprintf (NULL, PRINT_HIGH, "%u move trace cache hits, %u traces\n", m_moveStats.numHits, m_moveStats.numTraces);
+}
+
+//============================================================================
+
 /*
 =============
 M_CheckBottom
@@ -71,7 +181,7 @@ realcheck:
 	start[0] = stop[0] = (mins[0] + maxs[0])*0.5;
 	start[1] = stop[1] = (mins[1] + maxs[1])*0.5;
 	stop[2] = start[2] - 2*STEPSIZE;
-	trace = gi.trace (start, vec3Origin, vec3Origin, stop, ent, CONTENTS_MASK_MONSTERSOLID);
+	trace = M_MoveTrace (start, vec3Origin, vec3Origin, stop, ent, CONTENTS_MASK_MONSTERSOLID);
 
 	if (trace.fraction == 1.0)
 		return false;
@@ -84,7 +194,7 @@ realcheck:
 			start[0] = stop[0] = x ? maxs[0] : mins[0];
 			start[1] = stop[1] = y ? maxs[1] : mins[1];
 			
-			trace = gi.trace (start, vec3Origin, vec3Origin, stop, ent, CONTENTS_MASK_MONSTERSOLID);
+			trace = M_MoveTrace (start, vec3Origin, vec3Origin, stop, ent, CONTENTS_MASK_MONSTERSOLID);
 			
 			if (trace.fraction != 1.0 && trace.endPos[2] > bottom)
 				bottom = trace.endPos[2];
@@ -155,7 +265,7 @@ bool SV_movestep (edict_t *ent, vec3_t move, bool relink)
 						neworg[2] += dz;
 				}
 			}
-			trace = gi.trace (ent->s.origin, ent->mins, ent->maxs, neworg, ent, CONTENTS_MASK_MONSTERSOLID);
+			trace = M_MoveTrace (ent->s.origin, ent->mins, ent->maxs, neworg, ent, CONTENTS_MASK_MONSTERSOLID);
 	
 			// fly monsters don't enter water voluntarily
 			if (ent->flags & FL_FLY)
@@ -213,7 +323,7 @@ bool SV_movestep (edict_t *ent, vec3_t move, bool relink)
 	Vec3Copy (neworg, end);
 	end[2] -= stepsize*2;
 
-	trace = gi.trace (neworg, ent->mins, ent->maxs, end, ent, CONTENTS_MASK_MONSTERSOLID);
+	trace = M_MoveTrace (neworg, ent->mins, ent->maxs, end, ent, CONTENTS_MASK_MONSTERSOLID);
 
 	if (trace.allSolid)
 		return false;
@@ -221,7 +331,7 @@ bool SV_movestep (edict_t *ent, vec3_t move, bool relink)
 	if (trace.startSolid)
 	{
 		neworg[2] -= stepsize;
-		trace = gi.trace (neworg, ent->mins, ent->maxs, end, ent, CONTENTS_MASK_MONSTERSOLID);
+		trace = M_MoveTrace (neworg, ent->mins, ent->maxs, end, ent, CONTENTS_MASK_MONSTERSOLID);
 		if (trace.allSolid || trace.startSolid)
 			return false;
 	}
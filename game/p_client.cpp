@@ -56,7 +56,7 @@ static void SP_FixCoopSpots (edict_t *self)
 			if ((!self->targetname) || Q_stricmp(self->targetname, spot->targetname) != 0)
 			{
 //				gi.dprintf("FixCoopSpots changed %s at %s targetname from %s to %s\n", self->classname, vtos(self->s.origin), self->targetname, spot->targetname);
-				self->targetname = spot->targetname;
+				G_SetEdictKey (self, EK_TARGETNAME, spot->targetname);
 			}
 			return;
 		}
@@ -74,27 +74,27 @@ static void SP_CreateCoopSpots (edict_t *self)
 	if(Q_stricmp(level.mapname, "security") == 0)
 	{
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetEdictKey (spot, EK_CLASSNAME, "info_player_coop");
 		spot->s.origin[0] = 188 - 64;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetEdictKey (spot, EK_TARGETNAME, "jail3");
 		spot->s.angles[1] = 90;
 
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetEdictKey (spot, EK_CLASSNAME, "info_player_coop");
 		spot->s.origin[0] = 188 + 64;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetEdictKey (spot, EK_TARGETNAME, "jail3");
 		spot->s.angles[1] = 90;
 
 		spot = G_Spawn();
-		spot->classname = "info_player_coop";
+		G_SetEdictKey (spot, EK_CLASSNAME, "info_player_coop");
 		spot->s.origin[0] = 188 + 128;
 		spot->s.origin[1] = -164;
 		spot->s.origin[2] = 80;
-		spot->targetname = "jail3";
+		G_SetEdictKey (spot, EK_TARGETNAME, "jail3");
 		spot->s.angles[1] = 90;
 
 		return;
@@ -949,7 +949,7 @@ void InitBodyQue ()
 	for (i=0; i<BODY_QUEUE_SIZE ; i++)
 	{
 		ent = G_Spawn();
-		ent->classname = "bodyque";
+		G_SetEdictKey (ent, EK_CLASSNAME, "bodyque");
 	}
 }
 
@@ -1188,7 +1188,7 @@ void PutClientInServer (edict_t *ent)
 	ent->movetype = MOVETYPE_WALK;
 	ent->viewheight = 22;
 	ent->inUse = true;
-	ent->classname = "player";
+	G_SetEdictKey (ent, EK_CLASSNAME, "player");
 	ent->mass = 200;
 	ent->solid = SOLID_BBOX;
 	ent->deadflag = DEAD_NO;
@@ -1348,7 +1348,7 @@ void ClientBegin (edict_t *ent)
 		// except for the persistant data that was initialized at
 		// ClientConnect() time
 		G_InitEdict (ent);
-		ent->classname = "player";
+		G_SetEdictKey (ent, EK_CLASSNAME, "player");
 		InitClientResp (ent->client);
 		PutClientInServer (ent);
 	}
@@ -1541,7 +1541,7 @@ void ClientDisconnect (edict_t *ent)
 	ent->s.modelIndex = 0;
 	ent->solid = SOLID_NOT;
 	ent->inUse = false;
-	ent->classname = "disconnected";
+	G_SetEdictKey (ent, EK_CLASSNAME, "disconnected");
 	ent->client->pers.connected = false;
 
 	playernum = ent-g_edicts-1;
@@ -56,7 +56,7 @@ void PlayerTrail_Init ()
 	for (n = 0; n < TRAIL_LENGTH; n++)
 	{
 		trail[n] = G_Spawn();
-		trail[n]->classname = "player_trail";
+		G_SetEdictKey (trail[n], EK_CLASSNAME, "player_trail");
 	}
 
 	trail_head = 0;
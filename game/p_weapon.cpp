@@ -78,7 +78,7 @@ void PlayerNoise(edict_t *who, vec3_t where, int type)
 	if (!who->mynoise)
 	{
 		noise = G_Spawn();
-		noise->classname = "player_noise";
+		G_SetEdictKey (noise, EK_CLASSNAME, "player_noise");
 		Vec3Set (noise->mins, -8, -8, -8);
 		Vec3Set (noise->maxs, 8, 8, 8);
 		noise->owner = who;
@@ -86,7 +86,7 @@ void PlayerNoise(edict_t *who, vec3_t where, int type)
 		who->mynoise = noise;
 
 		noise = G_Spawn();
-		noise->classname = "player_noise";
+		G_SetEdictKey (noise, EK_CLASSNAME, "player_noise");
 		Vec3Set (noise->mins, -8, -8, -8);
 		Vec3Set (noise->maxs, 8, 8, 8);
 		noise->owner = who;
@@ -289,6 +289,7 @@ struct refRegInfo_t
 	// Images
 	uint32					imagesReleased;
 	uint32					imagesResampled;
+	uint32					imagesCached;
 	uint32					imagesSeaked;
 	uint32					imagesTouched;
 
@@ -394,6 +395,13 @@ extern refInfo_t			ri;
 */
 
 extern bool r_bInTimeDemo;
+extern bool r_bNullBackend;
+
+// Mesh lists are still built and sorted, but nothing is handed to GL
+inline bool R_SkipBackend()
+{
+	return r_bNullBackend || r_skipBackend->intVal;
+}
 
 class qStatCycle_Scope
 {
@@ -181,6 +181,7 @@ void R_EndFrame();
 void R_BeginTimeDemo();
 void R_TimeDemoFrame();
 void R_EndTimeDemo();
+void R_SetNullBackend(const bool bEnable);
 
 void R_ClearScene();
 
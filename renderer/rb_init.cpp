@@ -368,6 +368,13 @@ static void GL_InitExtensions()
 			if (ri.config.ext.bTexCompression || !r_ext_textureCompression->intVal)
 				break;
 		}
+
+		// Used by the image cache to store and reload pre-compressed levels
+		if (ri.config.ext.bTexCompression)
+		{
+			qglCompressedTexImage2DARB = (PFNGLCOMPRESSEDTEXIMAGE2DARBPROC)GLimp_GetProcAddress("glCompressedTexImage2DARB");
+			qglGetCompressedTexImageARB = (PFNGLGETCOMPRESSEDTEXIMAGEARBPROC)GLimp_GetProcAddress("glGetCompressedTexImageARB");
+		}
 	}
 	else
 	{
@@ -1109,6 +1116,8 @@ bool RB_BackendInit()
 	ri.config.ext.max3DTexSize = 0;
 
 	ri.config.ext.bTexCompression = false;
+	qglCompressedTexImage2DARB = NULL;
+	qglGetCompressedTexImageARB = NULL;
 
 	ri.config.ext.bTexCubeMap = false;
 	ri.config.ext.maxCMTexSize = 0;
@@ -77,6 +77,10 @@ void		(APIENTRYP qglUnlockArraysEXT) ();
 // GL_EXT_draw_range_elements
 void		(APIENTRYP qglDrawRangeElementsEXT) (GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const GLvoid *indices);
 
+// GL_ARB_texture_compression
+void		(APIENTRYP qglCompressedTexImage2DARB) (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data);
+void		(APIENTRYP qglGetCompressedTexImageARB) (GLenum target, GLint level, GLvoid *img);
+
 // GL_ARB_vertex_buffer_object
 void		(APIENTRYP qglBindBufferARB) (GLenum target, GLuint buffer);
 void		(APIENTRYP qglDeleteBuffersARB) (GLsizei n, const GLuint *buffers);
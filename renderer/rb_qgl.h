@@ -104,6 +104,10 @@ extern void		(APIENTRYP qglUnlockArraysEXT) ();
 // GL_EXT_draw_range_elements
 extern void		(APIENTRYP qglDrawRangeElementsEXT) (GLenum mode, GLuint count, GLuint start, GLsizei end, GLenum type, const GLvoid *indices);
 
+// GL_ARB_texture_compression
+extern void		(APIENTRYP qglCompressedTexImage2DARB) (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data);
+extern void		(APIENTRYP qglGetCompressedTexImageARB) (GLenum target, GLint level, GLvoid *img);
+
 // GL_ARB_vertex_buffer_object
 extern void		(APIENTRYP qglBindBufferARB) (GLenum target, GLuint buffer);
 extern void		(APIENTRYP qglDeleteBuffersARB) (GLsizei n, const GLuint *buffers);
@@ -2144,8 +2144,12 @@ This is the entry point for rendering just about everything
 */
 void RB_RenderMeshBuffer(refMeshBuffer *mb)
 {
-	if (r_skipBackend->intVal)
+	if (R_SkipBackend())
+	{
+		// Drop the batch so the next one starts empty
+		RB_ResetPointers();
 		return;
+	}
 
 	if (!rb.numVerts || !rb.numIndexes)
 		return;
@@ -2452,7 +2456,8 @@ void RB_BeginFrame()
 	prevUpdate = Sys_UMilliseconds() % interval;
 
 	// Setup the frame for rendering
-	GLimp_BeginFrame();
+	if (!R_SkipBackend())
+		GLimp_BeginFrame();
 
 	// Go into 2D mode
 	RB_SetupGL2D();
@@ -2479,7 +2484,8 @@ void RB_EndFrame()
 	RF_Flush2D();
 
 	// Swap buffers
-	GLimp_EndFrame();
+	if (!R_SkipBackend())
+		GLimp_EndFrame();
 }
 
 /*
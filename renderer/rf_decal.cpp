@@ -215,6 +215,9 @@ static plane_t			r_fragmentPlanes[6];
 static vec3_t			r_decalOrigin;
 static vec3_t			r_decalNormal;
 static float			r_decalRadius;
+static vec3_t			r_decalMins, r_decalMaxs;	// World bounds of the clipping box
+static simdVec_t		r_decalAxis[3][4];			// Splatted axis and origin distance, for R_ClassifyFragmentTri
+
 
 /*
 =================
@@ -325,6 +328,98 @@ static void R_WindingClipFragment(vec3_t *wVerts, int numVerts, refFragment_t *f
 	r_numFragmentVerts += numv;
 }
 
+/*
+=================
+R_ClassifyFragmentTri
+
+Tests the three corners against the whole clipping box at once, in the
+box's own axes. Returns -1 when one side has every corner behind it, 1 when
+every corner is in front of all six sides, and 0 when the triangle needs
+R_WindingClipFragment. Both early outs stay a little short of LARGE_EPSILON
+so they never disagree with the full clipper.
+=================
+*/
+#define FRAGMENT_CLASSIFY_SLACK	0.01f
+
+static int R_ClassifyFragmentTri (vec3_t *tri)
+{
+	int			i, inside;
+	simdVec_t	x, y, z, l;
+	simdVec_t	outer, inner, negOuter, negInner;
+
+	const float xs[4] = { tri[0][0], tri[1][0], tri[2][0], tri[0][0] };
+	const float ys[4] = { tri[0][1], tri[1][1], tri[2][1], tri[0][1] };
+	const float zs[4] = { tri[0][2], tri[1][2], tri[2][2], tri[0][2] };
+	x = Simd_Load (xs);
+	y = Simd_Load (ys);
+	z = Simd_Load (zs);
+
+	outer = Simd_Splat (r_decalRadius + LARGE_EPSILON + FRAGMENT_CLASSIFY_SLACK);
+	inner = Simd_Splat (r_decalRadius - LARGE_EPSILON - FRAGMENT_CLASSIFY_SLACK);
+	negOuter = Simd_Sub (Simd_Zero (), outer);
+	negInner = Simd_Sub (Simd_Zero (), inner);
+
+	inside = 1;
+	for (i=0 ; i<3 ; i++) {
+		// Distance of each corner from the box center along this axis
+		l = Simd_Sub (Simd_Madd (x, r_decalAxis[i][0], Simd_Madd (y, r_decalAxis[i][1], Simd_Mul (z, r_decalAxis[i][2]))), r_decalAxis[i][3]);
+
+		if (Simd_MoveMask (Simd_CmpLT (l, negOuter)) == 0xF || Simd_MoveMask (Simd_CmpGT (l, outer)) == 0xF)
+			return -1;
+		if (Simd_MoveMask (Simd_And (Simd_CmpGT (l, negInner), Simd_CmpLT (l, inner))) != 0xF)
+			inside = 0;
+	}
+
+	return inside;
+}
+
+
+/*
+=================
+R_ClipFragmentTri
+=================
+*/
+static void R_ClipFragmentTri (vec3_t *tri, refFragment_t *fr)
+{
+	int		i;
+
+	switch (R_ClassifyFragmentTri (tri)) {
+	case -1:
+		return;
+
+	case 1:
+		// Clips to itself
+		if (r_numFragmentVerts + 3 > MAX_DECAL_VERTS)
+			return;
+
+		fr->numVerts = 3;
+		fr->firstVert = r_numFragmentVerts;
+
+		for (i=0 ; i<3 ; i++) {
+			Vec3Copy (fr->normal, r_fragmentNormals[r_numFragmentVerts + i]);
+			Vec3Copy (tri[i], r_fragmentVerts[r_numFragmentVerts + i]);
+		}
+		r_numFragmentVerts += 3;
+		return;
+
+	default:
+		R_WindingClipFragment (tri, 3, fr);
+		return;
+	}
+}
+
+
+/*
+=================
+R_FragmentBoundsCull
+=================
+*/
+static inline bool R_FragmentBoundsCull (const vec3_t mins, const vec3_t maxs)
+{
+	return (mins[0] > r_decalMaxs[0] || mins[1] > r_decalMaxs[1] || mins[2] > r_decalMaxs[2]
+		|| maxs[0] < r_decalMins[0] || maxs[1] < r_decalMins[1] || maxs[2] < r_decalMins[2]);
+}
+
 /*
 =================
 R_PlanarSurfClipFragment
@@ -360,7 +455,7 @@ static void R_PlanarSurfClipFragment (mBspSurface_t *surf, mBspNode_t *node)
 		Vec3Copy (verts[index[1]], tri[1]);
 		Vec3Copy (verts[index[2]], tri[2]);
 
-		R_WindingClipFragment (tri, 3, fr);
+		R_ClipFragmentTri (tri, fr);
 		if (fr->numVerts && (r_numFragmentVerts == MAX_DECAL_VERTS || ++r_numClippedFragments == MAX_DECAL_FRAGMENTS))
 			return;
 	}
@@ -397,6 +492,8 @@ mark0:
 		leaf = (mBspLeaf_t *)node;
 		if (!leaf->firstFragmentSurface)
 			return;
+		if (!leaf->badBounds && R_FragmentBoundsCull (leaf->mins, leaf->maxs))
+			return;
 
 		mark = leaf->firstFragmentSurface;
 		do {
@@ -413,6 +510,8 @@ mark0:
 
 			if (surf->q2_numEdges < 3)
 				continue;		// Bogus face
+			if (R_FragmentBoundsCull (surf->mins, surf->maxs))
+				continue;		// Nowhere near the box
 
 			if (surf->q2_flags & SURF_PLANEBACK) {
 				if (DotProduct(r_decalNormal, surf->q2_plane->normal) > -0.5f)
@@ -495,7 +594,7 @@ static void R_Q3BSP_PatchSurfClipFragment (mBspSurface_t *surf, mBspNode_t *node
 		if (DotProduct(r_decalNormal, snorm) < 0.5f * Vec3Length(snorm))
 			continue;	// Greater than 60 degrees
 
-		R_WindingClipFragment (tri, 3, fr);
+		R_ClipFragmentTri (tri, fr);
 		if (fr->numVerts && (r_numFragmentVerts == MAX_DECAL_VERTS || ++r_numClippedFragments == MAX_DECAL_FRAGMENTS))
 			return;
 	}
@@ -521,6 +620,8 @@ static void R_Q3BSP_FragmentNode ()
 			leaf = (mBspLeaf_t *)node;
 			if (!leaf->firstFragmentSurface)
 				goto nextNodeOnStack;
+			if (!leaf->badBounds && R_FragmentBoundsCull (leaf->mins, leaf->maxs))
+				goto nextNodeOnStack;
 
 			mark = leaf->firstFragmentSurface;
 			do {
@@ -532,6 +633,9 @@ static void R_Q3BSP_FragmentNode ()
 					continue;
 				surf->fragmentFrame = r_fragmentFrame;
 
+				if (R_FragmentBoundsCull (surf->mins, surf->maxs))
+					continue;		// Nowhere near the box
+
 				if (surf->q3_faceType == FACETYPE_PLANAR) {
 					if (DotProduct(r_decalNormal, surf->q3_origin) < 0.5f)
 						continue;		// Greater than 60 degrees
@@ -573,8 +677,8 @@ R_GetClippedFragments
 */
 static uint32 R_GetClippedFragments (vec3_t origin, float radius, vec3_t axis[3])
 {
-	int		i;
-	float	d;
+	int		i, j;
+	float	d, extent;
 
 	if (ri.def.rdFlags & RDF_NOWORLDMODEL)
 		return 0;
@@ -603,6 +707,17 @@ static uint32 R_GetClippedFragments (vec3_t origin, float radius, vec3_t axis[3]
 		Vec3Negate (axis[i], r_fragmentPlanes[i*2+1].normal);
 		r_fragmentPlanes[i*2+1].dist = -d - radius;
 		r_fragmentPlanes[i*2+1].type = PlaneTypeForNormal (r_fragmentPlanes[i*2+1].normal);
+
+		for (j=0 ; j<3 ; j++)
+			r_decalAxis[i][j] = Simd_Splat (axis[i][j]);
+		r_decalAxis[i][3] = Simd_Splat (d);
+	}
+
+	// World bounds of the box, padded so nothing the clipper would keep is culled
+	for (i=0 ; i<3 ; i++) {
+		extent = radius * (fabs (axis[0][i]) + fabs (axis[1][i]) + fabs (axis[2][i])) + 1.0f;
+		r_decalMins[i] = origin[i] - extent;
+		r_decalMaxs[i] = origin[i] + extent;
 	}
 
 	if (ri.scn.worldModel->type == MODEL_Q3BSP)
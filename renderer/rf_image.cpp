@@ -37,6 +37,7 @@ extern "C" {
 #endif
 
 #include <unordered_map>
+#include <sys/stat.h>
 
 typedef std::tr1::unordered_map<std::string, refImage_t*> TImageList;
 TImageList imageList;
@@ -1237,48 +1238,309 @@ static inline GLenum R_ImageUploadType(const texFlags_t flags)
 }
 
 
+/*
+==============================================================================
+
+	IMAGE PROCESSING
+
+	Resampling, channel replacement, gamma/intensity and mipmapping run in
+	bands of rows on r_imageJobs. Each band only writes its own output rows,
+	so the bands need no locking, and the GL upload stays on the calling
+	thread once the jobs return.
+==============================================================================
+*/
+
+JobPool r_imageJobs;
+
+#define IMAGE_BAND_ROWS		32
+
+#ifdef HAVE_SSE2
+/*
+================
+R_AveragePixels
+
+Per channel (a + b + c + d) >> 2 for four RGBA pixels at once.
+================
+*/
+static inline __m128i R_AveragePixels(const __m128i a, const __m128i b, const __m128i c, const __m128i d)
+{
+	const __m128i zero = _mm_setzero_si128();
+
+	__m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)), _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+	__m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)), _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+
+	return _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2));
+}
+#endif // HAVE_SSE2
+
+
 /*
 ================
-R_LightScaleImage
+R_LightScaleTable
 
-Scale up the pixel values in a texture to increase the lighting range
+Folds gamma and intensity into a single lookup. Returns false if neither applies.
 ================
 */
-static void R_LightScaleImage(uint32 *in, const int inWidth, const int inHeight, const bool useGamma, const bool useIntensity)
+static bool R_LightScaleTable(byte *table, const bool useGamma, const bool useIntensity)
 {
-	byte *out = (byte *)in;
-	int c = inWidth * inHeight;
+	if (!useGamma && !useIntensity)
+		return false;
 
-	if (useGamma)
+	for (int i=0 ; i<256 ; i++)
 	{
-		if (useIntensity)
+		int c = useIntensity ? r_intensityTable[i] : i;
+		table[i] = useGamma ? r_gammaTable[c] : c;
+	}
+
+	return true;
+}
+
+
+/*
+================
+R_LightScaleRows
+
+Forces channels to 255 with orMask, then scales up the pixel values to
+increase the lighting range.
+================
+*/
+static void R_LightScaleRows(uint32 *data, const int width, const int firstRow, const int lastRow, const uint32 orMask, const byte *table)
+{
+	uint32 *in = data + firstRow*width;
+	const int c = (lastRow - firstRow) * width;
+
+	if (orMask)
+	{
+		const uint32 mask = LittleLong(orMask);
+		for (int i=0 ; i<c ; i++)
+			in[i] |= mask;
+	}
+
+	if (table)
+	{
+		byte *out = (byte *)in;
+		for (int i=0 ; i<c ; i++, out+=4)
 		{
-			for (int i=0 ; i<c ; i++, out+=4)
-			{
-				out[0] = r_gammaTable[r_intensityTable[out[0]]];
-				out[1] = r_gammaTable[r_intensityTable[out[1]]];
-				out[2] = r_gammaTable[r_intensityTable[out[2]]];
-			}
+			out[0] = table[out[0]];
+			out[1] = table[out[1]];
+			out[2] = table[out[2]];
 		}
-		else
+	}
+}
+
+
+/*
+================
+R_ResampleRows
+
+p1 and p2 hold the two source columns for each output column.
+================
+*/
+static void R_ResampleRows(const uint32 *inData, const int inWidth, const int inHeight, uint32 *outData, const int outWidth, const int outHeight, const uint32 *p1, const uint32 *p2, const int firstRow, const int lastRow)
+{
+	outData += firstRow*outWidth;
+	for (int i=firstRow ; i<lastRow ; i++, outData+=outWidth)
+	{
+		const uint32 *inrow = inData + inWidth * (int)((i + 0.25f) * inHeight / outHeight);
+		const uint32 *inrow2 = inData + inWidth * (int)((i + 0.75f) * inHeight / outHeight);
+
+		int j = 0;
+#ifdef HAVE_SSE2
+		for ( ; j+4<=outWidth ; j+=4)
+		{
+			const __m128i pix1 = _mm_set_epi32(inrow[p1[j+3]], inrow[p1[j+2]], inrow[p1[j+1]], inrow[p1[j]]);
+			const __m128i pix2 = _mm_set_epi32(inrow[p2[j+3]], inrow[p2[j+2]], inrow[p2[j+1]], inrow[p2[j]]);
+			const __m128i pix3 = _mm_set_epi32(inrow2[p1[j+3]], inrow2[p1[j+2]], inrow2[p1[j+1]], inrow2[p1[j]]);
+			const __m128i pix4 = _mm_set_epi32(inrow2[p2[j+3]], inrow2[p2[j+2]], inrow2[p2[j+1]], inrow2[p2[j]]);
+
+			_mm_storeu_si128((__m128i *)(outData + j), R_AveragePixels(pix1, pix2, pix3, pix4));
+		}
+#endif // HAVE_SSE2
+
+		for ( ; j<outWidth ; j++)
+		{
+			const byte *pix1 = (const byte *)(inrow + p1[j]);
+			const byte *pix2 = (const byte *)(inrow + p2[j]);
+			const byte *pix3 = (const byte *)(inrow2 + p1[j]);
+			const byte *pix4 = (const byte *)(inrow2 + p2[j]);
+
+			((byte *)(outData + j))[0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0]) >> 2;
+			((byte *)(outData + j))[1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1]) >> 2;
+			((byte *)(outData + j))[2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2]) >> 2;
+			((byte *)(outData + j))[3] = (pix1[3] + pix2[3] + pix3[3] + pix4[3]) >> 2;
+		}
+	}
+}
+
+
+/*
+================
+R_MipmapRows
+
+Box filters rows of the next mip level. Dimensions of one are averaged with
+themselves, so Nx1 and 1xN levels filter along the long axis only.
+================
+*/
+static void R_MipmapRows(const uint32 *in, const int inWidth, const int inHeight, uint32 *out, const int firstRow, const int lastRow)
+{
+	const int outWidth = Max<int>(inWidth >> 1, 1);
+	const int stepX = (inWidth > 1) ? 1 : 0;
+
+	out += firstRow*outWidth;
+	for (int i=firstRow ; i<lastRow ; i++, out+=outWidth)
+	{
+		const uint32 *row1 = in + inWidth*(i*2);
+		const uint32 *row2 = in + inWidth*Min<int>(i*2+1, inHeight-1);
+
+		int j = 0;
+#ifdef HAVE_SSE2
+		if (inWidth == outWidth*2)
 		{
-			for (int i=0 ; i<c ; i++, out+=4)
+			for ( ; j+4<=outWidth ; j+=4)
 			{
-				out[0] = r_gammaTable[out[0]];
-				out[1] = r_gammaTable[out[1]];
-				out[2] = r_gammaTable[out[2]];
+				// Split eight source pixels from each row into even and odd columns
+				const __m128 a0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(row1 + j*2)));
+				const __m128 a1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(row1 + j*2 + 4)));
+				const __m128 b0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(row2 + j*2)));
+				const __m128 b1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(row2 + j*2 + 4)));
+
+				_mm_storeu_si128((__m128i *)(out + j), R_AveragePixels(
+					_mm_castps_si128(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2,0,2,0))),
+					_mm_castps_si128(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3,1,3,1))),
+					_mm_castps_si128(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(2,0,2,0))),
+					_mm_castps_si128(_mm_shuffle_ps(b0, b1, _MM_SHUFFLE(3,1,3,1)))));
 			}
 		}
+#endif // HAVE_SSE2
+
+		for ( ; j<outWidth ; j++)
+		{
+			const byte *pix1 = (const byte *)(row1 + j*2);
+			const byte *pix2 = (const byte *)(row1 + j*2 + stepX);
+			const byte *pix3 = (const byte *)(row2 + j*2);
+			const byte *pix4 = (const byte *)(row2 + j*2 + stepX);
+			byte *dest = (byte *)(out + j);
+
+			dest[0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0]) >> 2;
+			dest[1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1]) >> 2;
+			dest[2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2]) >> 2;
+			dest[3] = (pix1[3] + pix2[3] + pix3[3] + pix4[3]) >> 2;
+		}
 	}
-	else if (useIntensity)
+}
+
+
+struct imagePrepJob_t
+{
+	const uint32	*inData;
+	int				inWidth;
+	int				inHeight;
+
+	uint32			*outData;
+	int				outWidth;
+	int				outHeight;
+
+	const uint32	*p1;		// NULL when the size doesn't change
+	const uint32	*p2;
+
+	uint32			orMask;
+	const byte		*lightTable;
+};
+
+static void R_ImagePrepJob(void *arg, const int taskNum, const int threadNum)
+{
+	const imagePrepJob_t *job = (const imagePrepJob_t*)arg;
+	const int firstRow = taskNum * IMAGE_BAND_ROWS;
+	const int lastRow = Min<int>(firstRow + IMAGE_BAND_ROWS, job->outHeight);
+
+	if (job->p1)
+		R_ResampleRows(job->inData, job->inWidth, job->inHeight, job->outData, job->outWidth, job->outHeight, job->p1, job->p2, firstRow, lastRow);
+	else
+		memcpy(job->outData + firstRow*job->outWidth, job->inData + firstRow*job->inWidth, (lastRow - firstRow) * job->outWidth * sizeof(uint32));
+
+	R_LightScaleRows(job->outData, job->outWidth, firstRow, lastRow, job->orMask, job->lightTable);
+}
+
+
+/*
+================
+R_PrepareImage
+
+Resamples to the upload size, replaces channels if desired and applies image
+gamma/intensity.
+================
+*/
+static void R_PrepareImage(const uint32 *inData, const int inWidth, const int inHeight, uint32 *outData, const int outWidth, const int outHeight, const texFlags_t flags, const bool bMipMap)
+{
+	imagePrepJob_t job;
+	byte lightTable[256];
+
+	job.inData = inData;
+	job.inWidth = inWidth;
+	job.inHeight = inHeight;
+	job.outData = outData;
+	job.outWidth = outWidth;
+	job.outHeight = outHeight;
+	job.p1 = job.p2 = NULL;
+
+	if (inWidth != outWidth || inHeight != outHeight)
 	{
-		for (int i=0 ; i<c ; i++, out+=4)
+		uint32 *columns = (uint32*)R_AllocateTexBuffer(TEXBUF_SCRATCH, outWidth*2*sizeof(uint32));
+		uint32 *p1 = columns;
+		uint32 *p2 = columns + outWidth;
+
+		const uint32 fracstep = inWidth * 0x10000 / outWidth;
+		uint32 frac = fracstep >> 2;
+		for (int i=0 ; i<outWidth ; i++)
+		{
+			p1[i] = frac >> 16;
+			frac += fracstep;
+		}
+
+		frac = 3 * (fracstep >> 2);
+		for (int i=0 ; i<outWidth ; i++)
 		{
-			out[0] = r_intensityTable[out[0]];
-			out[1] = r_intensityTable[out[1]];
-			out[2] = r_intensityTable[out[2]];
+			p2[i] = frac >> 16;
+			frac += fracstep;
 		}
+
+		job.p1 = p1;
+		job.p2 = p2;
+		ri.reg.imagesResampled++;
 	}
+
+	// Scan and replace channels if desired
+	if (flags & IF_NORGB)
+		job.orMask = 0x00FFFFFF;
+	else if (flags & IF_NOALPHA)
+		job.orMask = 0xFF000000;
+	else
+		job.orMask = 0;
+
+	// Apply image gamma/intensity
+	const bool bLightScale = R_LightScaleTable(lightTable, (!(flags & IF_NOGAMMA)) && !ri.config.bHWGammaInUse, bMipMap && !(flags & IF_NOINTENS));
+	job.lightTable = bLightScale ? lightTable : NULL;
+
+	r_imageJobs.Run(R_ImagePrepJob, &job, (outHeight + IMAGE_BAND_ROWS-1) / IMAGE_BAND_ROWS);
+}
+
+
+struct imageMipJob_t
+{
+	const uint32	*in;
+	int				inWidth;
+	int				inHeight;
+	uint32			*out;
+	int				outHeight;
+};
+
+static void R_ImageMipJob(void *arg, const int taskNum, const int threadNum)
+{
+	const imageMipJob_t *job = (const imageMipJob_t*)arg;
+	const int firstRow = taskNum * IMAGE_BAND_ROWS;
+	const int lastRow = Min<int>(firstRow + IMAGE_BAND_ROWS, job->outHeight);
+
+	R_MipmapRows(job->in, job->inWidth, job->inHeight, job->out, firstRow, lastRow);
 }
 
 
@@ -1286,82 +1548,389 @@ static void R_LightScaleImage(uint32 *in, const int inWidth, const int inHeight,
 ================
 R_MipmapImage
 
-Operates in place, quartering the size of the texture
+Writes the next mip level of in to out, which must not overlap it.
 ================
 */
-static void R_MipmapImage(byte *in, int inWidth, int inHeight)
+static void R_MipmapImage(const uint32 *in, const int inWidth, const int inHeight, uint32 *out)
 {
-	inWidth <<= 2;
-	inHeight >>= 1;
+	imageMipJob_t job;
+
+	job.in = in;
+	job.inWidth = inWidth;
+	job.inHeight = inHeight;
+	job.out = out;
+	job.outHeight = Max<int>(inHeight >> 1, 1);
+
+	r_imageJobs.Run(R_ImageMipJob, &job, (job.outHeight + IMAGE_BAND_ROWS-1) / IMAGE_BAND_ROWS);
+}
+
+/*
+==============================================================================
+
+	PROCESSED IMAGE CACHE
+
+	The first upload of an image writes its finished mip chain to
+	<gamedir>/imagecache/, named after the source file's stamp (where it was
+	found, its length and modification time, see FS_FileStamp) and a checksum
+	of everything that changes the result (flags, the gamma, intensity and
+	palette tables, picmip, rounding and the maximum texture size). Later loads
+	map the file and hand each level straight to GL, skipping reading,
+	decoding, palette conversion, resampling, light scaling and mipmapping.
+	When the driver compresses the texture the compressed levels are read back
+	and stored instead, so reloads skip the compression too. The header is
+	little-endian on disk. r_imageCacheSize caps the directory, the oldest
+	files are removed at startup once it's over.
+==============================================================================
+*/
+
+#define IMAGECACHE_IDENT		(('C'<<24)+('I'<<16)+('G'<<8)+'E')	// "EGIC"
+#define IMAGECACHE_VERSION		2
+#define IMAGECACHE_MAX_LEVELS	16
+
+struct imageCacheHeader_t
+{
+	uint32		ident;
+	uint32		version;
+
+	int			width;					// Source dimensions, these go through R_CreateImage as usual
+	int			height;
+	int			samples;
+	int			upWidth;
+	int			upHeight;
+
+	GLint		compressedFormat;		// Zero when the levels are plain RGBA
+	int			numLevels;
+	uint32		levelOfs[IMAGECACHE_MAX_LEVELS];
+	uint32		levelSize[IMAGECACHE_MAX_LEVELS];
+};
+
+static uint32						r_imageCacheTables;		// Checksum of the gamma/intensity/palette tables
+static const imageCacheHeader_t		*r_imageCacheLoad;		// Set while R_CreateImage uploads from the cache
+static const byte					*r_imageCacheBase;		// Mapped file r_imageCacheLoad describes
+static const char					*r_imageCacheStore;		// Set while R_CreateImage uploads a new image
+static FILE							*r_imageCacheFile;
+static imageCacheHeader_t			r_imageCacheOut;
+
+/*
+===============
+R_ImageCacheSwapHeader
+===============
+*/
+static void R_ImageCacheSwapHeader(imageCacheHeader_t *header)
+{
+	header->ident = LittleLong(header->ident);
+	header->version = LittleLong(header->version);
+	header->width = LittleLong(header->width);
+	header->height = LittleLong(header->height);
+	header->samples = LittleLong(header->samples);
+	header->upWidth = LittleLong(header->upWidth);
+	header->upHeight = LittleLong(header->upHeight);
+	header->compressedFormat = LittleLong(header->compressedFormat);
+	header->numLevels = LittleLong(header->numLevels);
+	for (int i=0 ; i<IMAGECACHE_MAX_LEVELS ; i++)
+	{
+		header->levelOfs[i] = LittleLong(header->levelOfs[i]);
+		header->levelSize[i] = LittleLong(header->levelSize[i]);
+	}
+}
+
+
+/*
+===============
+R_ImageCacheName
 
-	byte *out = in;
-	for (int i=0 ; i<inHeight ; i++, in+=inWidth)
+Stamps the source file and builds the cache file name for it, the source
+itself isn't read.
+===============
+*/
+static bool R_ImageCacheName(const char *loadName, const texFlags_t flags, char *cacheName, const size_t cacheNameSize)
+{
+	if (!r_imageCache->intVal || r_colorMipLevels->intVal)
+		return false;
+	if (flags & (IT_CUBEMAP|IT_3D|IT_FBO|IT_DEPTHANDFBO|IT_DEPTHFBO))
+		return false;
+
+	uint32 fileStamp;
+	const int fileLen = FS_FileStamp(loadName, &fileStamp);
+	if (fileLen <= 0)
+		return false;
+
+	// Everything else that changes the processed result
+	struct
+	{
+		uint32		tables;
+		int			fileLen;
+		int			flags;
+		int			picmip;
+		int			roundDown;
+		int			maxTexSize;
+		int			hwGamma;
+	} params;
+
+	memset(&params, 0, sizeof(params));
+	params.tables = r_imageCacheTables;
+	params.fileLen = fileLen;
+	params.flags = flags;
+	params.picmip = gl_picmip->intVal;
+	params.roundDown = r_roundImagesDown->intVal;
+	params.maxTexSize = ri.config.maxTexSize;
+	params.hwGamma = ri.config.bHWGammaInUse ? 1 : 0;
+
+	Q_snprintfz(cacheName, cacheNameSize, "%s/imagecache/%08x%08x.img", FS_Gamedir(), fileStamp, Com_BlockChecksum(&params, sizeof(params)));
+	return true;
+}
+
+
+/*
+===============
+R_ImageCacheValid
+
+Makes sure a mapped cache file is complete and can be uploaded as-is. The
+header has already been swapped to host order.
+===============
+*/
+static bool R_ImageCacheValid(const char *name, const imageCacheHeader_t *header, const size_t fileSize, const texFlags_t flags)
+{
+	if (header->ident != IMAGECACHE_IDENT || header->version != IMAGECACHE_VERSION)
+		return false;
+	if (header->width <= 0 || header->height <= 0 || header->upWidth <= 0 || header->upHeight <= 0)
+		return false;
+	if (header->numLevels < 1 || header->numLevels > IMAGECACHE_MAX_LEVELS)
+		return false;
+
+	for (int i=0 ; i<header->numLevels ; i++)
+	{
+		if (header->levelOfs[i] < sizeof(imageCacheHeader_t) || header->levelOfs[i] > fileSize)
+			return false;
+		if (header->levelSize[i] > fileSize - header->levelOfs[i])
+			return false;
+	}
+
+	// Compressed levels only fit the format they were compressed to
+	if (header->compressedFormat)
 	{
-		for (int j=0 ; j<inWidth ; j+=8, out+=4, in+=8)
+		if (!ri.config.ext.bTexCompression || !qglCompressedTexImage2DARB)
+			return false;
+
+		int samples = header->samples;
+		if (R_ImageInternalFormat(name, flags, &samples) != header->compressedFormat)
+			return false;
+	}
+	else
+	{
+		int mipWidth = header->upWidth;
+		int mipHeight = header->upHeight;
+		for (int i=0 ; i<header->numLevels ; i++)
 		{
-			out[0] = (in[0] + in[4] + in[inWidth+0] + in[inWidth+4])>>2;
-			out[1] = (in[1] + in[5] + in[inWidth+1] + in[inWidth+5])>>2;
-			out[2] = (in[2] + in[6] + in[inWidth+2] + in[inWidth+6])>>2;
-			out[3] = (in[3] + in[7] + in[inWidth+3] + in[inWidth+7])>>2;
+			if (header->levelSize[i] != (uint32)(mipWidth * mipHeight * 4))
+				return false;
+
+			mipWidth = Max<int>(mipWidth >> 1, 1);
+			mipHeight = Max<int>(mipHeight >> 1, 1);
 		}
 	}
+
+	return true;
 }
 
 
 /*
-================
-R_ResampleImage
-================
+===============
+R_ImageCacheUpload
+===============
+*/
+static void R_ImageCacheUpload(const byte *base, const imageCacheHeader_t *header, const GLint internalFormat, const GLint sourceFormat, const GLenum uploadType)
+{
+	int mipWidth = header->upWidth;
+	int mipHeight = header->upHeight;
+
+	for (int i=0 ; i<header->numLevels ; i++)
+	{
+		if (header->compressedFormat)
+			qglCompressedTexImage2DARB(GL_TEXTURE_2D, i, header->compressedFormat, mipWidth, mipHeight, 0, header->levelSize[i], base + header->levelOfs[i]);
+		else
+			glTexImage2D(GL_TEXTURE_2D, i, internalFormat, mipWidth, mipHeight, 0, sourceFormat, uploadType, base + header->levelOfs[i]);
+
+		mipWidth = Max<int>(mipWidth >> 1, 1);
+		mipHeight = Max<int>(mipHeight >> 1, 1);
+	}
+}
+
+
+/*
+===============
+R_ImageCacheBegin
+===============
+*/
+static void R_ImageCacheBegin(const int width, const int height, const int samples, const int upWidth, const int upHeight)
+{
+	if (!r_imageCacheStore)
+		return;
+
+	char path[MAX_OSPATH];
+	Q_snprintfz(path, sizeof(path), "%s/imagecache", FS_Gamedir());
+	Sys_Mkdir(path);
+
+	r_imageCacheFile = fopen(r_imageCacheStore, "wb");
+	if (!r_imageCacheFile)
+		return;
+
+	// The real header goes in last, so a partial file never validates
+	memset(&r_imageCacheOut, 0, sizeof(r_imageCacheOut));
+	fwrite(&r_imageCacheOut, sizeof(r_imageCacheOut), 1, r_imageCacheFile);
+
+	r_imageCacheOut.width = width;
+	r_imageCacheOut.height = height;
+	r_imageCacheOut.samples = samples;
+	r_imageCacheOut.upWidth = upWidth;
+	r_imageCacheOut.upHeight = upHeight;
+}
+
+
+/*
+===============
+R_ImageCacheLevel
+
+Called after each level is uploaded.
+===============
 */
-static void R_ResampleImage(uint32 *inData, const int inWidth, const int inHeight, uint32 *outData, const int outWidth, const int outHeight)
+static void R_ImageCacheLevel(const int level, const uint32 *data, const int width, const int height, const GLint internalFormat)
 {
-	if (inWidth == outWidth && inHeight == outHeight)
+	if (!r_imageCacheFile)
+		return;
+
+	if (level >= IMAGECACHE_MAX_LEVELS)
 	{
-		memcpy(outData, inData, inWidth*inHeight*sizeof(uint32));
+		fclose(r_imageCacheFile);
+		r_imageCacheFile = NULL;
+		remove(r_imageCacheStore);
 		return;
 	}
 
-	uint32 *resampleBuffer = (uint32*)R_AllocateTexBuffer(TEXBUF_SCRATCH, outWidth*outHeight*4);
-	uint32 *p1 = resampleBuffer;
-	uint32 *p2 = resampleBuffer + outWidth;
+	// Store what the driver made of it if it compressed the base level
+	if (!level && ri.config.ext.bTexCompression && qglGetCompressedTexImageARB)
+	{
+		GLint bCompressed = GL_FALSE;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED_ARB, &bCompressed);
+		if (bCompressed)
+			r_imageCacheOut.compressedFormat = internalFormat;
+	}
 
-	// Resample
-	const uint32 fracstep = inWidth * 0x10000 / outWidth;
-	uint32 frac = fracstep >> 2;
-	for (int i=0 ; i<outWidth ; i++)
+	const void *levelData = data;
+	GLint levelSize = width * height * 4;
+	if (r_imageCacheOut.compressedFormat)
 	{
-		p1[i] = 4 * (frac >> 16);
-		frac += fracstep;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE_ARB, &levelSize);
+
+		byte *compressed = R_AllocateTexBuffer(TEXBUF_SCRATCH, levelSize);
+		qglGetCompressedTexImageARB(GL_TEXTURE_2D, level, compressed);
+		levelData = compressed;
 	}
 
-	frac = 3 * (fracstep >> 2);
-	for (int i=0 ; i<outWidth ; i++)
+	r_imageCacheOut.levelOfs[level] = (uint32)ftell(r_imageCacheFile);
+	r_imageCacheOut.levelSize[level] = levelSize;
+	r_imageCacheOut.numLevels = level+1;
+	fwrite(levelData, levelSize, 1, r_imageCacheFile);
+}
+
+
+/*
+===============
+R_ImageCacheEnd
+===============
+*/
+static void R_ImageCacheEnd()
+{
+	if (!r_imageCacheFile)
+		return;
+
+	r_imageCacheOut.ident = IMAGECACHE_IDENT;
+	r_imageCacheOut.version = IMAGECACHE_VERSION;
+	R_ImageCacheSwapHeader(&r_imageCacheOut);
+
+	fseek(r_imageCacheFile, 0, SEEK_SET);
+	fwrite(&r_imageCacheOut, sizeof(r_imageCacheOut), 1, r_imageCacheFile);
+
+	const bool bFailed = (ferror(r_imageCacheFile) != 0);
+	fclose(r_imageCacheFile);
+	r_imageCacheFile = NULL;
+
+	if (bFailed)
+		remove(r_imageCacheStore);
+}
+
+
+/*
+===============
+R_ImageCacheTrim
+
+Removes the oldest cache files until the directory fits in r_imageCacheSize
+megabytes.
+===============
+*/
+struct imageCacheFile_t
+{
+	const char	*name;
+	time_t		modified;
+	size_t		size;
+};
+
+static int R_ImageCacheFileCmp(const void *a, const void *b)
+{
+	const imageCacheFile_t *fa = (const imageCacheFile_t *)a;
+	const imageCacheFile_t *fb = (const imageCacheFile_t *)b;
+
+	if (fa->modified < fb->modified)
+		return -1;
+	return (fa->modified > fb->modified) ? 1 : 0;
+}
+
+static void R_ImageCacheTrim()
+{
+	if (r_imageCacheSize->intVal <= 0)
+		return;
+
+	char path[MAX_OSPATH];
+	Q_snprintfz(path, sizeof(path), "%s/imagecache", FS_Gamedir());
+	TList<String> fileList = Sys_FindFiles(path, "*.img", 0, false, true, false);
+	if (!fileList.Count())
+		return;
+
+	imageCacheFile_t *files = (imageCacheFile_t*)Mem_PoolAlloc(sizeof(imageCacheFile_t) * fileList.Count(), ri.imageSysPool, 0);
+	size_t totalSize = 0;
+	uint32 numFiles = 0;
+	for (uint32 i=0 ; i<fileList.Count() ; i++)
 	{
-		p2[i] = 4 * (frac >> 16);
-		frac += fracstep;
+		struct stat st;
+		if (stat(fileList[i].CString(), &st))
+			continue;
+
+		files[numFiles].name = fileList[i].CString();
+		files[numFiles].modified = st.st_mtime;
+		files[numFiles].size = (size_t)st.st_size;
+		totalSize += files[numFiles].size;
+		numFiles++;
 	}
 
-	for (int i=0 ; i<outHeight ; i++, outData+=outWidth)
+	const size_t maxSize = (size_t)r_imageCacheSize->intVal * 1024 * 1024;
+	if (totalSize > maxSize)
 	{
-		uint32 *inrow = inData + inWidth * (int)((i + 0.25f) * inHeight / outHeight);
-		uint32 *inrow2 = inData + inWidth * (int)((i + 0.75f) * inHeight / outHeight);
-		frac = fracstep >> 1;
+		qsort(files, numFiles, sizeof(imageCacheFile_t), R_ImageCacheFileCmp);
 
-		for (int j=0 ; j<outWidth ; j++)
+		uint32 numRemoved = 0;
+		for (uint32 i=0 ; i<numFiles && totalSize>maxSize ; i++)
 		{
-			byte *pix1 = (byte *)inrow + p1[j];
-			byte *pix2 = (byte *)inrow + p2[j];
-			byte *pix3 = (byte *)inrow2 + p1[j];
-			byte *pix4 = (byte *)inrow2 + p2[j];
+			if (remove(files[i].name))
+				continue;
 
-			((byte *)(outData + j))[0] = (pix1[0] + pix2[0] + pix3[0] + pix4[0]) >> 2;
-			((byte *)(outData + j))[1] = (pix1[1] + pix2[1] + pix3[1] + pix4[1]) >> 2;
-			((byte *)(outData + j))[2] = (pix1[2] + pix2[2] + pix3[2] + pix4[2]) >> 2;
-			((byte *)(outData + j))[3] = (pix1[3] + pix2[3] + pix3[3] + pix4[3]) >> 2;
+			totalSize -= files[i].size;
+			numRemoved++;
 		}
+
+		Com_DevPrintf(0, "Image cache trimmed by %u files\n", numRemoved);
 	}
 
-	ri.reg.imagesResampled++;
+	Mem_Free(files);
 }
 
 /*
@@ -1460,36 +2029,15 @@ static void R_UploadCMImage(const char *name, byte **data, const int width, cons
 		glTexParameterf(GL_TEXTURE_CUBE_MAP_ARB, GL_TEXTURE_WRAP_R, GL_CLAMP);
 	}
 
-	// Allocate a buffer
-	uint32 *scaledData = (uint32*)R_AllocateTexBuffer(TEXBUF_RESAMPLE, scaledWidth*scaledHeight*4);
+	// Allocate a buffer, with room after the base level for mips to ping-pong
+	const int scaledSize = scaledWidth*scaledHeight;
+	uint32 *scaledData = (uint32*)R_AllocateTexBuffer(TEXBUF_RESAMPLE, (scaledSize + (scaledSize+1)/2) * sizeof(uint32));
 
 	// Upload
 	for (int i=0 ; i<6 ; i++)
 	{
-		// Resample
-		R_ResampleImage((uint32 *)(data[i]), width, height, scaledData, scaledWidth, scaledHeight);
-
-		// Scan and replace channels if desired
-		if (flags & (IF_NORGB|IF_NOALPHA))
-		{
-			byte	*scan;
-
-			if (flags & IF_NORGB)
-			{
-				scan = (byte *)scaledData;
-				for (int c=scaledWidth*scaledHeight ; c>0 ; c--, scan+=4)
-					scan[0] = scan[1] = scan[2] = 255;
-			}
-			else
-			{
-				scan = (byte *)scaledData + 3;
-				for (int c=scaledWidth*scaledHeight ; c>0 ; c--, scan+=4)
-					*scan = 255;
-			}
-		}
-
-		// Apply image gamma/intensity
-		R_LightScaleImage(scaledData, scaledWidth, scaledHeight, (!(flags & IF_NOGAMMA)) && !ri.config.bHWGammaInUse, bMipMap && !(flags & IF_NOINTENS));
+		// Resample, replace channels and apply image gamma/intensity
+		R_PrepareImage((uint32 *)(data[i]), width, height, scaledData, scaledWidth, scaledHeight, flags, bMipMap);
 
 		// Upload the base image
 		glTexImage2D(r_cubeTargets[i], 0, internalFormat, scaledWidth, scaledHeight, 0, sourceFormat, uploadType, scaledData);
@@ -1497,12 +2045,18 @@ static void R_UploadCMImage(const char *name, byte **data, const int width, cons
 		// Upload mipmap levels
 		if (bMipMap)
 		{
+			uint32 *mipData = scaledData;
+			uint32 *mipNext = scaledData + scaledSize;
 			int mipLevel = 0;
 			int mipWidth = scaledWidth;
 			int mipHeight = scaledHeight;
 			while (mipWidth > 1 || mipHeight > 1)
 			{
-				R_MipmapImage((byte *)scaledData, mipWidth, mipHeight);
+				R_MipmapImage(mipData, mipWidth, mipHeight, mipNext);
+
+				uint32 *temp = mipData;
+				mipData = mipNext;
+				mipNext = temp;
 
 				mipWidth >>= 1;
 				if (mipWidth < 1)
@@ -1513,11 +2067,11 @@ static void R_UploadCMImage(const char *name, byte **data, const int width, cons
 					mipHeight = 1;
 
 				if (r_colorMipLevels->intVal)
-					R_ColorMipLevel((byte *)scaledData, mipWidth * mipHeight, mipLevel);
+					R_ColorMipLevel((byte *)mipData, mipWidth * mipHeight, mipLevel);
 
 				mipLevel++;
 
-				glTexImage2D(r_cubeTargets[i], mipLevel, internalFormat, mipWidth, mipHeight, 0, sourceFormat, uploadType, scaledData);
+				glTexImage2D(r_cubeTargets[i], mipLevel, internalFormat, mipWidth, mipHeight, 0, sourceFormat, uploadType, mipData);
 			}
 		}
 	}
@@ -1622,7 +2176,14 @@ static void R_Upload2DImage(const char *name, byte *data, const int width, const
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 	}
 
-	if (!data)
+	if (r_imageCacheLoad)
+	{
+		assert(r_imageCacheLoad->upWidth == scaledWidth && r_imageCacheLoad->upHeight == scaledHeight);
+
+		// Prepared on an earlier run
+		R_ImageCacheUpload(r_imageCacheBase, r_imageCacheLoad, internalFormat, sourceFormat, uploadType);
+	}
+	else if (!data)
 	{
 		assert(!bMipMap);
 
@@ -1631,45 +2192,35 @@ static void R_Upload2DImage(const char *name, byte *data, const int width, const
 	}
 	else
 	{
-		// Allocate a buffer
-		uint32 *scaledData = (uint32*)R_AllocateTexBuffer(TEXBUF_RESAMPLE, scaledWidth*scaledHeight*4);
+		// Allocate a buffer, with room after the base level for mips to ping-pong
+		const int scaledSize = scaledWidth*scaledHeight;
+		uint32 *scaledData = (uint32*)R_AllocateTexBuffer(TEXBUF_RESAMPLE, (scaledSize + (scaledSize+1)/2) * sizeof(uint32));
 
-		// Resample
-		R_ResampleImage((uint32 *)data, width, height, scaledData, scaledWidth, scaledHeight);
-
-		// Scan and replace channels if desired
-		if (flags & (IF_NORGB|IF_NOALPHA))
-		{
-			if (flags & IF_NORGB)
-			{
-				byte *scan = (byte *)scaledData;
-				for (int c=scaledWidth*scaledHeight ; c>0 ; c--, scan+=4)
-					scan[0] = scan[1] = scan[2] = 255;
-			}
-			else
-			{
-				byte *scan = (byte *)scaledData + 3;
-				for (int c=scaledWidth*scaledHeight ; c>0 ; c--, scan+=4)
-					*scan = 255;
-			}
-		}
-
-		// Apply image gamma/intensity
-		R_LightScaleImage(scaledData, scaledWidth, scaledHeight, (!(flags & IF_NOGAMMA)) && !ri.config.bHWGammaInUse, bMipMap && !(flags & IF_NOINTENS));
+		// Resample, replace channels and apply image gamma/intensity
+		R_PrepareImage((uint32 *)data, width, height, scaledData, scaledWidth, scaledHeight, flags, bMipMap);
 
 		// Upload the base image
 		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, scaledWidth, scaledHeight, 0, sourceFormat, uploadType, scaledData);
 
+		R_ImageCacheBegin(width, height, samples, scaledWidth, scaledHeight);
+		R_ImageCacheLevel(0, scaledData, scaledWidth, scaledHeight, internalFormat);
+
 		// Upload mipmap levels
 		if (bMipMap)
 		{
+			uint32 *mipData = scaledData;
+			uint32 *mipNext = scaledData + scaledSize;
 			int mipLevel = 0;
 			int mipWidth = scaledWidth;
 			int mipHeight = scaledHeight;
 
 			while (mipWidth > 1 || mipHeight > 1)
 			{
-				R_MipmapImage((byte *)scaledData, mipWidth, mipHeight);
+				R_MipmapImage(mipData, mipWidth, mipHeight, mipNext);
+
+				uint32 *temp = mipData;
+				mipData = mipNext;
+				mipNext = temp;
 
 				mipWidth >>= 1;
 				if (mipWidth < 1)
@@ -1680,13 +2231,16 @@ static void R_Upload2DImage(const char *name, byte *data, const int width, const
 					mipHeight = 1;
 
 				if (r_colorMipLevels->intVal)
-					R_ColorMipLevel((byte *)scaledData, mipWidth * mipHeight, mipLevel);
+					R_ColorMipLevel((byte *)mipData, mipWidth * mipHeight, mipLevel);
 
 				mipLevel++;
 
-				glTexImage2D(GL_TEXTURE_2D, mipLevel, internalFormat, mipWidth, mipHeight, 0, sourceFormat, uploadType, scaledData);
+				glTexImage2D(GL_TEXTURE_2D, mipLevel, internalFormat, mipWidth, mipHeight, 0, sourceFormat, uploadType, mipData);
+				R_ImageCacheLevel(mipLevel, mipData, mipWidth, mipHeight, internalFormat);
 			}
 		}
+
+		R_ImageCacheEnd();
 	}
 }
 
@@ -2122,7 +2676,7 @@ refImage_t *R_CreateImage(const char *name, const char *bareName,
 	switch (image->target)
 	{
 	case GL_TEXTURE_2D:
-		if (bUpload8)
+		if (bUpload8 && !r_imageCacheLoad)
 			R_PalToRGBA(name, *pic, image, bIsPCX);
 		else
 			R_Upload2DImage(name, pic ? *pic : NULL, image->width, image->height, image->flags, samples, &image->upWidth, &image->upHeight, &image->upFormat);
@@ -2304,50 +2858,75 @@ static refImage_t *R_RegisterCubeMap(const char *name, texFlags_t flags)
 
 /*
 ===============
-R_RegisterImage
+R_LoadCachedImage
 
-Finds or loads the given image
+Uploads the processed image straight from the cache if it is there. Fills in
+cacheName when the image can be cached, so the caller can store it on a miss.
 ===============
 */
-refImage_t *R_RegisterImage(const char *name, texFlags_t flags)
+static refImage_t *R_LoadCachedImage(const char *name, const char *bareName, const texFlags_t flags, char *cacheName, const size_t cacheNameSize)
 {
-	// Check the name
-	if (!name)
-		return NULL;
+	// Find the source R_LoadImage would pick, in the same order
+	static const char *sourceExts[] = { "png", "tga", "jpg", NULL };
+	const bool bWal = !strcmp(name + strlen(bareName), ".wal");
 
-	// Check the length
-	const size_t nameLen = strlen(name);
-	if (nameLen < 2)
+	char loadName[MAX_QPATH];
+	bool bUpload8 = false;
+	int i;
+	for (i=0 ; sourceExts[i] ; i++)
 	{
-		Com_Printf(PRNT_ERROR, "R_RegisterImage: Image name too short! %s\n", name);
-		return NULL;
+		Q_snprintfz(loadName, sizeof(loadName), "%s.%s", bareName, sourceExts[i]);
+		if (FS_FileExists(loadName) != -1)
+			break;
 	}
-	if (nameLen+1 >= MAX_QPATH)
+	if (!sourceExts[i])
 	{
-		Com_Printf(PRNT_ERROR, "R_RegisterImage: Image name too long! %s\n, name");
-		return NULL;
+		Q_snprintfz(loadName, sizeof(loadName), "%s.%s", bareName, bWal ? "wal" : "pcx");
+		if (FS_FileExists(loadName) == -1)
+			return NULL;
+		bUpload8 = true;
 	}
 
-	// Cubemap stuff
-	if (flags & IT_CUBEMAP)
-	{
-		if (ri.config.ext.bTexCubeMap)
-			return R_RegisterCubeMap(name, flags);
-		flags &= ~IT_CUBEMAP;
-	}
+	if (!R_ImageCacheName(loadName, flags, cacheName, cacheNameSize))
+		return NULL;
 
-	// Generate the bare name
-	const char *bareName = R_BareImageName(name);
+	size_t fileSize;
+	void *base = Sys_MapFile(cacheName, &fileSize);
+	if (!base)
+		return NULL;
 
-	// See if it's already loaded
-	refImage_t *image = R_FindImage(bareName, flags);
-	if (image)
+	refImage_t *image = NULL;
+	imageCacheHeader_t header;
+	if (fileSize >= sizeof(header))
 	{
-		R_TouchImage(image);
-		return image;
+		memcpy(&header, base, sizeof(header));
+		R_ImageCacheSwapHeader(&header);
 	}
+	if (fileSize >= sizeof(header) && R_ImageCacheValid(loadName, &header, fileSize, flags))
+	{
+		r_imageCacheLoad = &header;
+		r_imageCacheBase = (const byte *)base;
+		image = R_CreateImage(loadName, bareName, NULL, header.width, header.height, 1, flags, header.samples, bUpload8, bUpload8 && !bWal);
+		r_imageCacheLoad = NULL;
+		r_imageCacheBase = NULL;
 
-	// Not found -- load the pic from disk
+		ri.reg.imagesCached++;
+	}
+
+	Sys_UnmapFile(base, fileSize);
+	return image;
+}
+
+
+/*
+===============
+R_LoadImage
+
+Decodes the first source image found for bareName
+===============
+*/
+static refImage_t *R_LoadImage(const char *name, const char *bareName, const texFlags_t flags)
+{
 	char loadName[MAX_QPATH];
 	Q_snprintfz(loadName, sizeof(loadName), "%s.png", bareName);
 	const size_t len = strlen(loadName);
@@ -2376,10 +2955,7 @@ refImage_t *R_RegisterImage(const char *name, texFlags_t flags)
 					loadName[len-3] = 'w'; loadName[len-2] = 'a'; loadName[len-1] = 'l';
 					R_LoadWal(loadName, &pic, &width, &height);
 					if (pic)
-					{
-						image = R_CreateImage(loadName, bareName, &pic, width, height, 1, flags, samples, true);
-						return image;
-					}
+						return R_CreateImage(loadName, bareName, &pic, width, height, 1, flags, samples, true);
 					return NULL;
 				}
 
@@ -2387,10 +2963,7 @@ refImage_t *R_RegisterImage(const char *name, texFlags_t flags)
 				loadName[len-3] = 'p'; loadName[len-2] = 'c'; loadName[len-1] = 'x';
 				R_LoadPCX(loadName, &pic, NULL, &width, &height);
 				if (pic)
-				{
-					image = R_CreateImage(loadName, bareName, &pic, width, height, 1, flags, samples, true, true);
-					return image;
-				}
+					return R_CreateImage(loadName, bareName, &pic, width, height, 1, flags, samples, true, true);
 				return NULL;
 			}
 		}
@@ -2401,6 +2974,67 @@ refImage_t *R_RegisterImage(const char *name, texFlags_t flags)
 }
 
 
+/*
+===============
+R_RegisterImage
+
+Finds or loads the given image
+===============
+*/
+refImage_t *R_RegisterImage(const char *name, texFlags_t flags)
+{
+	// Check the name
+	if (!name)
+		return NULL;
+
+	// Check the length
+	const size_t nameLen = strlen(name);
+	if (nameLen < 2)
+	{
+		Com_Printf(PRNT_ERROR, "R_RegisterImage: Image name too short! %s\n", name);
+		return NULL;
+	}
+	if (nameLen+1 >= MAX_QPATH)
+	{
+		Com_Printf(PRNT_ERROR, "R_RegisterImage: Image name too long! %s\n, name");
+		return NULL;
+	}
+
+	// Cubemap stuff
+	if (flags & IT_CUBEMAP)
+	{
+		if (ri.config.ext.bTexCubeMap)
+			return R_RegisterCubeMap(name, flags);
+		flags &= ~IT_CUBEMAP;
+	}
+
+	// Generate the bare name
+	const char *bareName = R_BareImageName(name);
+
+	// See if it's already loaded
+	refImage_t *image = R_FindImage(bareName, flags);
+	if (image)
+	{
+		R_TouchImage(image);
+		return image;
+	}
+
+	// Not found -- see if it was processed before
+	char cacheName[MAX_OSPATH];
+	cacheName[0] = '\0';
+	image = R_LoadCachedImage(name, bareName, flags, cacheName, sizeof(cacheName));
+	if (image)
+		return image;
+
+	// Load the pic from disk, storing the result if it can be cached
+	r_imageCacheStore = cacheName[0] ? cacheName : NULL;
+	image = R_LoadImage(name, bareName, flags);
+	r_imageCacheStore = NULL;
+
+	return image;
+}
+
+
 /*
 ================
 R_FreeImage
@@ -2469,7 +3103,7 @@ void R_EndImageRegistration()
 		it = R_FreeImage(it, image);
 	}
 
-	Com_DevPrintf(PRNT_CONSOLE, "Completing image system registration:\n-Released: %i\n-Resampled: %i\n-Touched: %i\n-Seaked: %i\n", ri.reg.imagesReleased, ri.reg.imagesResampled, ri.reg.imagesSeaked, ri.reg.imagesTouched);
+	Com_DevPrintf(PRNT_CONSOLE, "Completing image system registration:\n-Released: %i\n-Resampled: %i\n-Cached: %i\n-Touched: %i\n-Seaked: %i\n", ri.reg.imagesReleased, ri.reg.imagesResampled, ri.reg.imagesCached, ri.reg.imagesSeaked, ri.reg.imagesTouched);
 }
 
 
@@ -3107,6 +3741,13 @@ void R_ImageInit()
 	uint32 startCycles = Sys_Cycles();
 	Com_Printf(0, "\n--------- Image Initialization ---------\n");
 
+	// Start the image processing workers
+	if (r_imageThreads->intVal < 0)
+		Cvar_VariableSetValue(r_imageThreads, 0, true);
+	else if (r_imageThreads->intVal > MAX_JOB_THREADS-1)
+		Cvar_VariableSetValue(r_imageThreads, MAX_JOB_THREADS-1, true);
+	r_imageJobs.Init(r_imageThreads->intVal);
+
 	// Registration
 	cmd_imageList	= Cmd_AddCommand("imagelist",	0, R_ImageList_f,			"Prints out a list of the currently loaded textures");
 	cmd_screenShot	= Cmd_AddCommand("screenshot",	0, R_ScreenShot_f,			"Takes a screenshot");
@@ -3181,6 +3822,12 @@ void R_ImageInit()
 		r_intensityTable[i] = j;
 	}
 
+	// Cached images are only valid for the tables they were processed with
+	r_imageCacheTables = Com_BlockChecksum(r_gammaTable, sizeof(r_gammaTable))
+		^ Com_BlockChecksum(r_intensityTable, sizeof(r_intensityTable))
+		^ Com_BlockChecksum(r_paletteTable, sizeof(r_paletteTable));
+	R_ImageCacheTrim();
+
 	// Get gamma ramp
 	Com_DevPrintf(0, "Downloading desktop gamma ramp\n");
 	ri.bRampDownloaded = GLimp_GetGammaRamp(ri.originalRamp);
@@ -3273,6 +3920,9 @@ void R_ImageShutdown()
 	// Free memory
 	R_ReleaseTexBuffers();
 
+	// Stop the image processing workers
+	r_imageJobs.Shutdown();
+
 	uint32 size = Mem_FreePool(ri.imageSysPool);
 	Com_Printf (0, "...releasing %u bytes...\n", size);
 }
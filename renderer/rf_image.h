@@ -132,5 +132,7 @@ void R_EndImageRegistration();
 void R_ResetGammaRamp();
 void R_UpdateGammaRamp();
 
+extern JobPool r_imageJobs;	// Also builds dynamic lightmaps
+
 void R_ImageInit();
 void R_ImageShutdown();
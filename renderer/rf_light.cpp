@@ -474,10 +474,40 @@ static void R_Q2BSP_SetLightLevel()
 
 	QUAKE II LIGHTMAP
 
+	Lightmaps that change during a frame are rebuilt by R_Q2BSP_UpdateLightmaps
+	before a mesh list is drawn. Each surface remembers the texels its dynamic
+	lights wrote last time, so unless a light style changed only those and the
+	ones under this frame's lights are rebuilt. The builds are sorted by page,
+	and each page's blocks are built on r_imageJobs into r_q2_lmBuffer, then
+	uploaded. Blocks on one page never overlap, so a page's worth always fits,
+	and the buffer made for building the pages at load is kept for this.
+
 =============================================================================
 */
 
-static byte		*r_q2_lmBuffer;
+#define Q2LM_MAX_TEXELS	(34*34)
+
+struct q2LMLight_t
+{
+	vec3_t			color;
+	float			rad;			// Highest intensity on the plane
+	float			s, t;			// Impact point in lightmap units
+	int				rect[4];		// Texels it can reach, mins inclusive, maxs exclusive
+};
+
+struct q2LMBuild_t
+{
+	mBspSurface_t	*surf;
+	int				rect[4];
+	int				firstLight;
+	int				numLights;
+	uint32			offset;			// Into the scratch buffer
+};
+
+static TList<q2LMBuild_t>	r_q2_lmBuilds;
+static TList<q2LMLight_t>	r_q2_lmLights;
+
+static byte		*r_q2_lmBuffer;			// One page, kept after load as the update scratch
 static bool		r_q2_lmBufferDirty;
 static int		r_q2_lmNumUploaded;
 static int		*r_q2_lmAllocated;
@@ -485,11 +515,71 @@ int				r_q2_lmBlockSize;
 
 /*
 ===============
-R_Q2BSP_AddDynamicLights
+R_Q2BSP_EmptyLMRect
 ===============
 */
-static void R_Q2BSP_AddDynamicLights(refEntity_t *ent, mBspSurface_t *surf, float *blockLights)
+static inline bool R_Q2BSP_EmptyLMRect(const int *rect)
 {
+	return (rect[0] >= rect[2] || rect[1] >= rect[3]);
+}
+
+
+/*
+===============
+R_Q2BSP_AddLMRect
+===============
+*/
+static void R_Q2BSP_AddLMRect(int *rect, const int *add)
+{
+	if (R_Q2BSP_EmptyLMRect(add))
+		return;
+
+	if (R_Q2BSP_EmptyLMRect(rect))
+	{
+		rect[0] = add[0];
+		rect[1] = add[1];
+		rect[2] = add[2];
+		rect[3] = add[3];
+		return;
+	}
+
+	rect[0] = Min(rect[0], add[0]);
+	rect[1] = Min(rect[1], add[1]);
+	rect[2] = Max(rect[2], add[2]);
+	rect[3] = Max(rect[3], add[3]);
+}
+
+
+/*
+===============
+R_Q2BSP_LightRect
+
+The falloff is never shorter than the s or t distance alone, so a light can
+only reach the texels within its radius on both axes.
+===============
+*/
+static void R_Q2BSP_LightRect(const mBspSurface_t *surf, q2LMLight_t *light)
+{
+	light->rect[0] = Max<int>(0, (int)floorf((light->s - light->rad) / 16.0f));
+	light->rect[1] = Max<int>(0, (int)floorf((light->t - light->rad) / 16.0f));
+	light->rect[2] = Min<int>(surf->q2_lmWidth, (int)ceilf((light->s + light->rad) / 16.0f) + 1);
+	light->rect[3] = Min<int>(surf->q2_lmHeight, (int)ceilf((light->t + light->rad) / 16.0f) + 1);
+}
+
+
+/*
+===============
+R_Q2BSP_SurfaceDLights
+
+Moves each light touching the surface into lightmap space, and returns the
+union of the texels they can reach in rect.
+===============
+*/
+static int R_Q2BSP_SurfaceDLights(refEntity_t *ent, mBspSurface_t *surf, q2LMLight_t *lights, int *rect)
+{
+	const bool bRotated = !Matrix3_Compare(ent->axis, axisIdentity);
+	int numLights = 0;
+
 	for (uint32 num=0 ; num<ri.scn.numDLights ; num++)
 	{
 		if (ri.scn.dLightCullBits & BIT(num))
@@ -500,7 +590,7 @@ static void R_Q2BSP_AddDynamicLights(refEntity_t *ent, mBspSurface_t *surf, floa
 			continue;	// Not lit by this light
 
 		vec3_t origin;
-		if (!Matrix3_Compare(ent->axis, axisIdentity))
+		if (bRotated)
 		{
 			vec3_t tmp;
 			Vec3Subtract(lt->origin, ent->origin, tmp);
@@ -511,7 +601,7 @@ static void R_Q2BSP_AddDynamicLights(refEntity_t *ent, mBspSurface_t *surf, floa
 			Vec3Subtract(lt->origin, ent->origin, origin);
 		}
 
-		float fDist = PlaneDiff(origin, surf->q2_plane);
+		const float fDist = PlaneDiff(origin, surf->q2_plane);
 		const float fRad = lt->intensity - fabsf(fDist); // fRad is now the highest intensity on the plane
 		if (fRad < 0)
 			continue;
@@ -521,25 +611,53 @@ static void R_Q2BSP_AddDynamicLights(refEntity_t *ent, mBspSurface_t *surf, floa
 		impact[1] = origin[1] - (surf->q2_plane->normal[1] * fDist);
 		impact[2] = origin[2] - (surf->q2_plane->normal[2] * fDist);
 
-		float sl = DotProduct(impact, surf->q2_texInfo->vecs[0]) + surf->q2_texInfo->vecs[0][3] - surf->q2_textureMins[0];
-		float st = DotProduct(impact, surf->q2_texInfo->vecs[1]) + surf->q2_texInfo->vecs[1][3] - surf->q2_textureMins[1];
+		q2LMLight_t *light = &lights[numLights];
+		Vec3Copy(lt->color, light->color);
+		light->rad = fRad;
+		light->s = DotProduct(impact, surf->q2_texInfo->vecs[0]) + surf->q2_texInfo->vecs[0][3] - surf->q2_textureMins[0];
+		light->t = DotProduct(impact, surf->q2_texInfo->vecs[1]) + surf->q2_texInfo->vecs[1][3] - surf->q2_textureMins[1];
+
+		R_Q2BSP_LightRect(surf, light);
+		if (R_Q2BSP_EmptyLMRect(light->rect))
+			continue;
+
+		R_Q2BSP_AddLMRect(rect, light->rect);
+		numLights++;
+	}
+
+	return numLights;
+}
+
+
+/*
+===============
+R_Q2BSP_AddDynamicLights
+===============
+*/
+static void R_Q2BSP_AddDynamicLights(const q2LMLight_t *lights, const int numLights, const int *rect, float *blockLights)
+{
+	const int width = rect[2] - rect[0];
 
-		float *bl = blockLights;
-		float ftacc = 0.0f;
-		for (int t=0 ; t<surf->q2_lmHeight ; t++)
+	for (int num=0 ; num<numLights ; num++)
+	{
+		const q2LMLight_t *lt = &lights[num];
+		const float fRad = lt->rad;
+
+		const int s0 = Max(lt->rect[0], rect[0]);
+		const int t0 = Max(lt->rect[1], rect[1]);
+		const int s1 = Min(lt->rect[2], rect[2]);
+		const int t1 = Min(lt->rect[3], rect[3]);
+
+		for (int t=t0 ; t<t1 ; t++)
 		{
-			float td = st - ftacc;
-			if (td < 0)
-				td = -td;
+			const float td = fabsf(lt->t - (float)(t*16));
 
-			float fsacc = 0.0f;
-			for (int s=0 ; s<surf->q2_lmWidth ; s++)
+			float *bl = blockLights + ((t - rect[1]) * width + (s0 - rect[0])) * 3;
+			for (int s=s0 ; s<s1 ; s++, bl+=3)
 			{
-				float sd = sl - fsacc;
-				if (sd < 0)
-					sd = -sd;
+				const float sd = fabsf(lt->s - (float)(s*16));
 
-				float fDist2;
+				float fDist, fDist2;
 				if (sd > td)
 				{
 					fDist = sd + (td * 0.5f);
@@ -568,13 +686,55 @@ static void R_Q2BSP_AddDynamicLights(refEntity_t *ent, mBspSurface_t *surf, floa
 						bl[2] += lt->color[2] * scale * 0.5f;
 					}
 				}
-
-				fsacc += 16;
-				bl += 3;
 			}
+		}
+	}
+}
 
-			ftacc += 16;
+
+/*
+===============
+R_Q2BSP_AddLightStyle
+
+Scales one row of a style's samples into blockLights. Four rgb texels are
+three vectors, with the scale rotated to line up with each of them.
+===============
+*/
+static void R_Q2BSP_AddLightStyle(float *bl, const byte *lightMap, const int numFloats, const vec3_t scale, const bool bFirst)
+{
+	const float pattern[12] = {
+		scale[0], scale[1], scale[2], scale[0],
+		scale[1], scale[2], scale[0], scale[1],
+		scale[2], scale[0], scale[1], scale[2]
+	};
+	const simdVec_t scale0 = Simd_Load(&pattern[0]);
+	const simdVec_t scale1 = Simd_Load(&pattern[4]);
+	const simdVec_t scale2 = Simd_Load(&pattern[8]);
+
+	int i = 0;
+	if (bFirst)
+	{
+		for ( ; i+12<=numFloats ; i+=12)
+		{
+			Simd_Store(&bl[i+0], Simd_Mul(Simd_LoadBytes(&lightMap[i+0]), scale0));
+			Simd_Store(&bl[i+4], Simd_Mul(Simd_LoadBytes(&lightMap[i+4]), scale1));
+			Simd_Store(&bl[i+8], Simd_Mul(Simd_LoadBytes(&lightMap[i+8]), scale2));
 		}
+
+		for ( ; i<numFloats ; i++)
+			bl[i] = lightMap[i] * pattern[i%3];
+	}
+	else
+	{
+		for ( ; i+12<=numFloats ; i+=12)
+		{
+			Simd_Store(&bl[i+0], Simd_Madd(Simd_LoadBytes(&lightMap[i+0]), scale0, Simd_Load(&bl[i+0])));
+			Simd_Store(&bl[i+4], Simd_Madd(Simd_LoadBytes(&lightMap[i+4]), scale1, Simd_Load(&bl[i+4])));
+			Simd_Store(&bl[i+8], Simd_Madd(Simd_LoadBytes(&lightMap[i+8]), scale2, Simd_Load(&bl[i+8])));
+		}
+
+		for ( ; i<numFloats ; i++)
+			bl[i] += lightMap[i] * pattern[i%3];
 	}
 }
 
@@ -583,88 +743,70 @@ static void R_Q2BSP_AddDynamicLights(refEntity_t *ent, mBspSurface_t *surf, floa
 ===============
 R_Q2BSP_BuildLightMap
 
-Combine and scale multiple lightmaps into the floating format in blocklights
+Combine and scale multiple lightmaps into the floating format in blocklights,
+for the texels inside rect only. dest points at the first texel of the rect.
+Safe to run on the job threads, it only reads shared state.
 ===============
 */
-static void R_Q2BSP_BuildLightMap(refEntity_t *ent, mBspSurface_t *surf, byte *dest, int stride)
+static void R_Q2BSP_BuildLightMap(const mBspSurface_t *surf, const q2LMLight_t *lights, const int numLights, const int *rect, byte *dest, const int stride)
 {
-	if (surf->q2_texInfo->flags & (SURF_TEXINFO_SKY|SURF_TEXINFO_WARP))
-		Com_Error(ERR_DROP, "LM_BuildLightMap called for non-lit surface");
-
-	float blockLights[34*34*3];
-	const int size = surf->q2_lmWidth*surf->q2_lmHeight;
-	if (size > sizeof(blockLights) >> 4)
-		Com_Error(ERR_DROP, "Bad blockLights size");
+	float blockLights[Q2LM_MAX_TEXELS*3];
+	const int width = rect[2] - rect[0];
+	const int height = rect[3] - rect[1];
+	const int numFloats = width*height*3;
 
 	// Set to full bright if no light data
 	if (!surf->q2_lmSamples || r_fullbright->intVal)
 	{
-		for (int i=0 ; i<size*3 ; i++)
+		for (int i=0 ; i<numFloats ; i++)
 			blockLights[i] = 255.0f;
 	}
 	else
 	{
-		byte *lightMap = surf->q2_lmSamples;
+		const int size = surf->q2_lmWidth*surf->q2_lmHeight;
+		const byte *lightMap = surf->q2_lmSamples + (rect[1] * surf->q2_lmWidth + rect[0]) * 3;
 
 		// Add all the lightmaps
-		float *bl = blockLights;
-		vec3_t scale;
-		Vec3Scale(ri.scn.lightStyles[surf->q2_styles[0]].rgb, gl_modulate->floatVal, scale);
-		for (int i=0 ; i<size ; i++, bl+=3)
-		{
-			bl[0] = lightMap[i*3+0] * scale[0];
-			bl[1] = lightMap[i*3+1] * scale[1];
-			bl[2] = lightMap[i*3+2] * scale[2];
-		}
-
-		// Skip to next lightmap
-		lightMap += size*3;
-
-		if (surf->q2_numStyles > 1)
+		const int numStyles = Max(surf->q2_numStyles, 1);
+		for (int map=0 ; map<numStyles ; map++, lightMap+=size*3)
 		{
-			for (int map=1 ; map<surf->q2_numStyles ; map++)
-			{
-				bl = blockLights;
+			vec3_t scale;
+			Vec3Scale(ri.scn.lightStyles[surf->q2_styles[map]].rgb, gl_modulate->floatVal, scale);
 
-				Vec3Scale(ri.scn.lightStyles[surf->q2_styles[map]].rgb, gl_modulate->floatVal, scale);
-				for (int i=0 ; i<size ; i++, bl+=3)
-				{
-					bl[0] += lightMap[i*3+0] * scale[0];
-					bl[1] += lightMap[i*3+1] * scale[1];
-					bl[2] += lightMap[i*3+2] * scale[2];
-				}
-
-				// Skip to next lightmap
-				lightMap += size*3;
-			}
+			float *bl = blockLights;
+			const byte *lm = lightMap;
+			for (int t=0 ; t<height ; t++, bl+=width*3, lm+=surf->q2_lmWidth*3)
+				R_Q2BSP_AddLightStyle(bl, lm, width*3, scale, (map == 0));
 		}
 
 		// Add all the dynamic lights
-		if (surf->dLightFrame == ri.frameCount)
-			R_Q2BSP_AddDynamicLights(ent, surf, blockLights);
+		R_Q2BSP_AddDynamicLights(lights, numLights, rect, blockLights);
+	}
+
+	// Catch negative lights
+	int i = 0;
+	const simdVec_t zero = Simd_Zero();
+	for ( ; i+4<=numFloats ; i+=4)
+		Simd_Store(&blockLights[i], Simd_Max(Simd_Load(&blockLights[i]), zero));
+	for ( ; i<numFloats ; i++)
+	{
+		if (blockLights[i] < 0)
+			blockLights[i] = 0;
 	}
 
 	// Put into texture format
-	stride -= (surf->q2_lmWidth << 2);
-	float *bl = blockLights;
+	const int rowSkip = stride - (width << 2);
+	const float *bl = blockLights;
 
-	for (int i=0 ; i<surf->q2_lmHeight ; i++)
+	for (int t=0 ; t<height ; t++)
 	{
-		for (int j=0 ; j<surf->q2_lmWidth ; j++)
+		for (int s=0 ; s<width ; s++)
 		{
 			// Temp storage
 			float r = bl[0];
 			float g = bl[1];
 			float b = bl[2];
 
-			// Catch negative lights
-			if (r < 0)
-				r = 0;
-			if (g < 0)
-				g = 0;
-			if (b < 0)
-				b = 0;
-
 			// Determine the brightest of the three color components
 			// Normalize the color components to the highest channel
 			float max = Max(r, Max(g, b));
@@ -695,7 +837,7 @@ static void R_Q2BSP_BuildLightMap(refEntity_t *ent, mBspSurface_t *surf, byte *d
 			dest += 4;
 		}
 
-		dest += stride;
+		dest += rowSkip;
 	}
 }
 
@@ -714,10 +856,13 @@ static void R_Q2BSP_SetLMCacheState (mBspSurface_t *surf)
 
 /*
 =======================
-R_Q2BSP_UpdateLightmap
+R_Q2BSP_QueueLightmap
+
+Works out which texels of the surface changed since the last update, and
+queues a build for them.
 =======================
 */
-void R_Q2BSP_UpdateLightmap(refEntity_t *ent, mBspSurface_t *surf)
+static void R_Q2BSP_QueueLightmap(refEntity_t *ent, mBspSurface_t *surf)
 {
 	// Don't update twice a frame
 	if (surf->q2_dLightUpdateFrame == ri.frameCount)
@@ -729,62 +874,281 @@ void R_Q2BSP_UpdateLightmap(refEntity_t *ent, mBspSurface_t *surf)
 		return;
 	if (surf->lmTexNum == BAD_LMTEXNUM)
 		return;
+	if (surf->q2_lmWidth*surf->q2_lmHeight > Q2LM_MAX_TEXELS)
+		Com_Error(ERR_DROP, "Bad blockLights size");
 
-	bool bDynamic = false;
+	int rect[4] = { 0, 0, 0, 0 };
+	int lightRect[4] = { 0, 0, 0, 0 };
+	q2LMLight_t lights[MAX_REF_DLIGHTS];
+	int numLights = 0;
 	bool bUpdateCache = false;
 
-	// Dynamic this frame or dynamic previously
 	if (gl_dynamic->intVal)
 	{
+		// A light style change rebuilds the whole surface
+		for (int map=0 ; map<surf->q2_numStyles ; map++)
+		{
+			if (ri.scn.lightStyles[surf->q2_styles[map]].white != surf->q2_cachedLight[map])
+			{
+				bUpdateCache = (surf->q2_styles[map] >= 32 || surf->q2_styles[map] == 0);
+				rect[2] = surf->q2_lmWidth;
+				rect[3] = surf->q2_lmHeight;
+				break;
+			}
+		}
+
+		// Dynamic this frame
 		if (surf->dLightFrame == ri.frameCount)
+			numLights = R_Q2BSP_SurfaceDLights(ent, surf, lights, lightRect);
+	}
+
+	// Also rebuild what the lights wrote last time, so that we can "clean off" old dynamic lights
+	const int lastRect[4] = { surf->q2_dLightRect[0], surf->q2_dLightRect[1], surf->q2_dLightRect[2], surf->q2_dLightRect[3] };
+	R_Q2BSP_AddLMRect(rect, lastRect);
+	R_Q2BSP_AddLMRect(rect, lightRect);
+	for (int i=0 ; i<4 ; i++)
+		surf->q2_dLightRect[i] = lightRect[i];
+
+	if (R_Q2BSP_EmptyLMRect(rect))
+		return;
+
+	if (bUpdateCache)
+		R_Q2BSP_SetLMCacheState(surf);
+
+	q2LMBuild_t build;
+	build.surf = surf;
+	for (int i=0 ; i<4 ; i++)
+		build.rect[i] = rect[i];
+	build.firstLight = r_q2_lmLights.Count();
+	build.numLights = numLights;
+	build.offset = 0;
+
+	r_q2_lmLights.AddRange(lights, numLights);
+	r_q2_lmBuilds.Add(build);
+}
+
+
+struct q2LMJob_t
+{
+	q2LMBuild_t			*builds;
+	const q2LMLight_t	*lights;
+	byte				*scratch;
+};
+
+static void R_Q2BSP_LightmapJob(void *arg, const int taskNum, const int threadNum)
+{
+	const q2LMJob_t *job = (const q2LMJob_t*)arg;
+	const q2LMBuild_t *build = &job->builds[taskNum];
+
+	R_Q2BSP_BuildLightMap(build->surf, job->lights + build->firstLight, build->numLights, build->rect,
+		job->scratch + build->offset, (build->rect[2] - build->rect[0]) * 4);
+}
+
+
+static int R_Q2BSP_LMBuildCmp(const void *a, const void *b)
+{
+	return ((const q2LMBuild_t*)a)->surf->lmTexNum - ((const q2LMBuild_t*)b)->surf->lmTexNum;
+}
+
+
+/*
+=======================
+R_Q2BSP_UpdateLightmaps
+
+Called once per mesh list, before anything in it is drawn.
+=======================
+*/
+void R_Q2BSP_UpdateLightmaps(refMeshList *list)
+{
+	r_q2_lmBuilds.Clear();
+	r_q2_lmLights.Clear();
+
+	TList<refMeshBuffer> *meshBuffers[3] = { &list->meshBufferOpaque, &list->meshBufferAdditive, &list->meshBufferPostProcess };
+	for (int i=0 ; i<3 ; i++)
+	{
+		for (uint32 j=0 ; j<meshBuffers[i]->Count() ; j++)
 		{
-			surf->q2_bDLightDirty = true;
-			bDynamic = true;
+			refMeshBuffer *mb = &(*meshBuffers[i])[j];
+			if (mb->DecodeMeshType() == MBT_Q2BSP)
+				R_Q2BSP_QueueLightmap(mb->DecodeEntity(), (mBspSurface_t *)mb->mesh);
 		}
-		else
+	}
+
+	const uint32 numBuilds = r_q2_lmBuilds.Count();
+	if (!numBuilds)
+		return;
+
+	qsort(&r_q2_lmBuilds[0], numBuilds, sizeof(q2LMBuild_t), R_Q2BSP_LMBuildCmp);
+
+	q2LMJob_t job;
+	job.lights = r_q2_lmLights.Count() ? &r_q2_lmLights[0] : NULL;
+	job.scratch = r_q2_lmBuffer;
+
+	for (uint32 first=0, last ; first<numBuilds ; first=last)
+	{
+		const int page = r_q2_lmBuilds[first].surf->lmTexNum;
+
+		// Lay this page's blocks out in the scratch buffer
+		uint32 scratchSize = 0;
+		for (last=first ; last<numBuilds && r_q2_lmBuilds[last].surf->lmTexNum == page ; last++)
 		{
-			for (int map=0 ; map<surf->q2_numStyles ; map++)
-			{
-				if (ri.scn.lightStyles[surf->q2_styles[map]].white != surf->q2_cachedLight[map])
-				{
-					bUpdateCache = (surf->q2_styles[map] >= 32 || surf->q2_styles[map] == 0);
-					surf->q2_bDLightDirty = true;
-					bDynamic = true;
-					break;
-				}
-			}
+			q2LMBuild_t *build = &r_q2_lmBuilds[last];
+			build->offset = scratchSize;
+			scratchSize += (build->rect[2] - build->rect[0]) * (build->rect[3] - build->rect[1]) * 4;
 		}
+		assert(scratchSize <= (uint32)(r_q2_lmBlockSize*r_q2_lmBlockSize*4));
+
+		job.builds = &r_q2_lmBuilds[first];
+		r_imageJobs.Run(R_Q2BSP_LightmapJob, &job, last - first);
+
+		RB_BindTexture(ri.media.lmTextures[page]);
+		for (uint32 i=first ; i<last ; i++)
+		{
+			const q2LMBuild_t *build = &r_q2_lmBuilds[i];
+			glTexSubImage2D(GL_TEXTURE_2D, 0,
+							build->surf->q2_lmCoords[0] + build->rect[0], build->surf->q2_lmCoords[1] + build->rect[1],
+							build->rect[2] - build->rect[0], build->rect[3] - build->rect[1],
+							GL_RGBA,
+							GL_UNSIGNED_BYTE,
+							job.scratch + build->offset);
+		}
+	}
+
+	RB_CheckForError("R_Q2BSP_UpdateLightmaps");
+}
+
+
+/*
+=======================
+R_LightmapBench_f
+
+Replays a fixed sequence of dynamic lights over the lit surfaces of the
+current map and times building the affected lightmaps, as whole surfaces,
+as dirty rects, and as dirty rects on r_imageJobs. Nothing is uploaded, so
+the GL state is left alone.
+=======================
+*/
+void R_LightmapBench_f()
+{
+	if (!ri.scn.worldModel || ri.scn.worldModel->type != MODEL_Q2BSP)
+	{
+		Com_Printf(0, "r_lightmapbench: needs a Quake II map loaded\n");
+		return;
 	}
 
-	// If it's dirty, give it another update so that we can "clean off" old dynamic lights
-	if (!bDynamic && surf->q2_bDLightDirty)
+	const int numFrames = (Cmd_Argc() > 1) ? atoi(Cmd_Argv(1)) : 500;
+	const int numLights = (Cmd_Argc() > 2) ? clamp(atoi(Cmd_Argv(2)), 1, MAX_REF_DLIGHTS) : 16;
+	if (numFrames <= 0)
 	{
-		surf->q2_bDLightDirty = false;
-		bDynamic = true;
+		Com_Printf(0, "Usage: r_lightmapbench [frames] [lights]\n");
+		return;
 	}
 
-	if (bDynamic)
+	mBspModelBase_t *bspModel = ri.scn.worldModel->BSPData();
+	TList<mBspSurface_t*> surfs;
+	for (int i=0 ; i<bspModel->numSurfaces ; i++)
+	{
+		mBspSurface_t *surf = &bspModel->surfaces[i];
+		if (surf->q2_texInfo->flags & (SURF_TEXINFO_SKY|SURF_TEXINFO_WARP))
+			continue;
+		if (surf->lmTexNum == BAD_LMTEXNUM || surf->q2_lmWidth*surf->q2_lmHeight > Q2LM_MAX_TEXELS)
+			continue;
+		surfs.Add(surf);
+	}
+	if (!surfs.Count())
 	{
-		static uint32 scratch[Q2LMBLOCKSIZE*Q2LMBLOCKSIZE];
+		Com_Printf(0, "r_lightmapbench: no lit surfaces\n");
+		return;
+	}
+
+	// Record the replay, one light on each of numLights surfaces per frame
+	r_q2_lmBuilds.Clear();
+	r_q2_lmLights.Clear();
 
-		// Update texture
-		R_Q2BSP_BuildLightMap(ent, surf, (byte *)scratch, surf->q2_lmWidth*4);
-		if (bUpdateCache)
+	uint32 seed = 1;
+	for (int frame=0 ; frame<numFrames ; frame++)
+	{
+		for (int i=0 ; i<numLights ; i++)
 		{
-			R_Q2BSP_SetLMCacheState(surf);
+			seed = seed * 1664525 + 1013904223;
+			mBspSurface_t *surf = surfs[(seed >> 8) % surfs.Count()];
+
+			q2LMLight_t light;
+			Vec3Set(light.color, 1.0f, 0.75f, 0.5f);
+			seed = seed * 1664525 + 1013904223;
+			light.s = (float)((seed >> 8) % (surf->q2_lmWidth * 16));
+			seed = seed * 1664525 + 1013904223;
+			light.t = (float)((seed >> 8) % (surf->q2_lmHeight * 16));
+			seed = seed * 1664525 + 1013904223;
+			light.rad = (float)(64 + (seed >> 8) % 192);
+			R_Q2BSP_LightRect(surf, &light);
+
+			q2LMBuild_t build;
+			build.surf = surf;
+			build.firstLight = r_q2_lmLights.Count();
+			build.numLights = 1;
+			build.offset = 0;
+			r_q2_lmBuilds.Add(build);
+			r_q2_lmLights.Add(light);
 		}
+	}
+
+	q2LMJob_t job;
+	job.lights = &r_q2_lmLights[0];
+	job.scratch = (byte*)Mem_PoolAlloc(numLights * Q2LM_MAX_TEXELS * 4, ri.lightSysPool, 0);
+
+	static const char *passNames[] = { "whole surfaces", "dirty rects", "dirty rects on jobs" };
+	for (int pass=0 ; pass<3 ; pass++)
+	{
+		uint32 numTexels = 0;
+		const uint32 startCycles = Sys_Cycles();
+
+		for (int frame=0 ; frame<numFrames ; frame++)
+		{
+			job.builds = &r_q2_lmBuilds[frame * numLights];
+
+			uint32 offset = 0;
+			for (int i=0 ; i<numLights ; i++)
+			{
+				q2LMBuild_t *build = &job.builds[i];
+				if (pass == 0)
+				{
+					build->rect[0] = build->rect[1] = 0;
+					build->rect[2] = build->surf->q2_lmWidth;
+					build->rect[3] = build->surf->q2_lmHeight;
+				}
+				else
+				{
+					const q2LMLight_t *light = &job.lights[build->firstLight];
+					for (int j=0 ; j<4 ; j++)
+						build->rect[j] = light->rect[j];
+				}
+
+				const uint32 size = (build->rect[2] - build->rect[0]) * (build->rect[3] - build->rect[1]);
+				build->offset = offset;
+				offset += size * 4;
+				numTexels += size;
+			}
 
-		RB_BindTexture(ri.media.lmTextures[surf->lmTexNum]);
+			if (pass == 2)
+			{
+				r_imageJobs.Run(R_Q2BSP_LightmapJob, &job, numLights);
+			}
+			else
+			{
+				for (int i=0 ; i<numLights ; i++)
+					R_Q2BSP_LightmapJob(&job, i, 0);
+			}
+		}
 
-		glTexSubImage2D(GL_TEXTURE_2D, 0,
-						surf->q2_lmCoords[0], surf->q2_lmCoords[1],
-						surf->q2_lmWidth, surf->q2_lmHeight,
-						GL_RGBA,
-						GL_UNSIGNED_BYTE,
-						scratch);
+		Com_Printf(0, "%8.2fms %9u texels  %s\n", (Sys_Cycles() - startCycles) * Sys_MSPerCycle(), numTexels, passNames[pass]);
 	}
 
-	RB_CheckForError("R_Q2BSP_UpdateLightmap");
+	Com_Printf(0, "%i frames of %i lights over %i surfaces, %i job threads\n", numFrames, numLights, surfs.Count(), r_imageJobs.NumThreads());
+
+	Mem_Free(job.scratch);
+	r_q2_lmBuilds.Clear();
+	r_q2_lmLights.Clear();
 }
 
 
@@ -870,7 +1234,9 @@ void R_Q2BSP_BeginBuildingLightmaps()
 	for (size=1 ; size<Q2LMBLOCKSIZE && size<ri.config.maxTexSize ; size<<=1);
 	r_q2_lmBlockSize = size;
 
-	// Allocate buffers and clear values
+	// Allocate buffers and clear values, the last map's page buffer is still around
+	if (r_q2_lmBuffer)
+		Mem_Free(r_q2_lmBuffer);
 	r_q2_lmAllocated = (int*)Mem_PoolAlloc(sizeof(int) * r_q2_lmBlockSize, ri.lightSysPool, 0);
 	r_q2_lmBuffer = (byte*)Mem_PoolAlloc(r_q2_lmBlockSize*r_q2_lmBlockSize*4, ri.lightSysPool, 0);
 	memset (r_q2_lmBuffer, 255, r_q2_lmBlockSize*r_q2_lmBlockSize*4);
@@ -909,8 +1275,12 @@ void R_Q2BSP_CreateSurfaceLightmap(mBspSurface_t *surf)
 
 	base = r_q2_lmBuffer + ((surf->q2_lmCoords[1] * r_q2_lmBlockSize + surf->q2_lmCoords[0]) * 4);
 
+	if (surf->q2_lmWidth*surf->q2_lmHeight > Q2LM_MAX_TEXELS)
+		Com_Error(ERR_DROP, "Bad blockLights size");
+
+	const int rect[4] = { 0, 0, surf->q2_lmWidth, surf->q2_lmHeight };
 	R_Q2BSP_SetLMCacheState(surf);
-	R_Q2BSP_BuildLightMap(ri.scn.defaultEntity, surf, base, r_q2_lmBlockSize*4);
+	R_Q2BSP_BuildLightMap(surf, NULL, 0, rect, base, r_q2_lmBlockSize*4);
 
 	r_q2_lmBufferDirty = true;
 }
@@ -927,9 +1297,8 @@ void R_Q2BSP_EndBuildingLightmaps()
 	if (r_q2_lmBufferDirty)
 		R_Q2BSP_UploadLMBlock();
 
-	// Release allocated memory
+	// Release allocated memory, the page buffer stays for R_Q2BSP_UpdateLightmaps
 	Mem_Free(r_q2_lmAllocated);
-	Mem_Free(r_q2_lmBuffer);
 }
 
 
@@ -97,7 +97,8 @@ void R_FontShutdown();
 //
 
 void R_Q2BSP_MarkWorldLights();
-void R_Q2BSP_UpdateLightmap(refEntity_t *ent, mBspSurface_t *surf);
+void R_Q2BSP_UpdateLightmaps(refMeshList *list);
+void R_LightmapBench_f();
 void R_Q2BSP_BeginBuildingLightmaps();
 void R_Q2BSP_CreateSurfaceLightmap(mBspSurface_t *surf);
 void R_Q2BSP_EndBuildingLightmaps();
@@ -150,6 +151,7 @@ void R_AddQ2BrushModel(refEntity_t *ent);
 void R_AddQ3BrushModel(refEntity_t *ent);
 bool R_CullBrushModel(refEntity_t *ent, const uint32 clipFlags);
 void R_AddWorldToList();
+void R_ClearQ2VisCache();
 
 void R_WorldInit();
 void R_WorldShutdown();
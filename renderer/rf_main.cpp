@@ -484,6 +484,10 @@ static void R_RenderRefDef(refDef_t *rd)
 		ri.scn.currentList->SortList();
 	}
 
+	// With the backend skipped the lists are still built and sorted, but nothing reaches GL
+	if (R_SkipBackend())
+		return;
+
 	// Setup state for rendering
 	RB_SetupGL3D();
 
@@ -531,7 +535,7 @@ void R_RenderScene(refDef_t *rd)
 	if (ri.scn.worldModel == ri.scn.defaultModel && !(rd->rdFlags & RDF_NOWORLDMODEL))
 		Com_Error(ERR_DROP, "R_RenderScene: NULL worldmodel");
 
-	if (gl_finish->intVal)
+	if (gl_finish->intVal && !R_SkipBackend())
 		glFinish();
 
 	// Clear shadows
@@ -544,6 +548,10 @@ void R_RenderScene(refDef_t *rd)
 	ri.scn.viewType = RVT_NORMAL;
 	R_RenderRefDef(rd);
 
+	// Bloom and the light level both read back the framebuffer
+	if (R_SkipBackend())
+		return;
+
 	R_BloomBlend(rd);
 
 	// Calculate light level
@@ -588,6 +596,7 @@ void R_EndFrame()
 // ==========================================================
 
 bool r_bInTimeDemo;
+bool r_bNullBackend;
 
 static uint32 r_timeDemoFrame;
 static double r_timeDemoMS;
@@ -659,6 +668,18 @@ void R_EndTimeDemo()
 	Com_Printf(0, "...ShadowRecursion: %7.2fms/%3.2fms\n", ri.pc.timeShadowRecurseWorld * Sys_MSPerCycle(), ri.pc.timeShadowRecurseWorld * Sys_MSPerCycle() * InvFrameCount);
 }
 
+/*
+====================
+R_SetNullBackend
+
+Used by the client demo benchmark to time everything up to the GL calls.
+====================
+*/
+void R_SetNullBackend(const bool bEnable)
+{
+	r_bNullBackend = bEnable;
+}
+
 // ==========================================================
 
 /*
@@ -51,8 +51,23 @@ struct matKey_t
 {
 	char		*keyWord;
 	bool		(*func)(refMaterial_t *mat, matPass_t *pass, parse_t *ps, const char *fileName);
+
+	matKey_t	*hashNext;
+};
+
+#define MAX_MATKEY_HASH			64
+
+// Keyword lists are hashed once at init, wildcard keys are kept aside and
+// only tried when the hash lookup misses
+struct matKeyTable_t
+{
+	matKey_t	*hashTree[MAX_MATKEY_HASH];
+	matKey_t	*wildCards;
 };
 
+static matKeyTable_t	r_materialPassTable;
+static matKeyTable_t	r_materialBaseTable;
+
 /*
 =============================================================================
 
@@ -2499,14 +2514,70 @@ static void R_FinishPass(refMaterial_t *mat, matPass_t *pass)
 }
 
 
+/*
+=============================================================================
+
+	KEYWORD LOOKUP
+
+=============================================================================
+*/
+
+/*
+==================
+R_HashMaterialKeys
+==================
+*/
+static void R_HashMaterialKeys (matKeyTable_t *table, matKey_t *keys, const int numKeys)
+{
+	memset (table, 0, sizeof(matKeyTable_t));
+
+	// Walk backwards so the first of any duplicate keys ends up at the head
+	for (int i=numKeys-1 ; i>=0 ; i--) {
+		matKey_t *key = &keys[i];
+
+		// Wildcards are only valid on ignored (compiler/editor) keys
+		if (strchr (key->keyWord, '*') && !key->func) {
+			key->hashNext = table->wildCards;
+			table->wildCards = key;
+			continue;
+		}
+
+		const uint32 hashValue = Com_HashGenericFast (key->keyWord, MAX_MATKEY_HASH);
+		key->hashNext = table->hashTree[hashValue];
+		table->hashTree[hashValue] = key;
+	}
+}
+
+
+/*
+==================
+R_FindMaterialKey
+==================
+*/
+static matKey_t *R_FindMaterialKey (matKeyTable_t *table, const char *keyName)
+{
+	for (matKey_t *key=table->hashTree[Com_HashGenericFast (keyName, MAX_MATKEY_HASH)] ; key ; key=key->hashNext) {
+		if (!strcmp (key->keyWord, keyName))
+			return key;
+	}
+
+	// Handy for compiler/editor keywords
+	for (matKey_t *key=table->wildCards ; key ; key=key->hashNext) {
+		if (Q_WildcardMatch (key->keyWord, keyName, 1))
+			return key;
+	}
+
+	return NULL;
+}
+
+
 /*
 ==================
 R_ParseMaterialFile
 ==================
 */
-static bool R_MaterialParseTok (refMaterial_t *mat, matPass_t *pass, parse_t *ps, const char *fileName, matKey_t *keys, char *token)
+static bool R_MaterialParseTok (refMaterial_t *mat, matPass_t *pass, parse_t *ps, const char *fileName, matKeyTable_t *table, char *token)
 {
-	matKey_t	*key;
 	char		keyName[MAX_PS_TOKCHARS];
 	char		*str;
 
@@ -2514,21 +2585,8 @@ static bool R_MaterialParseTok (refMaterial_t *mat, matPass_t *pass, parse_t *ps
 	Q_strncpyz (keyName, token, sizeof(keyName));
 	Q_strlwr (keyName);
 
-	// Cycle through the key list looking for a match
-	for (key=keys ; key->keyWord ; key++) {
-		// If this is a wildcard keyword, work some magic
-		// (handy for compiler/editor keywords)
-		if (strchr (key->keyWord, '*') && !key->func) {
-			if (Q_WildcardMatch (key->keyWord, keyName, 1)) {
-				PS_SkipLine (ps);
-				return true;
-			}
-		}
-
-		// See if it matches the keyword
-		if (strcmp (key->keyWord, keyName))
-			continue;
-
+	matKey_t *key = R_FindMaterialKey (table, keyName);
+	if (key) {
 		// This is for keys that compilers and editors use
 		if (!key->func) {
 			PS_SkipLine (ps);
@@ -2626,11 +2684,11 @@ static void R_ParseMaterialFile (char *fixedName, EMatPathType pathType)
 			default:
 				if (inPass) {
 					if (pass)
-						R_MaterialParseTok (mat, pass, ps, fixedName, r_materialPassKeys, token);
+						R_MaterialParseTok (mat, pass, ps, fixedName, &r_materialPassTable, token);
 					break;
 				}
 
-				R_MaterialParseTok (mat, NULL, ps, fixedName, r_materialBaseKeys, token);
+				R_MaterialParseTok (mat, NULL, ps, fixedName, &r_materialBaseTable, token);
 				break;
 			}
 		}
@@ -3387,11 +3445,16 @@ void R_MaterialInit()
 	// Console commands
 	cmd_materialList	= Cmd_AddCommand("materiallist",		0, R_MaterialList_f,		"Prints to the console a list of loaded materials");
 
+	// Keyword tables
+	R_HashMaterialKeys (&r_materialPassTable, r_materialPassKeys, r_numMaterialPassKeys);
+	R_HashMaterialKeys (&r_materialBaseTable, r_materialBaseKeys, r_numMaterialBaseKeys);
+
 	// Load scripts
 	r_numMaterialErrors = 0;
 	r_numMaterialWarnings = 0;
 	var fileList = FS_FindFiles ("scripts", "*scripts/*.shd", "shd", true, false);
 	fileList.AddRange(FS_FindFiles ("scripts", "*scripts/*.shader", "shader", true, false));
+
 	for (uint32 i=0 ; i<fileList.Count(); i++) {
 		// Fix the path
 		Com_NormalizePath (fixedName, sizeof(fixedName), fileList[i].CString());
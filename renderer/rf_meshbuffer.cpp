@@ -508,9 +508,6 @@ void refMeshList::BatchMeshBuffer(refMeshBuffer *mb, refMeshBuffer *nextMB)
 			// Push the mesh
 			RB_PushMesh(surf->mesh, features);
 
-			// Update lightmap
-			R_Q2BSP_UpdateLightmap(ent, surf);
-
 			// Render if necessary
 			if (bCantMerge)
 			{
@@ -633,6 +630,9 @@ refMeshList::DrawList
 */
 void refMeshList::DrawList()
 {
+	// Rebuild changed lightmaps up front, so the builds can run in parallel
+	R_Q2BSP_UpdateLightmaps(this);
+
 	// Start
 	RB_StartRendering();
 
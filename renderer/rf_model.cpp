@@ -553,9 +553,9 @@ static refModel_t *R_LoadBSPModel(const char *name)
 	// Not found -- allocate a spot
 	model = R_GetModelSlot();
 
-	// Load the file
-	byte *buffer;
-	const int fileLen = FS_LoadFile(name, (void **)&buffer, false);
+	// Load the file, the collision model has usually read it already
+	int fileLen;
+	const byte *buffer = CM_AcquireMapImage(name, &fileLen, NULL);
 	if (!buffer || fileLen <= 0)
 		Com_Error(ERR_DROP, "R_LoadBSPModel: %s not found", name);
 
@@ -573,7 +573,7 @@ static refModel_t *R_LoadBSPModel(const char *name)
 	}
 	if (i == r_numBSPFormats)
 	{
-		FS_FreeFile(buffer);
+		CM_ReleaseMapImage(buffer);
 		Com_Error(ERR_DROP, "R_LoadBSPModel: unknown fileId for %s", model->name);
 	}
 
@@ -581,14 +581,14 @@ static refModel_t *R_LoadBSPModel(const char *name)
 	model->radius = 0;
 	ClearBounds(model->mins, model->maxs);
 
-	// Load
+	// Load, the BSP loaders only read from the image
 	Q_strncpyz(model->bareName, bareName, sizeof(model->bareName));
 	Q_strncpyz(model->name, name, sizeof(model->name));
-	if (!descr->loader(model, buffer))
+	if (!descr->loader(model, (byte *)buffer))
 	{
 		Mem_FreeTag(ri.modelSysPool, model->memTag);
 		model->type = MODEL_BAD;
-		FS_FreeFile(buffer);
+		CM_ReleaseMapImage(buffer);
 		Com_Error(ERR_DROP, "R_LoadBSPModel: failed to load map!", model->name);
 	}
 
@@ -600,7 +600,7 @@ static refModel_t *R_LoadBSPModel(const char *name)
 	model->hashNext = r_modelHashTree[model->hashValue];
 	r_modelHashTree[model->hashValue] = model;
 
-	FS_FreeFile(buffer);
+	CM_ReleaseMapImage(buffer);
 	return model;
 }
 
@@ -630,6 +630,7 @@ void R_RegisterMap(const char *mapName)
 	// Load the model
 	ri.scn.worldModel = R_LoadBSPModel(mapName);
 	ri.scn.worldEntity->model = ri.scn.worldModel;
+	R_ClearQ2VisCache();
 
 	// Force updates (markleaves, light marking, etc)
 	ri.scn.viewCluster = -1;
@@ -668,6 +669,9 @@ void R_EndModelRegistration()
 		}
 	}
 
+	// The world model is loaded, the collision model's map image can go
+	CM_FlushMapImage();
+
 	Com_DevPrintf(PRNT_CONSOLE, "Completing model system registration:\n-Released: %i\n-Touched: %i\n-Seaked: %i\n", ri.reg.modelsReleased, ri.reg.modelsTouched, ri.reg.modelsSeaked);
 }
 
@@ -1280,6 +1284,9 @@ void R_ModelShutdown ()
 	for (uint32 i=0 ; i<r_numModels ; i++)
 		R_FreeModel(&r_modelList[i]);
 
+	// Drop the map image in case a world load errored out holding it
+	CM_FlushMapImage();
+
 	// Release pool memory
 	uint32 size = Mem_FreePool(ri.modelSysPool);
 	Com_Printf(0, "...releasing %u bytes...\n", size);
@@ -261,7 +261,7 @@ struct mBspSurface_t
 	ivec2_t					q2_dLightCoords;	// gl lightmap coordinates for dynamic lightmaps
 
 	uint32					q2_dLightUpdateFrame; // last frame that the dynamic light was updated
-	bool					q2_bDLightDirty;	// had dynamic lights written to it last update
+	svec4_t					q2_dLightRect;		// texels dynamic lights wrote last update, s/t mins and maxs
 	ivec2_t					q2_lmCoords;		// gl lightmap coordinates
 	int						q2_lmWidth;
 	int						q2_lmHeight;
@@ -305,6 +305,9 @@ struct mNodeLeafShared_t
 {
 	uint32					visFrame;			// node needs to be traversed if current
 
+	uint32					cullFrame;			// a leaf below survived the frustum pass if current
+	uint32					cullFlags;			// frustum planes still straddled by those leaves
+
 	plane_t					*plane;				// Q2BSP uses this in nodes, Q3BSP uses this in leafs
 	int						q2_contents;		// -1, to differentiate from leafs
 
@@ -1891,7 +1891,7 @@ R_LoadQ2BSPModel
 */
 bool R_LoadQ2BSPModel(refModel_t *model, byte *buffer)
 {
-	dQ2BspHeader_t	*header;
+	dQ2BspHeader_t	header;
 	byte			*modBase;
 	int				version;
 	uint32			i;
@@ -1902,8 +1902,8 @@ bool R_LoadQ2BSPModel(refModel_t *model, byte *buffer)
 	model->modelData = (mBspModelBase_t*)R_ModAlloc(model, sizeof(mQ2BspModel_t));
 	model->type = MODEL_Q2BSP;
 
-	header = (dQ2BspHeader_t *)buffer;
-	version = LittleLong (header->version);
+	header = *(dQ2BspHeader_t *)buffer;
+	version = LittleLong (header.version);
 	if (version != Q2BSP_VERSION)
 	{
 		Com_Printf (PRNT_ERROR, "R_LoadQ2BSPModel: %s has wrong version number (%i should be %i)\n", model->name, version, Q2BSP_VERSION);
@@ -1911,27 +1911,27 @@ bool R_LoadQ2BSPModel(refModel_t *model, byte *buffer)
 	}
 
 	//
-	// Swap all the lumps
+	// Swap all the lumps, into a copy as the file image is read-only
 	//
-	modBase = (byte *)header;
+	modBase = buffer;
 	for (i=0 ; i<sizeof(dQ2BspHeader_t)/4 ; i++)
-		((int *)header)[i] = LittleLong (((int *)header)[i]);
+		((int *)&header)[i] = LittleLong (((int *)&header)[i]);
 
 	//
 	// Load into heap
 	//
-	if (!R_LoadQ2BSPVertexes	(model, modBase, &header->lumps[Q2BSP_LUMP_VERTEXES])
-	|| !R_LoadQ2BSPEdges		(model, modBase, &header->lumps[Q2BSP_LUMP_EDGES])
-	|| !R_LoadQ2BSPSurfEdges	(model, modBase, &header->lumps[Q2BSP_LUMP_SURFEDGES])
-	|| !R_LoadQ2BSPLighting		(model, model->Q2BSPData(), modBase, &header->lumps[Q2BSP_LUMP_LIGHTING])
-	|| !R_LoadQ2BSPPlanes		(model, modBase, &header->lumps[Q2BSP_LUMP_PLANES])
-	|| !R_LoadQ2BSPTexInfo		(model, model->Q2BSPData(), modBase, &header->lumps[Q2BSP_LUMP_TEXINFO])
-	|| !R_LoadQ2BSPFaces		(model, model->Q2BSPData(), modBase, &header->lumps[Q2BSP_LUMP_FACES])
-	|| !R_LoadQ2BSPMarkSurfaces	(model, model->Q2BSPData(), modBase, &header->lumps[Q2BSP_LUMP_LEAFFACES])
-	|| !R_LoadQ2BSPVisibility	(model, model->Q2BSPData(), modBase, &header->lumps[Q2BSP_LUMP_VISIBILITY])
-	|| !R_LoadQ2BSPLeafs		(model, model->Q2BSPData(), modBase, &header->lumps[Q2BSP_LUMP_LEAFS])
-	|| !R_LoadQ2BSPNodes		(model, modBase, &header->lumps[Q2BSP_LUMP_NODES])
-	|| !R_LoadQ2BSPSubModels	(model, modBase, &header->lumps[Q2BSP_LUMP_MODELS]))
+	if (!R_LoadQ2BSPVertexes	(model, modBase, &header.lumps[Q2BSP_LUMP_VERTEXES])
+	|| !R_LoadQ2BSPEdges		(model, modBase, &header.lumps[Q2BSP_LUMP_EDGES])
+	|| !R_LoadQ2BSPSurfEdges	(model, modBase, &header.lumps[Q2BSP_LUMP_SURFEDGES])
+	|| !R_LoadQ2BSPLighting		(model, model->Q2BSPData(), modBase, &header.lumps[Q2BSP_LUMP_LIGHTING])
+	|| !R_LoadQ2BSPPlanes		(model, modBase, &header.lumps[Q2BSP_LUMP_PLANES])
+	|| !R_LoadQ2BSPTexInfo		(model, model->Q2BSPData(), modBase, &header.lumps[Q2BSP_LUMP_TEXINFO])
+	|| !R_LoadQ2BSPFaces		(model, model->Q2BSPData(), modBase, &header.lumps[Q2BSP_LUMP_FACES])
+	|| !R_LoadQ2BSPMarkSurfaces	(model, model->Q2BSPData(), modBase, &header.lumps[Q2BSP_LUMP_LEAFFACES])
+	|| !R_LoadQ2BSPVisibility	(model, model->Q2BSPData(), modBase, &header.lumps[Q2BSP_LUMP_VISIBILITY])
+	|| !R_LoadQ2BSPLeafs		(model, model->Q2BSPData(), modBase, &header.lumps[Q2BSP_LUMP_LEAFS])
+	|| !R_LoadQ2BSPNodes		(model, modBase, &header.lumps[Q2BSP_LUMP_NODES])
+	|| !R_LoadQ2BSPSubModels	(model, modBase, &header.lumps[Q2BSP_LUMP_MODELS]))
 		return false;
 
 	//
@@ -3306,8 +3306,8 @@ bool R_LoadQ3BSPModel(refModel_t *model, byte *buffer)
 
 	mQ3BspModel_t *q3BspModel = model->Q3BSPData();
 
-	dQ3BspHeader_t *header = (dQ3BspHeader_t *)buffer;
-	int version = LittleLong (header->version);
+	dQ3BspHeader_t header = *(dQ3BspHeader_t *)buffer;
+	int version = LittleLong (header.version);
 	if (version != Q3BSP_VERSION)
 	{
 		Com_Printf (PRNT_ERROR, "R_LoadQ3BSPModel: %s has wrong version number (%i should be %i)\n", model->name, version, Q3BSP_VERSION);
@@ -3315,31 +3315,31 @@ bool R_LoadQ3BSPModel(refModel_t *model, byte *buffer)
 	}
 
 	//
-	// Swap all the lumps
+	// Swap all the lumps, into a copy as the file image is read-only
 	//
-	byte *modBase = (byte *)header;
+	byte *modBase = buffer;
 	for (uint32 i=0 ; i<sizeof(dQ3BspHeader_t)/4 ; i++)
-		((int *)header)[i] = LittleLong (((int *)header)[i]);
+		((int *)&header)[i] = LittleLong (((int *)&header)[i]);
 
 	//
 	// Load into heap
 	//
-	if (!R_LoadQ3BSPEntities	(model, modBase, &header->lumps[Q3BSP_LUMP_ENTITIES])
-	|| !R_LoadQ3BSPVertexes		(model, modBase, &header->lumps[Q3BSP_LUMP_VERTEXES])
-	|| !R_LoadQ3BSPIndexes		(model, modBase, &header->lumps[Q3BSP_LUMP_INDEXES])
-	|| !R_LoadQ3BSPLighting		(model, modBase, &header->lumps[Q3BSP_LUMP_LIGHTING], &header->lumps[Q3BSP_LUMP_LIGHTGRID])
-	|| !R_LoadQ3BSPVisibility	(model, modBase, &header->lumps[Q3BSP_LUMP_VISIBILITY])
-	|| !R_LoadQ3BSPMaterialRefs	(model, modBase, &header->lumps[Q3BSP_LUMP_MATERIALREFS])
-	|| !R_LoadQ3BSPPlanes		(model, modBase, &header->lumps[Q3BSP_LUMP_PLANES])
-	|| !R_LoadQ3BSPFogs			(model, modBase, &header->lumps[Q3BSP_LUMP_FOGS], &header->lumps[Q3BSP_LUMP_BRUSHES], &header->lumps[Q3BSP_LUMP_BRUSHSIDES])
-	|| !R_LoadQ3BSPFaces		(model, modBase, &header->lumps[Q3BSP_LUMP_FACES])
-	|| !R_LoadQ3BSPLeafs		(model, modBase, &header->lumps[Q3BSP_LUMP_LEAFS], &header->lumps[Q3BSP_LUMP_LEAFFACES])
-	|| !R_LoadQ3BSPNodes		(model, modBase, &header->lumps[Q3BSP_LUMP_NODES])
-	|| !R_LoadQ3BSPSubmodels	(model, modBase, &header->lumps[Q3BSP_LUMP_MODELS]))
+	if (!R_LoadQ3BSPEntities	(model, modBase, &header.lumps[Q3BSP_LUMP_ENTITIES])
+	|| !R_LoadQ3BSPVertexes		(model, modBase, &header.lumps[Q3BSP_LUMP_VERTEXES])
+	|| !R_LoadQ3BSPIndexes		(model, modBase, &header.lumps[Q3BSP_LUMP_INDEXES])
+	|| !R_LoadQ3BSPLighting		(model, modBase, &header.lumps[Q3BSP_LUMP_LIGHTING], &header.lumps[Q3BSP_LUMP_LIGHTGRID])
+	|| !R_LoadQ3BSPVisibility	(model, modBase, &header.lumps[Q3BSP_LUMP_VISIBILITY])
+	|| !R_LoadQ3BSPMaterialRefs	(model, modBase, &header.lumps[Q3BSP_LUMP_MATERIALREFS])
+	|| !R_LoadQ3BSPPlanes		(model, modBase, &header.lumps[Q3BSP_LUMP_PLANES])
+	|| !R_LoadQ3BSPFogs			(model, modBase, &header.lumps[Q3BSP_LUMP_FOGS], &header.lumps[Q3BSP_LUMP_BRUSHES], &header.lumps[Q3BSP_LUMP_BRUSHSIDES])
+	|| !R_LoadQ3BSPFaces		(model, modBase, &header.lumps[Q3BSP_LUMP_FACES])
+	|| !R_LoadQ3BSPLeafs		(model, modBase, &header.lumps[Q3BSP_LUMP_LEAFS], &header.lumps[Q3BSP_LUMP_LEAFFACES])
+	|| !R_LoadQ3BSPNodes		(model, modBase, &header.lumps[Q3BSP_LUMP_NODES])
+	|| !R_LoadQ3BSPSubmodels	(model, modBase, &header.lumps[Q3BSP_LUMP_MODELS]))
 		return false;
 
 	// Finishing touches
-	R_FinishQ3BSPModel(model, modBase, &header->lumps[Q3BSP_LUMP_LIGHTING]);
+	R_FinishQ3BSPModel(model, modBase, &header.lumps[Q3BSP_LUMP_LIGHTING]);
 
 	// Set up the submodels
 	R_SetupQ3BSPSubModels(model);
@@ -89,6 +89,9 @@ cVar_t	*r_flareSize;
 cVar_t	*r_fontScale;
 cVar_t	*r_fullbright;
 cVar_t	*r_hwGamma;
+cVar_t	*r_imageCache;
+cVar_t	*r_imageCacheSize;
+cVar_t	*r_imageThreads;
 cVar_t	*r_lerpmodels;
 cVar_t	*r_lightlevel;
 cVar_t	*r_lmMaxBlockSize;
@@ -138,6 +141,7 @@ static conCmd_t	*cmd_gfxInfo;
 static conCmd_t	*cmd_rendererClass;
 static conCmd_t	*cmd_eglRenderer;
 static conCmd_t	*cmd_eglVersion;
+static conCmd_t	*cmd_lightmapBench;
 
 /*
 =============================================================================
@@ -397,6 +401,9 @@ void R_RegisterConfig()
 	r_fontScale			= Cvar_Register("r_fontScale",			"1",			CVAR_ARCHIVE);
 	r_fullbright		= Cvar_Register("r_fullbright",			"0",			CVAR_CHEAT);
 	r_hwGamma			= Cvar_Register("r_hwGamma",			"0",			CVAR_ARCHIVE|CVAR_LATCH_VIDEO);
+	r_imageCache		= Cvar_Register("r_imageCache",			"1",			CVAR_ARCHIVE);
+	r_imageCacheSize	= Cvar_Register("r_imageCacheSize",		"256",			CVAR_ARCHIVE);
+	r_imageThreads		= Cvar_Register("r_imageThreads",		"2",			CVAR_ARCHIVE|CVAR_LATCH_VIDEO);
 	r_lerpmodels		= Cvar_Register("r_lerpmodels",			"1",			0);
 	r_lightlevel		= Cvar_Register("r_lightlevel",			"0",			0);
 	r_lmMaxBlockSize	= Cvar_Register("r_lmMaxBlockSize",		"4096",			CVAR_ARCHIVE|CVAR_LATCH_VIDEO);
@@ -456,6 +463,7 @@ void R_RegisterConfig()
 	cmd_rendererClass	= Cmd_AddCommand("rendererclass",	0, R_RendererClass_f,		"Prints out the renderer class");
 	cmd_eglRenderer		= Cmd_AddCommand("egl_renderer",	0, R_RendererMsg_f,			"Spams to the server your renderer information");
 	cmd_eglVersion		= Cmd_AddCommand("egl_version",		0, R_VersionMsg_f,			"Spams to the server your client version");
+	cmd_lightmapBench	= Cmd_AddCommand("r_lightmapbench",	0, R_LightmapBench_f,		"Times dynamic lightmap building over a replay of lights on the current map");
 }
 
 /*
@@ -469,6 +477,7 @@ void R_UnRegisterConfig()
 	Cmd_RemoveCommand(cmd_rendererClass);
 	Cmd_RemoveCommand(cmd_eglRenderer);
 	Cmd_RemoveCommand(cmd_eglVersion);
+	Cmd_RemoveCommand(cmd_lightmapBench);
 }
 
 /*
@@ -497,6 +506,7 @@ void R_BeginRegistration()
 	ri.reg.fontsTouched = 0;
 	ri.reg.imagesReleased = 0;
 	ri.reg.imagesResampled = 0;
+	ri.reg.imagesCached = 0;
 	ri.reg.imagesSeaked = 0;
 	ri.reg.imagesTouched = 0;
 	ri.reg.modelsReleased = 0;
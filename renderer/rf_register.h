@@ -93,6 +93,9 @@ extern cVar_t	*r_flareSize;
 extern cVar_t	*r_fontScale;
 extern cVar_t	*r_fullbright;
 extern cVar_t	*r_hwGamma;
+extern cVar_t	*r_imageCache;
+extern cVar_t	*r_imageCacheSize;
+extern cVar_t	*r_imageThreads;
 extern cVar_t	*r_lerpmodels;
 extern cVar_t	*r_lightlevel;	// FIXME: This is a HACK to get the client's light level
 extern cVar_t	*r_lmMaxBlockSize;
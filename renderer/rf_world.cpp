@@ -149,6 +149,164 @@ R_CullQ2SurfaceBounds
 #define R_CullQ2SurfaceBounds(surf,clipFlags) R_CullBox((surf)->mins,(surf)->maxs,(clipFlags))
 
 
+/*
+=============================================================================
+
+	VISIBLE LEAF CACHE
+
+	Every view cluster (or pair of clusters, when the view straddles a water
+	boundary) gets a flat list of the non-solid leaves it can see, along with
+	their bounds laid out for four-wide frustum tests. The lists are built the
+	first time a cluster is entered and kept until the slot is needed again,
+	so walking around a map stops rescanning every leaf on each cluster
+	change, and the frustum pass becomes a linear sweep instead of a box test
+	on every node of the tree.
+
+=============================================================================
+*/
+
+#define MAX_Q2VIS_CACHE		32
+#define Q2VIS_BAD_BOUNDS	1e20f		// never culled, straddles every plane
+
+struct mQ2VisLeafs_t
+{
+	int						cluster1;
+	int						cluster2;
+	uint32					lastUsed;
+
+	int						numLeafs;
+	int						stride;			// SIMD_ALIGN(numLeafs)
+	mBspLeaf_t				**leafs;
+	float					*bounds;		// mins[0..2] then maxs[0..2], stride floats each
+};
+
+static mQ2VisLeafs_t	r_q2VisCache[MAX_Q2VIS_CACHE];
+static mQ2VisLeafs_t	*r_q2CurrentVis;
+static uint32			r_q2CullFrame;
+
+/*
+===============
+R_ClearQ2VisCache
+===============
+*/
+void R_ClearQ2VisCache()
+{
+	for (int i=0 ; i<MAX_Q2VIS_CACHE ; i++)
+	{
+		if (r_q2VisCache[i].leafs)
+			Mem_Free(r_q2VisCache[i].leafs);
+	}
+
+	memset(r_q2VisCache, 0, sizeof(r_q2VisCache));
+	r_q2CurrentVis = NULL;
+}
+
+
+/*
+===============
+R_BuildQ2VisLeafs
+
+A cluster of -1 collects every non-solid leaf in the map.
+===============
+*/
+static void R_BuildQ2VisLeafs(mQ2VisLeafs_t *out, const int cluster1, const int cluster2)
+{
+	mBspModelBase_t *bspModel = ri.scn.worldModel->BSPData();
+
+	byte *vis = NULL;
+	byte fatVis[Q2BSP_MAX_VIS];
+	if (cluster1 != -1)
+	{
+		vis = R_BSPClusterPVS(cluster1, ri.scn.worldModel);
+
+		// May have to combine two clusters because of solid water boundaries
+		if (cluster2 != cluster1)
+		{
+			memcpy(fatVis, vis, (bspModel->numLeafs+7)/8);
+			vis = R_BSPClusterPVS(cluster2, ri.scn.worldModel);
+			int c = (bspModel->numLeafs+31)/32;
+			for (int i=0 ; i<c ; i++)
+				((int*)fatVis)[i] |= ((int*)vis)[i];
+			vis = fatVis;
+		}
+	}
+
+	// Count first so the arrays are a single allocation
+	int numLeafs = 0;
+	for (int i=0 ; i<bspModel->numLeafs ; i++)
+	{
+		mBspLeaf_t *leaf = &bspModel->leafs[i];
+		if (leaf->q2_contents == CONTENTS_SOLID)
+			continue;
+		if (vis && (leaf->cluster == -1 || !(vis[leaf->cluster>>3] & BIT(leaf->cluster&7))))
+			continue;
+		numLeafs++;
+	}
+
+	const int stride = SIMD_ALIGN(Max<int>(numLeafs, 1));
+	byte *buffer = (byte*)Mem_PoolAlloc(stride * (sizeof(mBspLeaf_t*) + sizeof(float) * 6), ri.genericPool, 0);
+
+	out->cluster1 = cluster1;
+	out->cluster2 = cluster2;
+	out->numLeafs = 0;
+	out->stride = stride;
+	out->leafs = (mBspLeaf_t**)buffer;
+	out->bounds = (float*)(buffer + stride * sizeof(mBspLeaf_t*));
+
+	for (int i=0 ; i<bspModel->numLeafs ; i++)
+	{
+		mBspLeaf_t *leaf = &bspModel->leafs[i];
+		if (leaf->q2_contents == CONTENTS_SOLID)
+			continue;
+		if (vis && (leaf->cluster == -1 || !(vis[leaf->cluster>>3] & BIT(leaf->cluster&7))))
+			continue;
+
+		const int n = out->numLeafs++;
+		out->leafs[n] = leaf;
+		for (int j=0 ; j<3 ; j++)
+		{
+			out->bounds[j*stride + n] = leaf->badBounds ? -Q2VIS_BAD_BOUNDS : leaf->mins[j];
+			out->bounds[(j+3)*stride + n] = leaf->badBounds ? Q2VIS_BAD_BOUNDS : leaf->maxs[j];
+		}
+	}
+}
+
+
+/*
+===============
+R_Q2VisLeafs
+
+Finds the cached leaf list for a cluster pair, building it in the least
+recently used slot if needed.
+===============
+*/
+static mQ2VisLeafs_t *R_Q2VisLeafs(const int cluster1, const int cluster2)
+{
+	mQ2VisLeafs_t *best = NULL;
+	for (int i=0 ; i<MAX_Q2VIS_CACHE ; i++)
+	{
+		mQ2VisLeafs_t *cache = &r_q2VisCache[i];
+		if (cache->leafs && cache->cluster1 == cluster1 && cache->cluster2 == cluster2)
+		{
+			cache->lastUsed = ri.frameCount;
+			return cache;
+		}
+
+		// Never evict the list currently being drawn (gl_lockpvs holds on to it)
+		if (cache == r_q2CurrentVis)
+			continue;
+		if (!best || !cache->leafs || (best->leafs && cache->lastUsed < best->lastUsed))
+			best = cache;
+	}
+
+	if (best->leafs)
+		Mem_Free(best->leafs);
+	R_BuildQ2VisLeafs(best, cluster1, cluster2);
+	best->lastUsed = ri.frameCount;
+	return best;
+}
+
+
 /*
 ===============
 R_MarkQ2Leaves
@@ -197,11 +355,11 @@ static void R_MarkQ2Leaves()
 			viewCluster2 = leaf->cluster;
 	}
 
-	if (ri.scn.oldViewCluster == ri.scn.viewCluster && oldViewCluster2 == viewCluster2 && (ri.def.rdFlags & RDF_OLDAREABITS) && !r_noVis->intVal && ri.scn.viewCluster != -1)
+	if (r_q2CurrentVis && ri.scn.oldViewCluster == ri.scn.viewCluster && oldViewCluster2 == viewCluster2 && (ri.def.rdFlags & RDF_OLDAREABITS) && !r_noVis->intVal && ri.scn.viewCluster != -1)
 		return;
 
 	// Development aid to let you run around and see exactly where the pvs ends
-	if (gl_lockpvs->intVal)
+	if (gl_lockpvs->intVal && r_q2CurrentVis)
 		return;
 
 	ri.scn.visFrameCount++;
@@ -215,108 +373,167 @@ static void R_MarkQ2Leaves()
 			ri.scn.worldModel->BSPData()->leafs[i].visFrame = ri.scn.visFrameCount;
 		for (int i=0 ; i<ri.scn.worldModel->BSPData()->numNodes ; i++)
 			ri.scn.worldModel->BSPData()->nodes[i].visFrame = ri.scn.visFrameCount;
+
+		r_q2CurrentVis = R_Q2VisLeafs(-1, -1);
 		return;
 	}
 
-	byte *vis = R_BSPClusterPVS(ri.scn.viewCluster, ri.scn.worldModel);
+	// Order the pair so standing either side of the boundary shares a list
+	r_q2CurrentVis = R_Q2VisLeafs(Min<int>(ri.scn.viewCluster, viewCluster2), Max<int>(ri.scn.viewCluster, viewCluster2));
 
-	// May have to combine two clusters because of solid water boundaries
-	if (viewCluster2 != ri.scn.viewCluster)
+	// Only the visible leaves are walked, not the whole map
+	for (int i=0 ; i<r_q2CurrentVis->numLeafs ; i++)
 	{
-		byte fatVis[Q2BSP_MAX_VIS];
-		memcpy(fatVis, vis, (ri.scn.worldModel->BSPData()->numLeafs+7)/8);
-		vis = R_BSPClusterPVS(viewCluster2, ri.scn.worldModel);
-		int c = (ri.scn.worldModel->BSPData()->numLeafs+31)/32;
-		for (int i=0 ; i<c ; i++)
-			((int*)fatVis)[i] |= ((int*)vis)[i];
-		vis = fatVis;
-	}
-
-	for (int i=0 ; i<ri.scn.worldModel->BSPData()->numLeafs ; i++)
-	{
-		leaf = &ri.scn.worldModel->BSPData()->leafs[i];
-		if (leaf->cluster != -1 && vis[leaf->cluster>>3] & BIT(leaf->cluster&7))
+		mBspNode_t *node = (mBspNode_t *)r_q2CurrentVis->leafs[i];
+		do
 		{
-			mBspNode_t *node = (mBspNode_t *)leaf;
-			do
-			{
-				if (node->visFrame == ri.scn.visFrameCount)
-					break;
+			if (node->visFrame == ri.scn.visFrameCount)
+				break;
 
-				node->visFrame = ri.scn.visFrameCount;
-				node = node->parent;
-			} while (node);
-		}
+			node->visFrame = ri.scn.visFrameCount;
+			node = node->parent;
+		} while (node);
 	}
 }
 
 
 /*
-================
-R_RecursiveQ2WorldNode
-================
+===============
+R_CullQ2Leaves
+
+Frustum culls the visible leaf list four leaves at a time. Surviving leaves
+mark their surfaces, and stamp their parent chain with this pass and with the
+frustum planes they still straddle, which is all the recursion needs.
+===============
 */
-static void R_RecursiveQ2WorldNode(mBspNode_t *node, uint32 clipFlags)
+static void R_CullQ2Leaves(const mQ2VisLeafs_t *vis, const uint32 clipFlags)
 {
-	if (node->q2_contents == CONTENTS_SOLID)
-		return;		// Solid
-	if (R_CullNode(node))
-		return;		// Node not visible this frame
-
-	// Cull
-	if (clipFlags && !node->badBounds)
+	r_q2CullFrame++;
+
+	// Pick the near and far corner for each plane from the sign of its normal
+	int numPlanes = 0;
+	uint32 planeBits[FRP_MAX];
+	simdVec_t planeNormal[FRP_MAX][3];
+	simdVec_t planeDist[FRP_MAX];
+	const float *nearBounds[FRP_MAX][3];
+	const float *farBounds[FRP_MAX][3];
+	for (int num=0 ; num<FRP_MAX ; num++)
 	{
-		for (int num=0 ; num<FRP_MAX ; num++)
-		{
-			if (clipFlags & BIT(num))
-			{
-				plane_t *p = &ri.scn.viewFrustum[num];
-				int clipped = BoxOnPlaneSide(node->mins, node->maxs, p);
-				switch(clipped)
-				{
-				case 1:
-					clipFlags &= ~BIT(num);
-					break;
+		if (!(clipFlags & BIT(num)))
+			continue;
 
-				case 2:
-					if (!ri.scn.bDrawingMeshOutlines)
-						ri.pc.cullBounds[CULL_PASS]++;
-					return;
-				}
-			}
+		const plane_t *p = &ri.scn.viewFrustum[num];
+		planeBits[numPlanes] = BIT(num);
+		planeDist[numPlanes] = Simd_Splat(p->dist);
+		for (int j=0 ; j<3 ; j++)
+		{
+			planeNormal[numPlanes][j] = Simd_Splat(p->normal[j]);
+			nearBounds[numPlanes][j] = vis->bounds + ((p->normal[j] >= 0) ? j : j+3) * vis->stride;
+			farBounds[numPlanes][j] = vis->bounds + ((p->normal[j] >= 0) ? j+3 : j) * vis->stride;
 		}
-
-		if (!ri.scn.bDrawingMeshOutlines)
-			ri.pc.cullBounds[CULL_FAIL]++;
+		numPlanes++;
 	}
 
-	// If this is a leaf node
-	if (node->q2_contents != -1)
+	for (int i=0 ; i<vis->numLeafs ; i+=SIMD_WIDTH)
 	{
-		mBspLeaf_t *Leaf = (mBspLeaf_t*)node;
+		const int inUse = BIT(Min<int>(vis->numLeafs - i, SIMD_WIDTH)) - 1;
+		int visible = inUse;
+		int straddle[FRP_MAX];
 
-		// Check for door connected areas
-		if (ri.def.areaBits)
+		for (int p=0 ; p<numPlanes ; p++)
 		{
-			if (!(ri.def.areaBits[Leaf->area>>3] & BIT(Leaf->area&7)))
-				return; // Not visible
+			simdVec_t dmax = Simd_Mul(planeNormal[p][0], Simd_Load(farBounds[p][0] + i));
+			dmax = Simd_Madd(planeNormal[p][1], Simd_Load(farBounds[p][1] + i), dmax);
+			dmax = Simd_Madd(planeNormal[p][2], Simd_Load(farBounds[p][2] + i), dmax);
+
+			simdVec_t dmin = Simd_Mul(planeNormal[p][0], Simd_Load(nearBounds[p][0] + i));
+			dmin = Simd_Madd(planeNormal[p][1], Simd_Load(nearBounds[p][1] + i), dmin);
+			dmin = Simd_Madd(planeNormal[p][2], Simd_Load(nearBounds[p][2] + i), dmin);
+
+			// Same rules as BoxOnPlaneSide
+			visible &= ~Simd_MoveMask(Simd_CmpLT(dmax, planeDist[p]));
+			straddle[p] = Simd_MoveMask(Simd_CmpLT(dmin, planeDist[p]));
 		}
 
-		// Mark surfaces visible
-		mBspSurface_t **mark = Leaf->q2_firstMarkSurface;
-		int Count = Leaf->q2_numMarkSurfaces;
+		if (numPlanes && !ri.scn.bDrawingMeshOutlines)
+		{
+			for (int lane=0 ; lane<SIMD_WIDTH ; lane++)
+			{
+				if (inUse & BIT(lane))
+					ri.pc.cullBounds[(visible & BIT(lane)) ? CULL_FAIL : CULL_PASS]++;
+			}
+		}
 
-		if (Count)
+		for (int lane=0 ; visible ; lane++, visible>>=1)
 		{
-			do
+			if (!(visible & 1))
+				continue;
+
+			mBspLeaf_t *leaf = vis->leafs[i+lane];
+
+			// Check for door connected areas
+			if (ri.def.areaBits)
 			{
-				mBspSurface_t *surf = *mark++;
-				surf->visFrame = ri.frameCount;
-			} while (--Count);
+				if (!(ri.def.areaBits[leaf->area>>3] & BIT(leaf->area&7)))
+					continue; // Not visible
+			}
+
+			// Mark surfaces visible
+			mBspSurface_t **mark = leaf->q2_firstMarkSurface;
+			for (int j=0 ; j<leaf->q2_numMarkSurfaces ; j++)
+				mark[j]->visFrame = ri.frameCount;
+
+			uint32 bits = 0;
+			for (int p=0 ; p<numPlanes ; p++)
+			{
+				if (straddle[p] & BIT(lane))
+					bits |= planeBits[p];
+			}
+
+			// Stamp the parents, stopping once an ancestor already has these planes
+			for (mBspNode_t *node=leaf->parent ; node ; node=node->parent)
+			{
+				if (node->cullFrame != r_q2CullFrame)
+				{
+					node->cullFrame = r_q2CullFrame;
+					node->cullFlags = bits;
+				}
+				else if ((node->cullFlags & bits) == bits)
+				{
+					break;
+				}
+				else
+				{
+					node->cullFlags |= bits;
+				}
+			}
 		}
+	}
+}
+
+
+/*
+================
+R_RecursiveQ2WorldNode
 
+Only descends into nodes stamped by R_CullQ2Leaves, so the surfaces still come
+out back to front.
+================
+*/
+static void R_RecursiveQ2WorldNode(mBspNode_t *node)
+{
+	// Leaves were handled by the frustum pass
+	if (node->q2_contents != -1)
 		return;
+
+	if (node->cullFrame != r_q2CullFrame)
+	{
+		if (!ri.scn.bDrawingMeshOutlines)
+			ri.pc.cullVis[CULL_PASS]++;
+		return;		// Nothing below is visible this frame
 	}
+	if (!ri.scn.bDrawingMeshOutlines)
+		ri.pc.cullVis[CULL_FAIL]++;
 
 	// Node is just a decision point, so go down the apropriate sides
 	// Find which side of the node we are on
@@ -324,7 +541,7 @@ static void R_RecursiveQ2WorldNode(mBspNode_t *node, uint32 clipFlags)
 	const int side = (dist >= 0) ? 0 : 1;
 
 	// Recurse down the children, back side first
-	R_RecursiveQ2WorldNode(node->children[side], clipFlags);
+	R_RecursiveQ2WorldNode(node->children[side]);
 
 	if (node->q2_firstVisSurface && *node->q2_firstVisSurface)
 	{
@@ -351,7 +568,7 @@ static void R_RecursiveQ2WorldNode(mBspNode_t *node, uint32 clipFlags)
 			// Cull
 			if (R_CullQ2SurfacePlanar(surf, texInfo->mat, dist))
 				continue;
-			if (R_CullQ2SurfaceBounds(surf, clipFlags))
+			if (R_CullQ2SurfaceBounds(surf, node->cullFlags))
 				continue;
 
 			// Sky surface
@@ -367,7 +584,7 @@ static void R_RecursiveQ2WorldNode(mBspNode_t *node, uint32 clipFlags)
 	}
 
 	// Recurse down the front side
-	R_RecursiveQ2WorldNode(node->children[side^1], clipFlags);
+	R_RecursiveQ2WorldNode(node->children[side^1]);
 }
 
 /*
@@ -935,7 +1152,8 @@ void R_AddWorldToList()
 				// Recurse the world
 				{
 					qStatCycle_Scope Stat(r_times, ri.pc.timeRecurseWorld);
-					R_RecursiveQ2WorldNode(ri.scn.worldModel->BSPData()->nodes, ri.scn.clipFlags);
+					R_CullQ2Leaves(r_noCull->intVal ? R_Q2VisLeafs(-1, -1) : r_q2CurrentVis, ri.scn.clipFlags);
+					R_RecursiveQ2WorldNode(ri.scn.worldModel->BSPData()->nodes);
 				}
 			}
 		}
@@ -968,5 +1186,6 @@ R_WorldShutdown
 */
 void R_WorldShutdown()
 {
+	R_ClearQ2VisCache();
 	R_SkyShutdown();
 }
@@ -872,7 +872,6 @@ static void SV_ServerRecord_f ()
 	char		name[MAX_OSPATH];
 	byte		buf_data[32768];
 	netMsg_t	buf;
-	int			len;
 	int			i;
 
 	if (Cmd_Argc () != 2) {
@@ -880,7 +879,7 @@ static void SV_ServerRecord_f ()
 		return;
 	}
 
-	if (svs.demoFile) {
+	if (svs.demoRecorder) {
 		Com_Printf (0, "Already recording.\n");
 		return;
 	}
@@ -894,15 +893,6 @@ static void SV_ServerRecord_f ()
 	Q_snprintfz (name, sizeof(name), "demos/%s.dm2", Cmd_Argv (1));
 
 	Com_Printf (0, "recording to %s.\n", name);
-	FS_CreatePath (name);
-	FS_OpenFile (name, &svs.demoFile, FS_MODE_WRITE_BINARY);
-	if (!svs.demoFile) {
-		Com_Printf (PRNT_ERROR, "ERROR: couldn't open.\n");
-		return;
-	}
-
-	// Setup a buffer to catch all multicasts
-	svs.demoMultiCast.Init(svs.demoMultiCastBuf, sizeof(svs.demoMultiCastBuf));
 
 	// Write a single giant fake message with all the startup info
 	buf.Init(buf_data, sizeof(buf_data));
@@ -932,18 +922,20 @@ static void SV_ServerRecord_f ()
 			buf.WriteString (sv.configStrings[i]);
 			if (buf.curSize + 67 >= buf.maxSize) {
 				Com_Printf (PRNT_ERROR, "Not enough buffer space available.\n");
-				FS_CloseFile (svs.demoFile);
-				svs.demoFile = 0;
 				return;
 			}
 		}
 	}
 
-	// Write it to the demo file
+	// Start the writer with it
 	Com_DevPrintf (0, "signon message length: %i\n", buf.curSize);
-	len = LittleLong (buf.curSize);
-	FS_Write (&len, sizeof(len), svs.demoFile);
-	FS_Write (buf.data, buf.curSize, svs.demoFile);
+	if (!SV_DemoBeginRecording (name, &buf)) {
+		Com_Printf (PRNT_ERROR, "ERROR: couldn't open.\n");
+		return;
+	}
+
+	// Setup a buffer to catch all multicasts
+	svs.demoMultiCast.Init(svs.demoMultiCastBuf, sizeof(svs.demoMultiCastBuf));
 
 	// The rest of the demo file will be individual frames
 }
@@ -958,12 +950,11 @@ Ends server demo recording
 */
 static void SV_ServerStop_f ()
 {
-	if (!svs.demoFile) {
+	if (!svs.demoRecorder) {
 		Com_Printf (0, "Not doing a serverrecord.\n");
 		return;
 	}
-	FS_CloseFile (svs.demoFile);
-	svs.demoFile = 0;
+	SV_DemoEndRecording ();
 	Com_Printf (0, "Recording completed.\n");
 }
 
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
 #include "sv_local.h"
+#include "../minizip/unzip.h"
 
 /*
 =============================================================================
@@ -45,13 +46,30 @@ struct entityBits_t
 	entityType_t	type;
 };
 
+static void SV_WriteRemoveEntity (netMsg_t *msg, const int number, const entityType_t type)
+{
+	int bits = U_REMOVE;
+	if (number >= 256)
+		bits |= U_NUMBER16 | U_MOREBITS1;
+
+	msg->WriteByte (bits&255);
+	if (bits & 0x0000ff00)
+		msg->WriteByte ((bits>>8)&255);
+
+	if (bits & U_NUMBER16)
+		msg->WriteShort (number);
+	else
+		msg->WriteByte (number);
+
+	msg->WriteByte (type);
+}
+
 static void SV_EmitPacketEntities (clientFrame_t *from, clientFrame_t *to, netMsg_t *msg)
 {
 	entityState_t	*oldEnt, *newEnt;
 	int		oldIndex, newIndex;
 	entityBits_t		oldNum, newNum;
 	int		from_numEntities;
-	int		bits;
 
 	msg->WriteByte (SVC_PACKETENTITIES);
 
@@ -111,20 +129,7 @@ static void SV_EmitPacketEntities (clientFrame_t *from, clientFrame_t *to, netMs
 
 		if (newNum.number > oldNum.number) {
 			// The old entity isn't present in the new message
-			bits = U_REMOVE;
-			if (oldNum.number >= 256)
-				bits |= U_NUMBER16 | U_MOREBITS1;
-
-			msg->WriteByte (bits&255);
-			if (bits & 0x0000ff00)
-				msg->WriteByte ((bits>>8)&255);
-
-			if (bits & U_NUMBER16)
-				msg->WriteShort (oldNum.number);
-			else
-				msg->WriteByte (oldNum.number);
-
-			msg->WriteByte(oldNum.type);
+			SV_WriteRemoveEntity (msg, oldNum.number, oldNum.type);
 
 			oldIndex++;
 			continue;
@@ -578,11 +583,254 @@ void SV_BuildClientFrame (svClient_t *client)
 }
 
 
+/*
+=============================================================================
+
+	SERVER DEMO RECORDING
+
+	Each frame is a delta against the last recorded one, with a full keyframe
+	every sv_demokeyframe seconds so playback can seek. The frame header
+	carries the frame it deltas from, or -1 on a keyframe. The server thread
+	only builds the message into a queue slot. A writer thread packs it into
+	an SVC_ZPACKET when that is smaller and writes it out. When recording
+	stops the writer also saves <demo>.dmi, the file offset of every keyframe.
+
+=============================================================================
+*/
+
+#define DEMO_MSGLEN			32768
+#define DEMO_QUEUE_SIZE		64			// must be a power of two
+#define DEMO_MIN_PACK		128			// smaller messages are written as they are
+
+#define DEMO_INDEX_IDENT	(('I'<<24)+('D'<<16)+('G'<<8)+'E')	// "EGDI"
+#define DEMO_INDEX_VERSION	1
+
+struct svDemoMessage_t {
+	int					frameNum;
+	bool				bKeyFrame;
+	bool				bPack;
+	int					size;			// -1 stops the writer
+	byte				data[DEMO_MSGLEN];
+};
+
+struct svDemoSeek_t {
+	int					frameNum;
+	int					fileOffset;
+};
+
+struct svDemoRecorder_t {
+	svDemoMessage_t		queue[DEMO_QUEUE_SIZE];
+	qSemaphore_t		*filledSem;
+	qSemaphore_t		*emptySem;
+	qThread_t			*thread;
+
+	// Only touched by the writer once it's running
+	FILE				*file;
+	char				indexName[MAX_OSPATH];
+	int					tail;
+	int					fileOffset;
+	uint32				rawBytes;
+	byte				packed[DEMO_MSGLEN+8];
+	TList<svDemoSeek_t>	seekIndex;
+
+	// Only touched by the server
+	int					head;
+	entityState_t		lastStates[MAX_CS_EDICTS];
+	bool				bLastPresent[MAX_CS_EDICTS];
+	int					lastFrameNum;
+	int					lastKeyFrameNum;
+	int					numFrames;
+};
+
+/*
+==================
+SV_DemoWriteMessage
+==================
+*/
+static void SV_DemoWriteMessage (svDemoRecorder_t *rec, svDemoMessage_t *msg)
+{
+	byte	*out = msg->data;
+	int		outSize = msg->size;
+
+	if (msg->bPack && msg->size >= DEMO_MIN_PACK && msg->size < 32767) {
+		const int compLen = FS_ZLibCompressChunk (msg->data, msg->size, rec->packed+5, sizeof(rec->packed)-5, Z_DEFAULT_COMPRESSION, -15);
+		if (compLen > 0 && compLen+5 < msg->size) {
+			rec->packed[0] = SVC_ZPACKET;
+			rec->packed[1] = compLen & 0xff;
+			rec->packed[2] = compLen >> 8;
+			rec->packed[3] = msg->size & 0xff;
+			rec->packed[4] = msg->size >> 8;
+
+			out = rec->packed;
+			outSize = compLen+5;
+		}
+	}
+
+	if (msg->bKeyFrame) {
+		svDemoSeek_t seek;
+		seek.frameNum = msg->frameNum;
+		seek.fileOffset = rec->fileOffset;
+		rec->seekIndex.Add (seek);
+	}
+
+	const int len = LittleLong (outSize);
+	fwrite (&len, sizeof(len), 1, rec->file);
+	fwrite (out, outSize, 1, rec->file);
+
+	rec->fileOffset += sizeof(len) + outSize;
+	rec->rawBytes += sizeof(len) + msg->size;
+}
+
+
+/*
+==================
+SV_DemoWriterThread
+==================
+*/
+static void SV_DemoWriterThread (void *arg)
+{
+	svDemoRecorder_t *rec = (svDemoRecorder_t*)arg;
+
+	for ( ; ; ) {
+		Semaphore_Wait (rec->filledSem);
+
+		svDemoMessage_t *msg = &rec->queue[rec->tail];
+		rec->tail = (rec->tail+1) & (DEMO_QUEUE_SIZE-1);
+		if (msg->size < 0)
+			break;
+
+		SV_DemoWriteMessage (rec, msg);
+		Semaphore_Post (rec->emptySem);
+	}
+
+	fclose (rec->file);
+	rec->file = NULL;
+
+	// Save the seek index next to the demo
+	FILE *f = fopen (rec->indexName, "wb");
+	if (f) {
+		const int header[3] = { LittleLong (DEMO_INDEX_IDENT), LittleLong (DEMO_INDEX_VERSION), LittleLong (rec->seekIndex.Count ()) };
+		fwrite (header, sizeof(header), 1, f);
+
+		for (uint32 i=0 ; i<rec->seekIndex.Count () ; i++) {
+			const int entry[2] = { LittleLong (rec->seekIndex[i].frameNum), LittleLong (rec->seekIndex[i].fileOffset) };
+			fwrite (entry, sizeof(entry), 1, f);
+		}
+		fclose (f);
+	}
+}
+
+
+/*
+==================
+SV_DemoGetSlot
+
+Blocks if the writer has fallen a whole queue behind.
+==================
+*/
+static svDemoMessage_t *SV_DemoGetSlot (svDemoRecorder_t *rec)
+{
+	Semaphore_Wait (rec->emptySem);
+	return &rec->queue[rec->head];
+}
+
+static void SV_DemoQueueSlot (svDemoRecorder_t *rec)
+{
+	rec->head = (rec->head+1) & (DEMO_QUEUE_SIZE-1);
+	Semaphore_Post (rec->filledSem);
+}
+
+
+/*
+==================
+SV_DemoBeginRecording
+
+Takes over the signon message, which is written first and left unpacked.
+==================
+*/
+bool SV_DemoBeginRecording (const char *name, netMsg_t *signon)
+{
+	char	fileName[MAX_OSPATH];
+
+	if (svs.demoRecorder || signon->curSize > DEMO_MSGLEN)
+		return false;
+
+	Q_snprintfz (fileName, sizeof(fileName), "%s/%s", FS_Gamedir(), name);
+	FS_CreatePath (fileName);
+	FILE *f = fopen (fileName, "wb");
+	if (!f)
+		return false;
+
+	svDemoRecorder_t *rec = new svDemoRecorder_t;
+	rec->file = f;
+	Com_StripExtension (rec->indexName, sizeof(rec->indexName), fileName);
+	Q_strcatz (rec->indexName, ".dmi", sizeof(rec->indexName));
+	rec->filledSem = Semaphore_Create (0);
+	rec->emptySem = Semaphore_Create (DEMO_QUEUE_SIZE);
+	rec->head = rec->tail = 0;
+	rec->fileOffset = 0;
+	rec->rawBytes = 0;
+	memset (rec->bLastPresent, 0, sizeof(rec->bLastPresent));
+	rec->lastFrameNum = -1;
+	rec->lastKeyFrameNum = -1;
+	rec->numFrames = 0;
+
+	rec->thread = Thread_Create (SV_DemoWriterThread, rec);
+	if (!rec->thread) {
+		fclose (f);
+		Semaphore_Destroy (rec->filledSem);
+		Semaphore_Destroy (rec->emptySem);
+		delete rec;
+		return false;
+	}
+
+	svDemoMessage_t *msg = SV_DemoGetSlot (rec);
+	msg->frameNum = -1;
+	msg->bKeyFrame = false;
+	msg->bPack = false;
+	msg->size = signon->curSize;
+	memcpy (msg->data, signon->data, signon->curSize);
+	SV_DemoQueueSlot (rec);
+
+	svs.demoRecorder = rec;
+	return true;
+}
+
+
+/*
+==================
+SV_DemoEndRecording
+
+Waits for the writer to drain the queue.
+==================
+*/
+void SV_DemoEndRecording ()
+{
+	svDemoRecorder_t *rec = svs.demoRecorder;
+	if (!rec)
+		return;
+
+	svDemoMessage_t *msg = SV_DemoGetSlot (rec);
+	msg->size = -1;
+	SV_DemoQueueSlot (rec);
+
+	Thread_Join (rec->thread);
+	Semaphore_Destroy (rec->filledSem);
+	Semaphore_Destroy (rec->emptySem);
+
+	Com_Printf (0, "%i frames, %i keyframes, %u bytes packed to %i.\n",
+		rec->numFrames, rec->seekIndex.Count (), rec->rawBytes, rec->fileOffset);
+
+	delete rec;
+	svs.demoRecorder = NULL;
+}
+
+
 /*
 ==================
 SV_RecordDemoMessage
 
-Save everything in the world out without deltas.
+Save everything in the world out, as a delta from the last recorded frame.
 Used for recording footage for merged or assembled demos
 ==================
 */
@@ -592,42 +840,69 @@ void SV_RecordDemoMessage ()
 	edict_t			*ent;
 	entityState_t	nostate;
 	netMsg_t		buf;
-	byte			buf_data[32768];
-	int				len;
 
-	if (!svs.demoFile)
+	svDemoRecorder_t *rec = svs.demoRecorder;
+	if (!rec)
 		return;
 
-	buf.Init(buf_data, sizeof(buf_data));
+	const int keyFrameInterval = Max<int> (1, sv_demoKeyFrame->floatVal * ServerFrameFPS);
+	const bool bKeyFrame = (rec->lastKeyFrameNum == -1 || sv.frameNum - rec->lastKeyFrameNum >= keyFrameInterval);
+
+	svDemoMessage_t *msg = SV_DemoGetSlot (rec);
+	buf.Init(msg->data, sizeof(msg->data));
 
 	// write a frame message that doesn't contain a playerState_t
 	buf.WriteByte (SVC_FRAME);
 	buf.WriteLong (sv.frameNum);
+	buf.WriteLong (bKeyFrame ? -1 : rec->lastFrameNum);
 
 	buf.WriteByte (SVC_PACKETENTITIES);
 
-	e = 1;
-	ent = EDICT_NUM(e);
-	while (e < ge->numEdicts) {
-		// ignore ents without visible models unless they have an effect
-		if (ent->inUse && ent->s.number
-		&& (ent->s.modelIndex || ent->s.effects || ent->s.sound || ent->s.events[0].ID || ent->s.events[1].ID)
-		&& !(ent->svFlags & SVF_NOCLIENT))
-			buf.WriteDeltaEntity (&nostate, &ent->s, false, true);
+	const int numEdicts = Min<int> (ge->numEdicts, MAX_CS_EDICTS);
+	for (e=1 ; e<MAX_CS_EDICTS ; e++) {
+		const bool bOldPresent = !bKeyFrame && rec->bLastPresent[e];
+		bool bPresent = false;
 
-		e++;
-		ent = EDICT_NUM(e);
+		if (e < numEdicts) {
+			ent = EDICT_NUM(e);
+
+			// ignore ents without visible models unless they have an effect
+			bPresent = (ent->inUse && ent->s.number
+				&& (ent->s.modelIndex || ent->s.effects || ent->s.sound || ent->s.events[0].ID || ent->s.events[1].ID)
+				&& !(ent->svFlags & SVF_NOCLIENT));
+		}
+
+		if (bPresent) {
+			if (bOldPresent)
+				buf.WriteDeltaEntity (&rec->lastStates[e], &ent->s, false, e <= maxclients->intVal);
+			else
+				buf.WriteDeltaEntity (&nostate, &ent->s, false, true);
+
+			rec->lastStates[e] = ent->s;
+		}
+		else if (bOldPresent) {
+			SV_WriteRemoveEntity (&buf, e, rec->lastStates[e].type);
+		}
+
+		rec->bLastPresent[e] = bPresent;
 	}
 
 	buf.WriteShort (0);		// end of packetentities
 
 	// now add the accumulated multicast information
-	buf.WriteRaw (svs.demoMultiCast.data, svs.demoMultiCast.curSize);
+	if (svs.demoMultiCast.curSize)
+		buf.WriteRaw (svs.demoMultiCast.data, svs.demoMultiCast.curSize);
 	svs.demoMultiCast.Clear();
 
-	// now write the entire message to the file, prefixed by the length
-	len = LittleLong (buf.curSize);
-
-	FS_Write (&len, sizeof(len), svs.demoFile);
-	FS_Write (buf.data, buf.curSize, svs.demoFile);
+	// hand it to the writer
+	msg->frameNum = sv.frameNum;
+	msg->bKeyFrame = bKeyFrame;
+	msg->bPack = true;
+	msg->size = buf.curSize;
+	SV_DemoQueueSlot (rec);
+
+	rec->lastFrameNum = sv.frameNum;
+	if (bKeyFrame)
+		rec->lastKeyFrameNum = sv.frameNum;
+	rec->numFrames++;
 }
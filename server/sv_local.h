@@ -148,9 +148,11 @@ struct svClient_t {
 
 	clientFrame_t	frames[UPDATE_BACKUP];			// updates can be delta'd from here
 
-	byte			*download;						// file being downloaded
+	struct svDownload_t	*download;					// file being downloaded, shared with other clients
 	int				downloadSize;					// total bytes (can't use EOF because of paks)
 	int				downloadCount;					// bytes sent
+	int				downloadBudget;					// bytes sv_download_rate still allows
+	int				downloadTime;					// when the budget was last refilled
 
 	int				lastMessage;					// sv.frameNum when packet was last received
 	int				lastConnect;
@@ -204,7 +206,7 @@ struct serverStatic_t {
 
 		lastHeartBeat = 0;
 		memset(&challenges, 0, MAX_CHALLENGES);
-		demoFile = 0;
+		demoRecorder = NULL;
 		demoMultiCast.Clear();
 		memset(&demoMultiCastBuf, 0, MAX_SV_MSGLEN);
 	}
@@ -226,7 +228,7 @@ struct serverStatic_t {
 	challenge_t			challenges[MAX_CHALLENGES];	// to prevent invalid IPs from connecting
 
 	// Serverrecord values
-	fileHandle_t		demoFile;
+	struct svDemoRecorder_t	*demoRecorder;
 	netMsg_t			demoMultiCast;
 	byte				demoMultiCastBuf[MAX_SV_MSGLEN];
 };
@@ -257,6 +259,9 @@ extern	cVar_t		*sv_noreload;			// don't reload level state when reentering
 extern	cVar_t		*sv_airaccelerate;		// don't reload level state when reentering
 											// development tool
 extern	cVar_t		*sv_enforcetime;
+extern	cVar_t		*sv_demoKeyFrame;		// seconds between serverrecord keyframes
+extern	cVar_t		*sv_downloadChunks;		// most download chunks per reliable message
+extern	cVar_t		*sv_downloadRate;		// download bytes per second per client, 0 is unlimited
 
 extern	svClient_t	*sv_currentClient;
 extern	edict_t		*sv_currentEdict;
@@ -327,6 +332,8 @@ void		SV_ReadLevelFile ();
 
 void		SV_WriteFrameToClient (svClient_t *client, netMsg_t *msg);
 void		SV_RecordDemoMessage ();
+bool		SV_DemoBeginRecording (const char *name, netMsg_t *signon);
+void		SV_DemoEndRecording ();
 void		SV_BuildClientFrame (svClient_t *client);
 
 //
@@ -384,3 +391,5 @@ void		SV_BroadcastCommand (char *fmt, ...);
 
 void		SV_Nextserver ();
 void		SV_ExecuteClientMessage (svClient_t *cl);
+void		SV_SendDownload (svClient_t *cl);
+void		SV_StopDownload (svClient_t *cl);
@@ -37,6 +37,9 @@ cVar_t	*sv_paused;
 cVar_t	*sv_timedemo;
 
 cVar_t	*sv_enforcetime;
+cVar_t	*sv_demoKeyFrame;
+cVar_t	*sv_downloadChunks;
+cVar_t	*sv_downloadRate;
 
 cVar_t	*timeout;				// seconds without any message
 cVar_t	*zombietime;			// seconds to sink messages after disconnect
@@ -95,10 +98,7 @@ void SV_DropClient (svClient_t *drop)
 		ge->ClientDisconnect (drop->edict);
 	}
 
-	if (drop->download) {
-		FS_FreeFile (drop->download);
-		drop->download = NULL;
-	}
+	SV_StopDownload (drop);
 
 	drop->state = SVCS_FREE;		// become free in a few seconds
 	drop->name[0] = 0;
@@ -1007,6 +1007,7 @@ void SV_ServerInit ()
 	sv_timedemo				= Cvar_Register ("timedemo",				"0",		CVAR_CHEAT);
 
 	sv_enforcetime			= Cvar_Register ("sv_enforcetime",			"0",		0);
+	sv_demoKeyFrame			= Cvar_Register ("sv_demokeyframe",			"10",		0);
 	sv_reconnect_limit		= Cvar_Register ("sv_reconnect_limit",		"3",		CVAR_ARCHIVE);
 	sv_noreload				= Cvar_Register ("sv_noreload",				"0",		0);
 	sv_airaccelerate		= Cvar_Register ("sv_airaccelerate",		"0",		CVAR_LATCH_SERVER);
@@ -1016,6 +1017,8 @@ void SV_ServerInit ()
 	allow_download_models	= Cvar_Register ("allow_download_models",	"1",		CVAR_ARCHIVE);
 	allow_download_sounds	= Cvar_Register ("allow_download_sounds",	"1",		CVAR_ARCHIVE);
 	allow_download_maps		= Cvar_Register ("allow_download_maps",		"1",		CVAR_ARCHIVE);
+	sv_downloadChunks		= Cvar_Register ("sv_download_chunks",		"2",		CVAR_ARCHIVE);
+	sv_downloadRate			= Cvar_Register ("sv_download_rate",		"0",		CVAR_ARCHIVE);
 
 	public_server			= Cvar_Register ("public",					"0",		0);
 
@@ -1072,9 +1075,14 @@ Called when each game quits, before Sys_Quit or Sys_Error
 */
 void SV_ServerShutdown (char *finalMessage, bool reconnect, bool crashing)
 {
-	if (svs.clients)
+	if (svs.clients) {
 		SV_FinalMessage (finalMessage, reconnect);
 
+		// Release download handles before maxclients can be relatched
+		for (int i=0 ; i<maxclients->intVal ; i++)
+			SV_StopDownload (&svs.clients[i]);
+	}
+
 	SV_MasterShutdown ();
 
 	if (!crashing) {
@@ -1097,8 +1105,7 @@ void SV_ServerShutdown (char *finalMessage, bool reconnect, bool crashing)
 		Mem_Free (svs.clients);
 	if (svs.clientEntities)
 		Mem_Free (svs.clientEntities);
-	if (svs.demoFile)
-		FS_CloseFile (svs.demoFile);
+	SV_DemoEndRecording ();
 	svs.Clear();
 
 	// If the server is crashing there's no sense in releasing this memory
@@ -187,7 +187,7 @@ void SV_Multicast (vec3_t origin, EMultiCast to)
 	}
 
 	// If doing a serverrecord, store everything
-	if (svs.demoFile) {
+	if (svs.demoRecorder) {
 		svs.demoMultiCast.WriteRaw (sv.multiCast.data, sv.multiCast.curSize);
 	}
 	
@@ -583,6 +583,8 @@ void SV_SendClientMessages ()
 			break;
 
 		default:
+			SV_SendDownload (c);
+
 			if (c->state == SVCS_SPAWNED) {
 				// Don't overrun bandwidth
 				if (SV_RateDrop (c))
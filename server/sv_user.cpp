@@ -258,40 +258,237 @@ static void SV_Begin_f ()
 
 // ==========================================================================
 
+/*
+==============================================================================
+
+	DOWNLOADS
+
+	Files are streamed from an open handle through a few cached blocks, so a
+	download costs the server a fixed amount of memory no matter how large
+	the file is. Clients fetching the same loose file read from the same
+	blocks. Pak entries can only be seeked by inflating them again from the
+	start, so every client gets its own handle onto those and reads it in
+	order. Rather than one chunk per "nextdl" round trip, every time a
+	client's reliable slot is free it is filled with as many chunks as fit,
+	up to sv_download_chunks and that client's download rate. The netchan
+	keeps only one reliable message in flight, so that is the window.
+
+==============================================================================
+*/
+
+#define DL_CHUNK_SIZE		1356
+#define DL_BLOCK_SIZE		16384
+#define DL_CACHE_BLOCKS		4
+
+struct svDownload_t {
+	char			name[MAX_QPATH];
+	int				refCount;
+	svDownload_t	*next;
+
+	fileHandle_t	fileNum;
+	int				fileSize;
+	bool			fromPak;						// private to one client, never seeked back
+	int				filePos;						// where the handle is
+
+	int				blockNum[DL_CACHE_BLOCKS];		// -1 when empty
+	uint32			blockUsed[DL_CACHE_BLOCKS];
+	uint32			useCount;
+	byte			blocks[DL_CACHE_BLOCKS][DL_BLOCK_SIZE];
+};
+
+static svDownload_t	*sv_downloads;
+
 /*
 ==================
-SV_NextDownload_f
+SV_OpenDownload
 ==================
 */
-static void SV_NextDownload_f ()
+static svDownload_t *SV_OpenDownload (char *name, bool &fromPak)
 {
-	int		r;
-	int		percent;
-	int		size;
+	extern bool	fs_fileFromPak; // ZOID did file come from pak?
+	svDownload_t	*dl;
+
+	// Share with anyone already fetching it, if it can be seeked cheaply
+	for (dl=sv_downloads ; dl ; dl=dl->next) {
+		if (!dl->fromPak && !Q_stricmp (dl->name, name)) {
+			fromPak = dl->fromPak;
+			dl->refCount++;
+			return dl;
+		}
+	}
+
+	fileHandle_t fileNum;
+	const int fileSize = FS_OpenFile (name, &fileNum, FS_MODE_READ_BINARY);
+	fromPak = fs_fileFromPak;
+	if (fileSize <= 0) {
+		// Don't send an empty file
+		if (fileNum)
+			FS_CloseFile (fileNum);
+		return NULL;
+	}
+
+	dl = (svDownload_t*)Mem_PoolAlloc (sizeof(svDownload_t), sv_genericPool, 0);
+	Q_strncpyz (dl->name, name, sizeof(dl->name));
+	dl->refCount = 1;
+	dl->fileNum = fileNum;
+	dl->fileSize = fileSize;
+	dl->fromPak = fromPak;
+	dl->filePos = 0;
+	dl->useCount = 0;
+	for (int i=0 ; i<DL_CACHE_BLOCKS ; i++) {
+		dl->blockNum[i] = -1;
+		dl->blockUsed[i] = 0;
+	}
+
+	dl->next = sv_downloads;
+	sv_downloads = dl;
+	return dl;
+}
 
-	if (!sv_currentClient->download)
+
+/*
+==================
+SV_CloseDownload
+==================
+*/
+static void SV_CloseDownload (svDownload_t *dl)
+{
+	if (--dl->refCount > 0)
 		return;
 
-	r = sv_currentClient->downloadSize - sv_currentClient->downloadCount;
-	if (r > 1356)
-		r = 1356;
+	for (svDownload_t **prev=&sv_downloads ; *prev ; prev=&(*prev)->next) {
+		if (*prev == dl) {
+			*prev = dl->next;
+			break;
+		}
+	}
+
+	FS_CloseFile (dl->fileNum);
+	Mem_Free (dl);
+}
+
 
-	sv_currentClient->netChan.message.WriteByte (SVC_DOWNLOAD);
-	sv_currentClient->netChan.message.WriteShort (r);
+/*
+==================
+SV_DownloadBlock
 
-	sv_currentClient->downloadCount += r;
-	size = sv_currentClient->downloadSize;
-	if (!size)
-		size = 1;
-	percent = sv_currentClient->downloadCount*100/size;
-	sv_currentClient->netChan.message.WriteByte (percent);
-	sv_currentClient->netChan.message.WriteRaw (sv_currentClient->download + sv_currentClient->downloadCount - r, r);
+Returns the cached block holding offset, reading it in over the least
+recently used one if needed.
+==================
+*/
+static byte *SV_DownloadBlock (svDownload_t *dl, const int offset)
+{
+	const int blockNum = offset / DL_BLOCK_SIZE;
+	int best = 0;
+
+	dl->useCount++;
+	for (int i=0 ; i<DL_CACHE_BLOCKS ; i++) {
+		if (dl->blockNum[i] == blockNum) {
+			dl->blockUsed[i] = dl->useCount;
+			return dl->blocks[i];
+		}
+		if (dl->blockUsed[i] < dl->blockUsed[best])
+			best = i;
+	}
+
+	const int start = blockNum * DL_BLOCK_SIZE;
+	if (dl->filePos != start)
+		FS_Seek (dl->fileNum, start, FS_SEEK_SET);
 
-	if (sv_currentClient->downloadCount != sv_currentClient->downloadSize)
+	const int len = Min<int> (DL_BLOCK_SIZE, dl->fileSize - start);
+	const int read = FS_Read (dl->blocks[best], len, dl->fileNum);
+	if (read != len)
+		memset (dl->blocks[best] + Max<int> (read, 0), 0, len - Max<int> (read, 0));
+	dl->filePos = start + Max<int> (read, 0);
+
+	dl->blockNum[best] = blockNum;
+	dl->blockUsed[best] = dl->useCount;
+	return dl->blocks[best];
+}
+
+
+/*
+==================
+SV_StopDownload
+==================
+*/
+void SV_StopDownload (svClient_t *cl)
+{
+	if (!cl->download)
+		return;
+
+	SV_CloseDownload (cl->download);
+	cl->download = NULL;
+}
+
+
+/*
+==================
+SV_SendDownload
+
+Called when the client asks for more and again right before each transmit.
+Chunks only go into the reliable message while nothing is in flight, so it
+is sent straight away and can't be overflowed by anything written later.
+==================
+*/
+void SV_SendDownload (svClient_t *cl)
+{
+	if (!cl->download || cl->netChan.reliableLength)
 		return;
 
-	FS_FreeFile (sv_currentClient->download);
-	sv_currentClient->download = NULL;
+	// Refill the rate budget, allowing at most a second of burst
+	const int time = Sys_Milliseconds ();
+	if (sv_downloadRate->intVal > 0) {
+		const int maxBudget = Max<int> (sv_downloadRate->intVal, DL_CHUNK_SIZE);
+		cl->downloadBudget = Min<int> (cl->downloadBudget + sv_downloadRate->intVal * (time - cl->downloadTime) / 1000, maxBudget);
+	}
+	cl->downloadTime = time;
+
+	// A spawned client also needs room for its frame
+	const int maxChunks = (cl->state == SVCS_SPAWNED) ? 1 : Max<int> (sv_downloadChunks->intVal, 1);
+	for (int i=0 ; i<maxChunks ; i++) {
+		int r = cl->downloadSize - cl->downloadCount;
+		if (r > DL_CHUNK_SIZE)
+			r = DL_CHUNK_SIZE;
+
+		if (cl->netChan.message.curSize + r + 4 > cl->netChan.message.maxSize)
+			break;
+		if (sv_downloadRate->intVal > 0 && cl->downloadBudget < r)
+			break;
+
+		cl->netChan.message.WriteByte (SVC_DOWNLOAD);
+		cl->netChan.message.WriteShort (r);
+
+		cl->downloadCount += r;
+		cl->netChan.message.WriteByte ((int)(cl->downloadCount * 100LL / cl->downloadSize));
+
+		// The chunk may straddle two blocks
+		for (int offset=cl->downloadCount-r ; offset<cl->downloadCount ; ) {
+			byte *block = SV_DownloadBlock (cl->download, offset);
+			const int blockOfs = offset % DL_BLOCK_SIZE;
+			const int len = Min<int> (DL_BLOCK_SIZE - blockOfs, cl->downloadCount - offset);
+			cl->netChan.message.WriteRaw (block + blockOfs, len);
+			offset += len;
+		}
+
+		if (sv_downloadRate->intVal > 0)
+			cl->downloadBudget -= r;
+		if (cl->downloadCount == cl->downloadSize) {
+			SV_StopDownload (cl);
+			break;
+		}
+	}
+}
+
+
+/*
+==================
+SV_NextDownload_f
+==================
+*/
+static void SV_NextDownload_f ()
+{
+	SV_SendDownload (sv_currentClient);
 }
 
 
@@ -307,7 +504,6 @@ static void SV_BeginDownload_f ()
 	extern cVar_t	*allow_download_models;
 	extern cVar_t	*allow_download_sounds;
 	extern cVar_t	*allow_download_maps;
-	extern bool	fs_fileFromPak; // ZOID did file come from pak?
 
 	char	*name;
 	int		offset = 0;
@@ -334,25 +530,17 @@ static void SV_BeginDownload_f ()
 		return;
 	}
 
-	if (sv_currentClient->download)
-		FS_FreeFile (sv_currentClient->download);
+	SV_StopDownload (sv_currentClient);
 
-	sv_currentClient->downloadSize = FS_LoadFile (name, (void **)&sv_currentClient->download, false);
-	if (sv_currentClient->downloadSize == 0)
-		sv_currentClient->downloadSize = -1;	// Don't send an empty file
-	sv_currentClient->downloadCount = offset;
+	bool fromPak = false;
+	sv_currentClient->download = SV_OpenDownload (name, fromPak);
 
-	if (offset > sv_currentClient->downloadSize)
-		sv_currentClient->downloadCount = sv_currentClient->downloadSize;
+	// Special check for maps, if it came from a pak file, don't allow download  ZOID
+	if (sv_currentClient->download && !strncmp (name, "maps/", 5) && fromPak)
+		SV_StopDownload (sv_currentClient);
 
-	if (!sv_currentClient->download
-		// Special check for maps, if it came from a pak file, don't allow download  ZOID
-		|| (!strncmp (name, "maps/", 5) && fs_fileFromPak)) {
+	if (!sv_currentClient->download) {
 		Com_DevPrintf (0, "Couldn't download %s to %s\n", name, sv_currentClient->name);
-		if (sv_currentClient->download) {
-			FS_FreeFile (sv_currentClient->download);
-			sv_currentClient->download = NULL;
-		}
 
 		sv_currentClient->netChan.message.WriteByte (SVC_DOWNLOAD);
 		sv_currentClient->netChan.message.WriteShort (-1);
@@ -360,7 +548,12 @@ static void SV_BeginDownload_f ()
 		return;
 	}
 
-	SV_NextDownload_f ();
+	sv_currentClient->downloadSize = sv_currentClient->download->fileSize;
+	sv_currentClient->downloadCount = clamp (offset, 0, sv_currentClient->downloadSize);
+	sv_currentClient->downloadBudget = 0;
+	sv_currentClient->downloadTime = Sys_Milliseconds ();
+
+	SV_SendDownload (sv_currentClient);
 	Com_DevPrintf (0, "Downloading %s to %s\n", name, sv_currentClient->name);
 }
 
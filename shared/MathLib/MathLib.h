@@ -55,6 +55,7 @@ inline byte ANGLE2BYTE(float x) { return ((int)(x*256/360) & 255); }
 inline float BYTE2ANGLE(byte x) { return (x*(360.0f/256)); }
 
 #include "Vector.h"
+#include "SIMD.h"
 
 // ===========================================================================
 
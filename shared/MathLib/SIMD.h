@@ -0,0 +1,128 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+// SIMD.h
+
+/*
+==============================================================================
+
+	Four-wide float operations
+
+	Maps onto SSE2 intrinsics where available and onto plain scalar code
+	otherwise, so kernels are written once and stay correct with C_ONLY.
+	Comparisons return a per-lane mask (all bits set when true).
+	Simd_LoadBytes widens four unsigned bytes to floats.
+==============================================================================
+*/
+
+#define SIMD_WIDTH			4
+#define SIMD_ALIGN(x)		(((x)+(SIMD_WIDTH-1)) & ~(SIMD_WIDTH-1))
+
+#ifdef HAVE_SSE2
+
+#include <emmintrin.h>
+
+typedef __m128 simdVec_t;
+
+inline simdVec_t Simd_Load(const float *p) { return _mm_loadu_ps(p); }
+inline simdVec_t Simd_LoadBytes(const byte *p)
+{
+	int bytes;
+	memcpy(&bytes, p, sizeof(bytes));
+	const __m128i zero = _mm_setzero_si128();
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero));
+}
+inline simdVec_t Simd_Splat(const float f) { return _mm_set1_ps(f); }
+inline simdVec_t Simd_Zero() { return _mm_setzero_ps(); }
+inline void Simd_Store(float *p, const simdVec_t v) { _mm_storeu_ps(p, v); }
+
+inline simdVec_t Simd_Add(const simdVec_t a, const simdVec_t b) { return _mm_add_ps(a, b); }
+inline simdVec_t Simd_Sub(const simdVec_t a, const simdVec_t b) { return _mm_sub_ps(a, b); }
+inline simdVec_t Simd_Mul(const simdVec_t a, const simdVec_t b) { return _mm_mul_ps(a, b); }
+inline simdVec_t Simd_Div(const simdVec_t a, const simdVec_t b) { return _mm_div_ps(a, b); }
+inline simdVec_t Simd_Sqrt(const simdVec_t a) { return _mm_sqrt_ps(a); }
+inline simdVec_t Simd_Madd(const simdVec_t a, const simdVec_t b, const simdVec_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline simdVec_t Simd_Min(const simdVec_t a, const simdVec_t b) { return _mm_min_ps(a, b); }
+inline simdVec_t Simd_Max(const simdVec_t a, const simdVec_t b) { return _mm_max_ps(a, b); }
+
+inline simdVec_t Simd_CmpLE(const simdVec_t a, const simdVec_t b) { return _mm_cmple_ps(a, b); }
+inline simdVec_t Simd_CmpLT(const simdVec_t a, const simdVec_t b) { return _mm_cmplt_ps(a, b); }
+inline simdVec_t Simd_CmpGT(const simdVec_t a, const simdVec_t b) { return _mm_cmpgt_ps(a, b); }
+inline simdVec_t Simd_And(const simdVec_t a, const simdVec_t b) { return _mm_and_ps(a, b); }
+inline simdVec_t Simd_Or(const simdVec_t a, const simdVec_t b) { return _mm_or_ps(a, b); }
+inline simdVec_t Simd_Select(const simdVec_t mask, const simdVec_t a, const simdVec_t b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline int Simd_MoveMask(const simdVec_t mask) { return _mm_movemask_ps(mask); }
+
+#else // HAVE_SSE2
+
+struct simdVec_t
+{
+	float	v[4];
+};
+
+inline simdVec_t Simd_Load(const float *p) { simdVec_t r; r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3]; return r; }
+inline simdVec_t Simd_LoadBytes(const byte *p) { simdVec_t r; r.v[0] = p[0]; r.v[1] = p[1]; r.v[2] = p[2]; r.v[3] = p[3]; return r; }
+inline simdVec_t Simd_Splat(const float f) { simdVec_t r; r.v[0] = r.v[1] = r.v[2] = r.v[3] = f; return r; }
+inline simdVec_t Simd_Zero() { return Simd_Splat(0.0f); }
+inline void Simd_Store(float *p, const simdVec_t a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+
+#define SIMD_SCALAR_OP(name, expr) \
+	inline simdVec_t name(const simdVec_t a, const simdVec_t b) { simdVec_t r; for (int i=0 ; i<4 ; i++) { const float x = a.v[i], y = b.v[i]; r.v[i] = (expr); } return r; }
+#define SIMD_SCALAR_CMP(name, expr) \
+	inline simdVec_t name(const simdVec_t a, const simdVec_t b) { simdVec_t r; for (int i=0 ; i<4 ; i++) { const float x = a.v[i], y = b.v[i]; *(uint32 *)&r.v[i] = (expr) ? 0xFFFFFFFF : 0; } return r; }
+#define SIMD_SCALAR_BIT(name, expr) \
+	inline simdVec_t name(const simdVec_t a, const simdVec_t b) { simdVec_t r; for (int i=0 ; i<4 ; i++) { const uint32 x = *(const uint32 *)&a.v[i], y = *(const uint32 *)&b.v[i]; *(uint32 *)&r.v[i] = (expr); } return r; }
+
+SIMD_SCALAR_OP(Simd_Add, x + y)
+SIMD_SCALAR_OP(Simd_Sub, x - y)
+SIMD_SCALAR_OP(Simd_Mul, x * y)
+SIMD_SCALAR_OP(Simd_Div, x / y)
+SIMD_SCALAR_OP(Simd_Min, (x < y) ? x : y)
+SIMD_SCALAR_OP(Simd_Max, (x > y) ? x : y)
+SIMD_SCALAR_CMP(Simd_CmpLE, x <= y)
+SIMD_SCALAR_CMP(Simd_CmpLT, x < y)
+SIMD_SCALAR_CMP(Simd_CmpGT, x > y)
+SIMD_SCALAR_BIT(Simd_And, x & y)
+SIMD_SCALAR_BIT(Simd_Or, x | y)
+
+#undef SIMD_SCALAR_OP
+#undef SIMD_SCALAR_CMP
+#undef SIMD_SCALAR_BIT
+
+inline simdVec_t Simd_Madd(const simdVec_t a, const simdVec_t b, const simdVec_t c) { return Simd_Add(Simd_Mul(a, b), c); }
+inline simdVec_t Simd_Sqrt(const simdVec_t a) { simdVec_t r; for (int i=0 ; i<4 ; i++) r.v[i] = sqrtf(a.v[i]); return r; }
+inline simdVec_t Simd_Select(const simdVec_t mask, const simdVec_t a, const simdVec_t b)
+{
+	simdVec_t r;
+	for (int i=0 ; i<4 ; i++)
+		r.v[i] = *(const uint32 *)&mask.v[i] ? a.v[i] : b.v[i];
+	return r;
+}
+inline int Simd_MoveMask(const simdVec_t mask)
+{
+	int r = 0;
+	for (int i=0 ; i<4 ; i++)
+	{
+		if (*(const uint32 *)&mask.v[i])
+			r |= BIT(i);
+	}
+	return r;
+}
+
+#endif // HAVE_SSE2
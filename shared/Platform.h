@@ -211,6 +211,10 @@ typedef uint64_t			uint64;
 # endif
 #endif
 
+#if (defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)) && !defined(C_ONLY)
+# define HAVE_SSE2 1
+#endif
+
 #ifndef BUILDSTRING
 # define BUILDSTRING	"Unknown"
 #endif
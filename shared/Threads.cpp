@@ -0,0 +1,438 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+//
+// Threads.cpp
+//
+
+#include "shared.h"
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <pthread.h>
+# include <unistd.h>
+#endif
+
+/*
+==============================================================================
+
+	THREADS
+
+==============================================================================
+*/
+
+struct qThread_t
+{
+#ifdef WIN32
+	HANDLE			handle;
+#else
+	pthread_t		handle;
+#endif
+	void			(*func)(void *arg);
+	void			*arg;
+};
+
+#ifdef WIN32
+static DWORD WINAPI Thread_Start(LPVOID param)
+#else
+static void *Thread_Start(void *param)
+#endif
+{
+	qThread_t *thread = (qThread_t*)param;
+	thread->func(thread->arg);
+	return 0;
+}
+
+/*
+===============
+Thread_Create
+===============
+*/
+qThread_t *Thread_Create(void (*func)(void *arg), void *arg)
+{
+	qThread_t *thread = new qThread_t;
+	thread->func = func;
+	thread->arg = arg;
+
+#ifdef WIN32
+	thread->handle = CreateThread(NULL, 0, Thread_Start, thread, 0, NULL);
+	if (!thread->handle)
+#else
+	if (pthread_create(&thread->handle, NULL, Thread_Start, thread) != 0)
+#endif
+	{
+		delete thread;
+		return NULL;
+	}
+
+	return thread;
+}
+
+
+/*
+===============
+Thread_Join
+===============
+*/
+void Thread_Join(qThread_t *thread)
+{
+	if (!thread)
+		return;
+
+#ifdef WIN32
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+	delete thread;
+}
+
+
+/*
+===============
+Thread_NumProcessors
+===============
+*/
+int Thread_NumProcessors()
+{
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return Max<int>(1, info.dwNumberOfProcessors);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	return Max<int>(1, sysconf(_SC_NPROCESSORS_ONLN));
+#else
+	return 1;
+#endif
+}
+
+/*
+==============================================================================
+
+	MUTEXES AND SEMAPHORES
+
+==============================================================================
+*/
+
+struct qMutex_t
+{
+#ifdef WIN32
+	CRITICAL_SECTION	cs;
+#else
+	pthread_mutex_t		mutex;
+#endif
+};
+
+qMutex_t *Mutex_Create()
+{
+	qMutex_t *mutex = new qMutex_t;
+#ifdef WIN32
+	InitializeCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_init(&mutex->mutex, NULL);
+#endif
+	return mutex;
+}
+
+void Mutex_Destroy(qMutex_t *mutex)
+{
+	if (!mutex)
+		return;
+#ifdef WIN32
+	DeleteCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_destroy(&mutex->mutex);
+#endif
+	delete mutex;
+}
+
+void Mutex_Lock(qMutex_t *mutex)
+{
+#ifdef WIN32
+	EnterCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_lock(&mutex->mutex);
+#endif
+}
+
+void Mutex_Unlock(qMutex_t *mutex)
+{
+#ifdef WIN32
+	LeaveCriticalSection(&mutex->cs);
+#else
+	pthread_mutex_unlock(&mutex->mutex);
+#endif
+}
+
+struct qSemaphore_t
+{
+#ifdef WIN32
+	HANDLE				handle;
+#else
+	pthread_mutex_t		mutex;
+	pthread_cond_t		cond;
+	int					count;
+#endif
+};
+
+qSemaphore_t *Semaphore_Create(const int initialCount)
+{
+	qSemaphore_t *sem = new qSemaphore_t;
+#ifdef WIN32
+	sem->handle = CreateSemaphore(NULL, initialCount, 0x7FFFFFFF, NULL);
+#else
+	pthread_mutex_init(&sem->mutex, NULL);
+	pthread_cond_init(&sem->cond, NULL);
+	sem->count = initialCount;
+#endif
+	return sem;
+}
+
+void Semaphore_Destroy(qSemaphore_t *sem)
+{
+	if (!sem)
+		return;
+#ifdef WIN32
+	CloseHandle(sem->handle);
+#else
+	pthread_cond_destroy(&sem->cond);
+	pthread_mutex_destroy(&sem->mutex);
+#endif
+	delete sem;
+}
+
+void Semaphore_Post(qSemaphore_t *sem, const int count)
+{
+#ifdef WIN32
+	ReleaseSemaphore(sem->handle, count, NULL);
+#else
+	pthread_mutex_lock(&sem->mutex);
+	sem->count += count;
+	if (count > 1)
+		pthread_cond_broadcast(&sem->cond);
+	else
+		pthread_cond_signal(&sem->cond);
+	pthread_mutex_unlock(&sem->mutex);
+#endif
+}
+
+void Semaphore_Wait(qSemaphore_t *sem)
+{
+#ifdef WIN32
+	WaitForSingleObject(sem->handle, INFINITE);
+#else
+	pthread_mutex_lock(&sem->mutex);
+	while (sem->count <= 0)
+		pthread_cond_wait(&sem->cond, &sem->mutex);
+	sem->count--;
+	pthread_mutex_unlock(&sem->mutex);
+#endif
+}
+
+/*
+==============================================================================
+
+	ATOMICS
+
+==============================================================================
+*/
+
+long Atomic_Increment(volatile long *value)
+{
+#ifdef WIN32
+	return InterlockedIncrement(value);
+#else
+	return __sync_add_and_fetch(value, 1);
+#endif
+}
+
+long Atomic_Decrement(volatile long *value)
+{
+#ifdef WIN32
+	return InterlockedDecrement(value);
+#else
+	return __sync_sub_and_fetch(value, 1);
+#endif
+}
+
+long Atomic_Add(volatile long *value, const long amount)
+{
+#ifdef WIN32
+	return InterlockedExchangeAdd(value, amount) + amount;
+#else
+	return __sync_add_and_fetch(value, amount);
+#endif
+}
+
+/*
+==============================================================================
+
+	JOB POOL
+
+==============================================================================
+*/
+
+JobPool::JobPool() :
+numWorkers(0),
+wakeSem(NULL),
+doneSem(NULL),
+nextTask(0),
+busyWorkers(0),
+bQuit(false),
+func(NULL),
+arg(NULL),
+numTasks(0)
+{
+	memset(workers, 0, sizeof(workers));
+}
+
+JobPool::~JobPool()
+{
+	Shutdown();
+}
+
+
+/*
+===============
+JobPool::Init
+===============
+*/
+void JobPool::Init(const int count)
+{
+	Shutdown();
+
+	const int wanted = clamp(count, 0, MAX_JOB_THREADS-1);
+	if (!wanted)
+		return;
+
+	wakeSem = Semaphore_Create(0);
+	doneSem = Semaphore_Create(0);
+	bQuit = false;
+
+	// Workers are numbered from 1, the thread calling Run() is 0
+	for (int i=0 ; i<wanted ; i++)
+	{
+		worker_t *worker = &workers[numWorkers];
+		worker->pool = this;
+		worker->threadNum = numWorkers+1;
+		worker->thread = Thread_Create(WorkerMain, worker);
+		if (!worker->thread)
+			break;
+
+		numWorkers++;
+	}
+}
+
+
+/*
+===============
+JobPool::Shutdown
+===============
+*/
+void JobPool::Shutdown()
+{
+	if (numWorkers)
+	{
+		bQuit = true;
+		Semaphore_Post(wakeSem, numWorkers);
+
+		for (int i=0 ; i<numWorkers ; i++)
+			Thread_Join(workers[i].thread);
+	}
+
+	Semaphore_Destroy(wakeSem);
+	Semaphore_Destroy(doneSem);
+	wakeSem = doneSem = NULL;
+
+	memset(workers, 0, sizeof(workers));
+	numWorkers = 0;
+}
+
+
+/*
+===============
+JobPool::RunTasks
+===============
+*/
+void JobPool::RunTasks(const int threadNum)
+{
+	for ( ; ; )
+	{
+		const long taskNum = Atomic_Increment(&nextTask) - 1;
+		if (taskNum >= numTasks)
+			break;
+
+		func(arg, taskNum, threadNum);
+	}
+}
+
+
+/*
+===============
+JobPool::WorkerMain
+===============
+*/
+void JobPool::WorkerMain(void *arg)
+{
+	worker_t *worker = (worker_t*)arg;
+	JobPool *pool = worker->pool;
+
+	for ( ; ; )
+	{
+		Semaphore_Wait(pool->wakeSem);
+		if (pool->bQuit)
+			break;
+
+		pool->RunTasks(worker->threadNum);
+
+		if (!Atomic_Decrement(&pool->busyWorkers))
+			Semaphore_Post(pool->doneSem);
+	}
+}
+
+
+/*
+===============
+JobPool::Run
+===============
+*/
+void JobPool::Run(jobFunc_t func, void *arg, const int numTasks)
+{
+	if (numTasks <= 0)
+		return;
+
+	if (!numWorkers || numTasks == 1)
+	{
+		for (int i=0 ; i<numTasks ; i++)
+			func(arg, i, 0);
+		return;
+	}
+
+	this->func = func;
+	this->arg = arg;
+	this->numTasks = numTasks;
+	nextTask = 0;
+	busyWorkers = numWorkers;
+
+	Semaphore_Post(wakeSem, numWorkers);
+	RunTasks(0);
+	Semaphore_Wait(doneSem);
+}
@@ -0,0 +1,109 @@
+/*
+Copyright (C) 1997-2001 Id Software, Inc.
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+
+See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+*/
+
+// Threads.h
+
+/*
+==============================================================================
+
+	Threading primitives
+
+	Thin wrappers over Win32 and pthreads. These live in the shared library so
+	that the engine, cgame and game modules can each run their own workers
+	without going through an import table.
+==============================================================================
+*/
+
+struct qThread_t;
+struct qMutex_t;
+struct qSemaphore_t;
+
+qThread_t		*Thread_Create(void (*func)(void *arg), void *arg);
+void			Thread_Join(qThread_t *thread);
+int				Thread_NumProcessors();
+
+qMutex_t		*Mutex_Create();
+void			Mutex_Destroy(qMutex_t *mutex);
+void			Mutex_Lock(qMutex_t *mutex);
+void			Mutex_Unlock(qMutex_t *mutex);
+
+qSemaphore_t	*Semaphore_Create(const int initialCount);
+void			Semaphore_Destroy(qSemaphore_t *sem);
+void			Semaphore_Post(qSemaphore_t *sem, const int count = 1);
+void			Semaphore_Wait(qSemaphore_t *sem);
+
+long			Atomic_Increment(volatile long *value);
+long			Atomic_Decrement(volatile long *value);
+long			Atomic_Add(volatile long *value, const long amount);
+
+/*
+==============================================================================
+
+	JobPool
+
+	A fixed set of worker threads that run one batch of tasks at a time. The
+	calling thread works on the batch too, and Run() only returns once every
+	task is finished, so callers can hand out per-thread output buffers and
+	merge them afterwards without further locking. With zero workers every
+	task runs on the calling thread in order.
+==============================================================================
+*/
+
+#define MAX_JOB_THREADS		8
+
+class JobPool
+{
+public:
+	typedef void (*jobFunc_t)(void *arg, const int taskNum, const int threadNum);
+
+	JobPool();
+	~JobPool();
+
+	void			Init(const int count);
+	void			Shutdown();
+
+	// Including the calling thread
+	inline int		NumThreads() const { return numWorkers+1; }
+
+	void			Run(jobFunc_t func, void *arg, const int numTasks);
+
+private:
+	static void		WorkerMain(void *arg);
+	void			RunTasks(const int threadNum);
+
+	struct worker_t
+	{
+		JobPool		*pool;
+		int			threadNum;
+		qThread_t	*thread;
+	};
+
+	int				numWorkers;
+	worker_t		workers[MAX_JOB_THREADS];
+
+	qSemaphore_t	*wakeSem;
+	qSemaphore_t	*doneSem;
+	volatile long	nextTask;
+	volatile long	busyWorkers;
+	volatile bool	bQuit;
+
+	jobFunc_t		func;
+	void			*arg;
+	int				numTasks;
+};
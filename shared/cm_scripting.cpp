@@ -129,6 +129,11 @@ void Script::Call (int arguments, int results)
 		Com_Printf (PRNT_ERROR, "Lua error: %s\n", lua_tostring(state, -1));
 }
 
+int Script::GC (int what, int data)
+{
+	return lua_gc(state, what, data);
+}
+
 bool Script::IsNumber (int index)
 {
 	return lua_isnumber(state, index) == 1;
@@ -106,6 +106,7 @@ public:
 	void SetField (int index, const char *str);
 	void Remove (int index);
 	void Call (int arguments, int results);
+	int GC (int what, int data);
 
 	bool		IsNumber (int index);
 	bool		IsString (int index);
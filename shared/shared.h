@@ -45,6 +45,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 #include "Exceptions.h"
 #include "MathLib/MathLib.h"
 #include "ColorVec.h"
+#include "Threads.h"
 
 #define EGL_HOMEPAGE "http://egl.quakedev.com/"
 
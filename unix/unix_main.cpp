@@ -388,6 +388,48 @@ void Sys_Mkdir (char *path)
 }
 
 
+/*
+================
+Sys_MapFile
+================
+*/
+void *Sys_MapFile (const char *path, size_t *size)
+{
+	*size = 0;
+
+	int fd = open (path, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+
+	struct stat st;
+	if (fstat (fd, &st) == -1 || st.st_size <= 0)
+	{
+		close (fd);
+		return NULL;
+	}
+
+	void *base = mmap (NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close (fd);
+	if (base == MAP_FAILED)
+		return NULL;
+
+	*size = st.st_size;
+	return base;
+}
+
+
+/*
+================
+Sys_UnmapFile
+================
+*/
+void Sys_UnmapFile (void *base, const size_t size)
+{
+	if (base)
+		munmap (base, size);
+}
+
+
 /*
 ================
 Sys_SendKeyEvents
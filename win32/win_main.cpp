@@ -293,6 +293,54 @@ void Sys_Mkdir (char *path)
 }
 
 
+/*
+================
+Sys_MapFile
+================
+*/
+void *Sys_MapFile (const char *path, size_t *size)
+{
+	*size = 0;
+
+	HANDLE file = CreateFile (path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	const DWORD fileSize = GetFileSize (file, NULL);
+	if (fileSize == INVALID_FILE_SIZE || !fileSize)
+	{
+		CloseHandle (file);
+		return NULL;
+	}
+
+	HANDLE mapping = CreateFileMapping (file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle (file);
+	if (!mapping)
+		return NULL;
+
+	// The view keeps the mapping alive
+	void *base = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle (mapping);
+	if (!base)
+		return NULL;
+
+	*size = fileSize;
+	return base;
+}
+
+
+/*
+================
+Sys_UnmapFile
+================
+*/
+void Sys_UnmapFile (void *base, const size_t size)
+{
+	if (base)
+		UnmapViewOfFile (base);
+}
+
+
 /*
 ================
 Sys_SendKeyEvents